@@ -0,0 +1,56 @@
+#!/bin/bash
+
+set -eu
+shopt -s nullglob
+
+cd -P -- "$(dirname -- "$0")"
+
+if [ -z ${WORD_SIZE+x} ]; then
+	echo "Error: WORD_SIZE is not set"
+	exit 1
+fi
+
+ENGINES=${ENGINES:-"call threaded"}
+MEMORY=${MEMORY:-segmented}
+TIMEFORMAT="%R"
+
+run_case(){
+	local filename="$1"
+	local engine="$2"
+	local label="${3:-$1}"
+
+	local instructions
+	instructions=$(sed -n 's/.*; bench-instructions: \([0-9]*\).*/\1/p' "$filename")
+
+	local bytes
+	bytes=$(sed -n 's/.*; .*bench-bytes: \([0-9]*\).*/\1/p' "$filename")
+
+	local elapsed
+	if ! elapsed=$( { time install/bin/srsvm_run -ws "$WORD_SIZE" -e "$engine" -m "$MEMORY" "$filename" >/dev/null 2>&1; } 2>&1 ); then
+		printf "%-40s %-10s failed\n" "$label" "$engine"
+		return
+	fi
+
+	if [ -n "$instructions" ] && [ -n "$bytes" ]; then
+		printf "%-40s %-10s %8ss %14.0f instr/s %10.1f MB/s\n" "$label" "$engine" "$elapsed" "$(awk "BEGIN { print $instructions / $elapsed }")" "$(awk "BEGIN { print $bytes / $elapsed / 1000000 }")"
+	elif [ -n "$instructions" ]; then
+		printf "%-40s %-10s %8ss %14.0f instr/s\n" "$label" "$engine" "$elapsed" "$(awk "BEGIN { print $instructions / $elapsed }")"
+	else
+		printf "%-40s %-10s %8ss\n" "$label" "$engine" "$elapsed"
+	fi
+}
+
+echo "WORD_SIZE=$WORD_SIZE MEMORY=$MEMORY"
+
+for dir in all "$WORD_SIZE"; do
+	for input_file in cases/$dir/*.s; do
+		for engine in $ENGINES; do
+			run_case "$input_file" "$engine"
+
+			# vector math cases are repeated on the scalar loops for comparison
+			if [[ "$(basename "$input_file")" == vec_* ]]; then
+				SRSVM_MATH_SIMD=0 run_case "$input_file" "$engine" "$input_file (scalar)"
+			fi
+		done
+	done
+done
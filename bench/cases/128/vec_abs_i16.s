@@ -0,0 +1,34 @@
+LOAD_CONST $SHIFT 0x100000000%u64 ; bench-instructions: 6000047
+math.MUL_U128 $SHIFT $SHIFT $SHIFT
+
+LOAD_CONST $A 0x8001fffe00037ffe%u64
+math.MUL_U128 $A $A $SHIFT
+LOAD_CONST $LO 0x8001fffe00037ffe%u64
+math.ADD_U128 $A $A $LO
+
+LOAD_CONST $OUTER 0
+
+OUTER:
+LOAD_CONST $ACC 0
+
+INNER:
+math.VEC_ABS_I16 $C $A
+math.VEC_ABS_I16 $D $A
+math.VEC_ABS_I16 $E $A
+math.VEC_ABS_I16 $F $A
+math.VEC_ABS_I16 $G $A
+math.VEC_ABS_I16 $H $A
+math.VEC_ABS_I16 $I $A
+math.VEC_ABS_I16 $J $A
+INCR $ACC
+WORD_EQ $DONE $ACC 50000
+JMP_IF #INNER_END $DONE
+JMP #INNER
+
+INNER_END:
+INCR $OUTER
+WORD_EQ $DONE $OUTER 10
+JMP_IF #END $DONE
+JMP #OUTER
+
+END: HALT
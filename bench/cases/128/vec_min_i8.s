@@ -0,0 +1,39 @@
+LOAD_CONST $SHIFT 0x100000000%u64 ; bench-instructions: 6000051
+math.MUL_U128 $SHIFT $SHIFT $SHIFT
+
+LOAD_CONST $A 0x0180037f05fe0708%u64
+math.MUL_U128 $A $A $SHIFT
+LOAD_CONST $LO 0x0180037f05fe0708%u64
+math.ADD_U128 $A $A $LO
+
+LOAD_CONST $B 0x7f01fe0380060708%u64
+math.MUL_U128 $B $B $SHIFT
+LOAD_CONST $LO 0x7f01fe0380060708%u64
+math.ADD_U128 $B $B $LO
+
+LOAD_CONST $OUTER 0
+
+OUTER:
+LOAD_CONST $ACC 0
+
+INNER:
+math.VEC_MIN_I8 $C $A $B
+math.VEC_MIN_I8 $D $A $B
+math.VEC_MIN_I8 $E $A $B
+math.VEC_MIN_I8 $F $A $B
+math.VEC_MIN_I8 $G $A $B
+math.VEC_MIN_I8 $H $A $B
+math.VEC_MIN_I8 $I $A $B
+math.VEC_MIN_I8 $J $A $B
+INCR $ACC
+WORD_EQ $DONE $ACC 50000
+JMP_IF #INNER_END $DONE
+JMP #INNER
+
+INNER_END:
+INCR $OUTER
+WORD_EQ $DONE $OUTER 10
+JMP_IF #END $DONE
+JMP #OUTER
+
+END: HALT
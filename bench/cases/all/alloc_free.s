@@ -0,0 +1,20 @@
+LOAD_CONST $OUTER 0       ; bench-instructions: 6000081
+
+OUTER:
+LOAD_CONST $ACC 0
+
+INNER:
+ALLOC $MEM 4096           ; above SRSVM_HEAP_MAX_BLOCK, so each pair inserts and removes a segment
+FREE $MEM
+INCR $ACC
+WORD_EQ $DONE $ACC 50000
+JMP_IF #INNER_END $DONE
+JMP #INNER
+
+INNER_END:
+INCR $OUTER
+WORD_EQ $DONE $OUTER 20
+JMP_IF #END $DONE
+JMP #OUTER
+
+END: HALT
@@ -0,0 +1,24 @@
+LOAD_CONST $OUTER 0       ; bench-instructions: 9000081
+
+OUTER:
+LOAD_CONST $ACC 0
+
+INNER:
+CALL #SUB                 ; one call, push, pop and return per iteration
+INCR $ACC
+WORD_EQ $DONE $ACC 50000
+JMP_IF #INNER_END $DONE
+JMP #INNER
+
+INNER_END:
+INCR $OUTER
+WORD_EQ $DONE $OUTER 20
+JMP_IF #END $DONE
+JMP #OUTER
+
+END: HALT
+
+SUB: PUSH $A
+INCR $A
+POP
+RET
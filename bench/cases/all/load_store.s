@@ -0,0 +1,21 @@
+ALLOC $BUF 64             ; bench-instructions: 3000042
+LOAD_CONST $OUTER 0
+
+OUTER:
+LOAD_CONST $ACC 0
+
+INNER:
+STORE $BUF $ACC 0         ; one store and one load per iteration
+LOAD $X $BUF 0
+INCR $ACC
+WORD_EQ $DONE $ACC 50000
+JMP_IF #INNER_END $DONE
+JMP #INNER
+
+INNER_END:
+INCR $OUTER
+WORD_EQ $DONE $OUTER 10
+JMP_IF #END $DONE
+JMP #OUTER
+
+END: HALT
@@ -0,0 +1,33 @@
+THREAD_START $T1 #WORKER  ; bench-instructions: 12000177
+THREAD_START $T2 #WORKER  ; the same loop as load_store.s on four threads at once
+THREAD_START $T3 #WORKER
+THREAD_START $T4 #WORKER
+
+THREAD_JOIN $T1
+THREAD_JOIN $T2
+THREAD_JOIN $T3
+THREAD_JOIN $T4
+
+HALT
+
+WORKER: ALLOC $BUF 64
+LOAD_CONST $OUTER 0
+
+OUTER:
+LOAD_CONST $ACC 0
+
+INNER:
+STORE $BUF $ACC 0
+LOAD $X $BUF 0
+INCR $ACC
+WORD_EQ $DONE $ACC 50000
+JMP_IF #INNER_END $DONE
+JMP #INNER
+
+INNER_END:
+INCR $OUTER
+WORD_EQ $DONE $OUTER 10
+JMP_IF #END $DONE
+JMP #OUTER
+
+END: HALT
@@ -0,0 +1,21 @@
+ALLOC $SRC 1024           ; bench-instructions: 2500043 bench-bytes: 512000000
+ALLOC $DST 1024
+LOAD_CONST $OUTER 0
+
+OUTER:
+LOAD_CONST $ACC 0
+
+INNER:
+MEMCPY $DST $SRC 1024     ; compare with memcpy_loop.s
+INCR $ACC
+WORD_EQ $DONE $ACC 50000
+JMP_IF #INNER_END $DONE
+JMP #INNER
+
+INNER_END:
+INCR $OUTER
+WORD_EQ $DONE $OUTER 10
+JMP_IF #END $DONE
+JMP #OUTER
+
+END: HALT
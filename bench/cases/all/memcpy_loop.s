@@ -0,0 +1,30 @@
+ALLOC $SRC 1024           ; bench-instructions: 4099007 bench-bytes: 512000
+ALLOC $DST 1024
+ALLOC $SRC_START 16       ; there is no register move, so the start pointers are reloaded from memory
+ALLOC $DST_START 16
+STORE $SRC_START $SRC 0
+STORE $DST_START $DST 0
+LOAD_CONST $OUTER 0
+
+OUTER:
+LOAD $S $SRC_START 0
+LOAD $D $DST_START 0
+LOAD_CONST $ACC 0
+
+INNER:
+LOAD $X $S 5              ; one U8 at a time, as MEMCPY replaces
+STORE $D $X 5
+INCR $S
+INCR $D
+INCR $ACC
+WORD_EQ $DONE $ACC 1024
+JMP_IF #INNER_END $DONE
+JMP #INNER
+
+INNER_END:
+INCR $OUTER
+WORD_EQ $DONE $OUTER 500
+JMP_IF #END $DONE
+JMP #OUTER
+
+END: HALT
@@ -0,0 +1,25 @@
+LOAD_CONST $OUTER 0       ; bench-instructions: 9000083
+REGION_CREATE $R 4096
+
+OUTER:
+LOAD_CONST $ACC 0
+
+INNER:
+REGION_ALLOC $A $R 64     ; four request-scoped allocations released by one reset
+REGION_ALLOC $B $R 64
+REGION_ALLOC $C $R 64
+REGION_ALLOC $D $R 64
+REGION_RESET $R
+INCR $ACC
+WORD_EQ $DONE $ACC 50000
+JMP_IF #INNER_END $DONE
+JMP #INNER
+
+INNER_END:
+INCR $OUTER
+WORD_EQ $DONE $OUTER 20
+JMP_IF #END $DONE
+JMP #OUTER
+
+END: REGION_DESTROY $R
+HALT
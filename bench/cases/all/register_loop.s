@@ -0,0 +1,26 @@
+LOAD_CONST $OUTER 0       ; bench-instructions: 6000041
+
+OUTER:
+LOAD_CONST $ACC 0
+
+INNER:
+INCR $A                   ; a small set of hot registers updated every iteration
+INCR $B
+INCR $C
+INCR $D
+INCR $E
+INCR $F
+INCR $G
+INCR $H
+INCR $ACC
+WORD_EQ $DONE $ACC 50000
+JMP_IF #INNER_END $DONE
+JMP #INNER
+
+INNER_END:
+INCR $OUTER
+WORD_EQ $DONE $OUTER 10
+JMP_IF #END $DONE
+JMP #OUTER
+
+END: HALT
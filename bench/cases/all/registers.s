@@ -0,0 +1,138 @@
+INCR $R0                  ; bench-instructions: 4000201
+INCR $R1                  ; 120 live registers for the per-instruction fault check to walk
+INCR $R2
+INCR $R3
+INCR $R4
+INCR $R5
+INCR $R6
+INCR $R7
+INCR $R8
+INCR $R9
+INCR $R10
+INCR $R11
+INCR $R12
+INCR $R13
+INCR $R14
+INCR $R15
+INCR $R16
+INCR $R17
+INCR $R18
+INCR $R19
+INCR $R20
+INCR $R21
+INCR $R22
+INCR $R23
+INCR $R24
+INCR $R25
+INCR $R26
+INCR $R27
+INCR $R28
+INCR $R29
+INCR $R30
+INCR $R31
+INCR $R32
+INCR $R33
+INCR $R34
+INCR $R35
+INCR $R36
+INCR $R37
+INCR $R38
+INCR $R39
+INCR $R40
+INCR $R41
+INCR $R42
+INCR $R43
+INCR $R44
+INCR $R45
+INCR $R46
+INCR $R47
+INCR $R48
+INCR $R49
+INCR $R50
+INCR $R51
+INCR $R52
+INCR $R53
+INCR $R54
+INCR $R55
+INCR $R56
+INCR $R57
+INCR $R58
+INCR $R59
+INCR $R60
+INCR $R61
+INCR $R62
+INCR $R63
+INCR $R64
+INCR $R65
+INCR $R66
+INCR $R67
+INCR $R68
+INCR $R69
+INCR $R70
+INCR $R71
+INCR $R72
+INCR $R73
+INCR $R74
+INCR $R75
+INCR $R76
+INCR $R77
+INCR $R78
+INCR $R79
+INCR $R80
+INCR $R81
+INCR $R82
+INCR $R83
+INCR $R84
+INCR $R85
+INCR $R86
+INCR $R87
+INCR $R88
+INCR $R89
+INCR $R90
+INCR $R91
+INCR $R92
+INCR $R93
+INCR $R94
+INCR $R95
+INCR $R96
+INCR $R97
+INCR $R98
+INCR $R99
+INCR $R100
+INCR $R101
+INCR $R102
+INCR $R103
+INCR $R104
+INCR $R105
+INCR $R106
+INCR $R107
+INCR $R108
+INCR $R109
+INCR $R110
+INCR $R111
+INCR $R112
+INCR $R113
+INCR $R114
+INCR $R115
+INCR $R116
+INCR $R117
+INCR $R118
+INCR $R119
+LOAD_CONST $OUTER 0
+
+OUTER:
+LOAD_CONST $ACC 0
+
+INNER:
+INCR $ACC
+WORD_EQ $DONE $ACC 50000
+JMP_IF #INNER_END $DONE
+JMP #INNER
+
+INNER_END:
+INCR $OUTER
+WORD_EQ $DONE $OUTER 20
+JMP_IF #END $DONE
+JMP #OUTER
+
+END: HALT
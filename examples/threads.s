@@ -1,4 +1,4 @@
-MUTEX_INIT $IO_MUT
+MUTEX_INIT $$IO_MUT
 
 THREAD_START $T1 #THREAD_TARGET
 THREAD_START $T2 #THREAD_TARGET
@@ -15,13 +15,13 @@ THREAD_JOIN $T5
 HALT
 
 THREAD_TARGET:
-MUTEX_LOCK $IO_MUT
+MUTEX_LOCK $$IO_MUT
 THREAD_ID $ID
 
 PUTS "Hello from thread "
 PUT $ID
 PUTS "!\n"
-MUTEX_UNLOCK $IO_MUT
+MUTEX_UNLOCK $$IO_MUT
 
 SLEEP 1000
 
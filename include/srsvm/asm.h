@@ -114,6 +114,8 @@ typedef struct
     srsvm_assembler_message_report_func *on_warning;
     void* io_config;
 
+    bool uncompressed;
+
     srsvm_opcode *builtin_LOAD_CONST;
     srsvm_opcode *builtin_MOD_LOAD;
     srsvm_opcode *builtin_MOD_UNLOAD;
@@ -130,6 +132,7 @@ typedef struct
     srsvm_opcode *builtin_CJMP_BACK_IF;
     srsvm_opcode *builtin_CJMP_BACK_ERR;
     srsvm_opcode *builtin_THREAD_START;
+    srsvm_opcode *builtin_CALL;
 
 } srsvm_assembly_program;
 
@@ -141,6 +144,7 @@ srsvm_assembly_program *srsvm_asm_program_alloc(srsvm_assembler_message_report_f
 void srsvm_asm_program_free(srsvm_assembly_program *program);
 
 void srsvm_asm_program_set_search_path(srsvm_assembly_program *program, const char** search_path);
+void srsvm_asm_program_set_compression(srsvm_assembly_program *program, const bool compress);
 
 bool srsvm_asm_line_parse(srsvm_assembly_program *program, const char* line_str, const char* input_filename, unsigned long line_number);
 
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "srsvm/forward-decls.h"
+#include "srsvm/impl.h"
+#include "srsvm/memory.h"
+#include "srsvm/opcode.h"
+#include "srsvm/word.h"
+
+#define SRSVM_DECODE_ARG_BLOCK_SIZE 1024
+#define SRSVM_DECODE_BINDING_BLOCK_SIZE 64
+
+/* The module opcode a MOD_OP call site last resolved to, valid for as long
+ * as the VM's module generation is unchanged. Rebinding happens under the
+ * cache lock and bumps sequence around the update (a seqlock, odd while
+ * the fields are being written). */
+typedef struct
+{
+    srsvm_atomic_counter sequence;
+    srsvm_atomic_counter generation;
+
+    srsvm_word module_id;
+    srsvm_opcode *opcode;
+} srsvm_module_binding;
+
+typedef struct
+{
+    srsvm_opcode *opcode;
+
+    srsvm_word argc;
+    const srsvm_arg *argv;
+
+    srsvm_ptr next_PC;
+
+    const void *handler;
+
+    srsvm_module_binding *binding;
+} srsvm_decoded_instruction;
+
+typedef struct srsvm_decode_arg_block srsvm_decode_arg_block;
+
+struct srsvm_decode_arg_block
+{
+    srsvm_decode_arg_block *next;
+
+    size_t used;
+    srsvm_arg args[SRSVM_DECODE_ARG_BLOCK_SIZE];
+};
+
+typedef struct srsvm_decode_binding_block srsvm_decode_binding_block;
+
+struct srsvm_decode_binding_block
+{
+    srsvm_decode_binding_block *next;
+
+    size_t used;
+    srsvm_module_binding bindings[SRSVM_DECODE_BINDING_BLOCK_SIZE];
+};
+
+typedef struct srsvm_decode_table srsvm_decode_table;
+
+/* One generation of decoded slots, along with the argument and binding
+ * blocks they point into. A slot is filled under the cache lock and
+ * published by a release store of its opcode; a published table is never
+ * cleared. Invalidation publishes a fresh table instead and retires the old
+ * one through the MMU, which hands it back for reuse once no thread can
+ * still be running from it. */
+struct srsvm_decode_table
+{
+    srsvm_mmu_deferred deferred;
+
+    srsvm_decode_cache *cache;
+
+    size_t num_decoded;
+
+    srsvm_decode_arg_block *arg_blocks;
+    srsvm_decode_binding_block *binding_blocks;
+
+    srsvm_decoded_instruction instructions[];
+};
+
+struct srsvm_decode_cache
+{
+    srsvm_lock lock;
+
+    srsvm_memory_segment *root_segment;
+    srsvm_memory_segment *segment;
+
+    srsvm_ptr base;
+    srsvm_word size;
+
+    size_t num_slots;
+
+    /* NULL if a fresh table could not be allocated; fetches then miss. */
+    srsvm_decode_table *table;
+    srsvm_decode_table *spare;
+
+    srsvm_decode_cache *next;
+};
+
+srsvm_decode_cache *srsvm_decode_cache_alloc(srsvm_memory_segment *root_segment, srsvm_memory_segment *segment);
+void srsvm_decode_cache_free(srsvm_decode_cache *cache);
+
+void srsvm_decode_cache_invalidate(srsvm_decode_cache *cache);
+void srsvm_decode_cache_detach(srsvm_decode_cache *cache);
+
+static inline bool srsvm_decode_cache_contains(const srsvm_decode_cache *cache, const srsvm_ptr addr)
+{
+    return cache->segment != NULL && addr >= cache->base && addr - cache->base < cache->size;
+}
+
+/* The returned slot stays valid while the calling thread's decode reader
+ * remains in the read section it was fetched in. */
+const srsvm_decoded_instruction *srsvm_decode_cache_fetch(srsvm_vm *vm, srsvm_decode_cache *cache, const srsvm_ptr addr);
+
+/* Binds a MOD_OP call site to a module opcode; returns false if the cache
+ * has been detached or the binding could not be allocated. */
+bool srsvm_decode_cache_bind(srsvm_decode_cache *cache, const srsvm_decoded_instruction *decoded, const srsvm_word module_id, srsvm_opcode *opcode, const srsvm_atomic_counter generation);
+
+/* Returns the opcode a call site is bound to for module_id, or NULL if the
+ * binding is missing or stale. */
+static inline srsvm_opcode *srsvm_decode_bound_opcode(const srsvm_decoded_instruction *decoded, const srsvm_word module_id, const srsvm_atomic_counter generation)
+{
+    srsvm_module_binding *binding = srsvm_atomic_load_ptr(&decoded->binding);
+
+    if(binding == NULL){
+        return NULL;
+    }
+
+    unsigned sequence = srsvm_atomic_load_acquire(&binding->sequence);
+
+    if(sequence % 2 != 0){
+        return NULL;
+    }
+
+    srsvm_opcode *opcode = binding->opcode;
+    bool valid = binding->module_id == module_id && binding->generation == generation;
+
+    srsvm_atomic_fence();
+
+    return valid && srsvm_atomic_load(&binding->sequence) == sequence ? opcode : NULL;
+}
+
+const void *srsvm_builtin_threaded_handler(const srsvm_opcode *opcode);
+void srsvm_builtin_run_threaded(srsvm_vm *vm, srsvm_thread *thread, srsvm_decode_cache *cache, const srsvm_decoded_instruction *decoded);
@@ -32,4 +32,10 @@ typedef struct srsvm_handle srsvm_handle;
 
 typedef struct srsvm_opcode srsvm_opcode;
 
+typedef struct srsvm_opcode_table srsvm_opcode_table;
+
 typedef struct srsvm_opcode_map srsvm_opcode_map;
+
+typedef struct srsvm_decode_cache srsvm_decode_cache;
+
+typedef struct srsvm_heap_slab srsvm_heap_slab;
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "srsvm/forward-decls.h"
+#include "srsvm/impl.h"
+#include "srsvm/memory.h"
+#include "srsvm/word.h"
+
+/* Small guest allocations are carved out of slab segments, one size class
+ * per slab, and handed out through a per-thread cache so that ALLOC and
+ * FREE usually touch neither the heap lock nor the segment tree. Anything
+ * larger than the biggest size class gets a segment of its own. */
+
+#define SRSVM_HEAP_MIN_BLOCK_SHIFT 4
+
+#if WORD_SIZE == 16
+#define SRSVM_HEAP_SLAB_SIZE 1024
+#define SRSVM_HEAP_NUM_CLASSES 4
+#else
+#define SRSVM_HEAP_SLAB_SIZE 65536
+#define SRSVM_HEAP_NUM_CLASSES 8
+#endif
+
+#define SRSVM_HEAP_MAX_BLOCK ((srsvm_word) 1 << (SRSVM_HEAP_MIN_BLOCK_SHIFT + SRSVM_HEAP_NUM_CLASSES - 1))
+
+#define SRSVM_HEAP_CACHE_SIZE 32
+
+struct srsvm_heap_slab
+{
+    srsvm_memory_segment *segment;
+
+    srsvm_ptr base;
+
+    unsigned size_class;
+    unsigned block_shift;
+
+    size_t num_blocks;
+
+    size_t num_free;
+    size_t *free_blocks;
+
+    srsvm_heap_slab *prev;
+    srsvm_heap_slab *next;
+    bool listed;
+
+    unsigned char *allocated;
+};
+
+typedef struct
+{
+    srsvm_heap_slab *slab;
+    size_t index;
+} srsvm_heap_block;
+
+typedef struct
+{
+    srsvm_heap_block blocks[SRSVM_HEAP_NUM_CLASSES][SRSVM_HEAP_CACHE_SIZE];
+    unsigned count[SRSVM_HEAP_NUM_CLASSES];
+} srsvm_heap_cache;
+
+typedef struct
+{
+    srsvm_lock lock;
+
+    srsvm_memory_segment *root_segment;
+
+    srsvm_heap_slab *partial[SRSVM_HEAP_NUM_CLASSES];
+} srsvm_heap;
+
+srsvm_heap *srsvm_heap_alloc(srsvm_memory_segment *root_segment);
+void srsvm_heap_free(srsvm_heap *heap);
+
+void srsvm_heap_cache_init(srsvm_heap_cache *cache);
+void srsvm_heap_cache_flush(srsvm_heap *heap, srsvm_heap_cache *cache);
+
+bool srsvm_heap_get(srsvm_heap *heap, srsvm_heap_cache *cache, const srsvm_word bytes, srsvm_ptr *address);
+
+/* The segment must have been located inside a read section that is still
+ * open. Returns false if address is not an allocated block. */
+bool srsvm_heap_put(srsvm_heap *heap, srsvm_heap_cache *cache, srsvm_memory_segment *segment, const srsvm_ptr address);
+
+/* A region is a single segment handed out by bumping an offset, so that
+ * everything allocated from it is released at once by a reset or by
+ * destroying the region. */
+
+bool srsvm_heap_region_create(srsvm_heap *heap, const srsvm_word bytes, srsvm_ptr *address);
+bool srsvm_heap_region_alloc(srsvm_memory_segment *region, const srsvm_word bytes, srsvm_ptr *address);
+void srsvm_heap_region_reset(srsvm_memory_segment *region);
+void srsvm_heap_region_destroy(srsvm_memory_segment *region);
+
+/* Whether [address, address + bytes) lies within one allocated block. */
+static inline bool srsvm_heap_slab_contains(const srsvm_heap_slab *slab, const srsvm_ptr address, const srsvm_word bytes)
+{
+    srsvm_word offset = address - slab->base;
+    srsvm_word index = offset >> slab->block_shift;
+
+    return index < slab->num_blocks && slab->allocated[(size_t) index] && (offset & (((srsvm_word) 1 << slab->block_shift) - 1)) + bytes <= ((srsvm_word) 1 << slab->block_shift);
+}
+
+/* Number of bytes from address to the end of its block, or 0 if the block
+ * is not allocated. */
+static inline srsvm_word srsvm_heap_slab_extent(const srsvm_heap_slab *slab, const srsvm_ptr address)
+{
+    if(! srsvm_heap_slab_contains(slab, address, 0)){
+        return 0;
+    }
+
+    return ((srsvm_word) 1 << slab->block_shift) - ((address - slab->base) & (((srsvm_word) 1 << slab->block_shift) - 1));
+}
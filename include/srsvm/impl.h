@@ -39,11 +39,16 @@ bool srsvm_thread_start(srsvm_thread *thread, native_thread_proc proc, void* arg
 void srsvm_thread_exit(srsvm_thread_exit_info *info);
 bool srsvm_thread_join(srsvm_thread *thread, srsvm_thread_exit_info **info);
 
+/* Host threads that never run guest code. */
+bool srsvm_native_thread_start(srsvm_thread_native_handle *handle, native_thread_proc proc, void* arg);
+bool srsvm_native_thread_join(srsvm_thread_native_handle *handle);
+
 void srsvm_sleep(const srsvm_word ms_timeout);
 
 typedef bool (*srsvm_module_opcode_loader)(void*, srsvm_opcode*);
 
 bool srsvm_native_module_load_opcodes(srsvm_native_module_handle* handle, srsvm_module_opcode_loader loader, void* arg);
+const srsvm_opcode_table *srsvm_native_module_opcode_table(srsvm_native_module_handle* handle);
 #endif
 
 bool srsvm_native_module_supports_word_size(srsvm_native_module_handle *handle, const uint8_t word_size);
@@ -57,15 +62,45 @@ char* srsvm_getcwd(void);
 bool srsvm_path_is_absolute(const char* path);
 bool srsvm_directory_exists(const char* dir_name);
 bool srsvm_file_exists(const char* file_name);
+bool srsvm_file_mtime(const char* file_name, uint64_t *mtime);
 char *srsvm_path_combine(const char* path_1, const char* path_2);
 
+/* The per-user directory srsVM keeps caches in, created if missing; NULL
+ * when there is nowhere to put one. */
+char* srsvm_cache_directory(void);
+
 int srsvm_strcasecmp(const char* a, const char* b);
 int srsvm_strncasecmp(const char* a, const char* b, const size_t count);
 
 char *srsvm_strdup(const char* s);
 char *srsvm_strndup(const char* s, const size_t n);
 
+size_t srsvm_vmem_page_size(void);
+size_t srsvm_cpu_count(void);
+
+void *srsvm_vmem_reserve(const size_t size);
+void srsvm_vmem_release(void *addr, const size_t size);
+
+bool srsvm_vmem_protect(void *addr, const size_t size, const bool readable, const bool writable);
+void srsvm_vmem_decommit(void *addr, const size_t size);
+
+/* Maps a whole file copy-on-write: pages are shared with the page cache
+ * until they are written. */
+void *srsvm_file_map(const char* file_name, size_t *size);
+void srsvm_file_unmap(void *addr, const size_t size);
+
 #if defined(SRSVM_SUPPORT_COMPRESSION)
 void *srsvm_zlib_deflate(const void* data, size_t *compressed_size, const size_t original_size);
 void *srsvm_zlib_inflate(const void* data, const size_t compressed_size, const size_t original_size);
+bool srsvm_zlib_inflate_into(const void* data, const size_t compressed_size, void *dest, const size_t original_size);
+uint32_t srsvm_zlib_crc32(const void* data, const size_t size);
+
+#define SRSVM_CODEC_ZLIB 0
+#define SRSVM_CODEC_LZ4 1
+#define SRSVM_CODEC_ZSTD 2
+
+bool srsvm_codec_supported(const unsigned codec);
+void *srsvm_codec_compress(const unsigned codec, const void* data, size_t *compressed_size, const size_t original_size);
+void *srsvm_codec_decompress(const unsigned codec, const void* data, const size_t compressed_size, const size_t original_size);
+bool srsvm_codec_decompress_into(const unsigned codec, const void* data, const size_t compressed_size, void *dest, const size_t original_size);
 #endif
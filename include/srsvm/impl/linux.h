@@ -1,6 +1,7 @@
 #pragma once
 
 #include <pthread.h>
+#include <stdlib.h>
 
 #define SRSVM_MODULE_FILE_EXTENSION ".svmmod"
 
@@ -17,6 +18,29 @@
 
 typedef pthread_mutex_t srsvm_lock;
 
+typedef unsigned srsvm_atomic_counter;
+
+#define srsvm_atomic_increment(counter) __atomic_add_fetch((counter), 1, __ATOMIC_SEQ_CST)
+#define srsvm_atomic_decrement(counter) __atomic_sub_fetch((counter), 1, __ATOMIC_SEQ_CST)
+#define srsvm_atomic_load(counter) __atomic_load_n((counter), __ATOMIC_RELAXED)
+#define srsvm_atomic_load_acquire(counter) __atomic_load_n((counter), __ATOMIC_ACQUIRE)
+#define srsvm_atomic_store(counter, value) __atomic_store_n((counter), (value), __ATOMIC_RELEASE)
+#define srsvm_atomic_load_ptr(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define srsvm_atomic_store_ptr(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+#define srsvm_atomic_fence() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define srsvm_atomic_swap_byte(byte, value) __atomic_exchange_n((byte), (value), __ATOMIC_ACQ_REL)
+#define srsvm_atomic_cas_size(ptr, expected, desired) __atomic_compare_exchange_n((ptr), (expected), (desired), false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+#define srsvm_atomic_store_size(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+
+static inline void *srsvm_aligned_alloc(const size_t alignment, const size_t size)
+{
+    void *ptr = NULL;
+
+    return posix_memalign(&ptr, alignment, size) == 0 ? ptr : NULL;
+}
+
+#define srsvm_aligned_free(ptr) free(ptr)
+
 typedef pthread_t srsvm_thread_native_handle;
 
 typedef void* srsvm_native_module_handle;
@@ -16,6 +16,36 @@
 
 typedef CRITICAL_SECTION srsvm_lock;
 
+typedef volatile LONG srsvm_atomic_counter;
+
+#define srsvm_atomic_increment(counter) InterlockedIncrement(counter)
+#define srsvm_atomic_decrement(counter) InterlockedDecrement(counter)
+#define srsvm_atomic_load(counter) (*(counter))
+#define srsvm_atomic_load_acquire(counter) (*(counter))
+#define srsvm_atomic_store(counter, value) InterlockedExchange((counter), (value))
+#define srsvm_atomic_load_ptr(ptr) (*(void * volatile *) (ptr))
+#define srsvm_atomic_store_ptr(ptr, value) InterlockedExchangePointer((PVOID volatile*) (ptr), (PVOID) (value))
+#define srsvm_atomic_fence() MemoryBarrier()
+#define srsvm_atomic_swap_byte(byte, value) ((unsigned char) InterlockedExchange8((volatile char*) (byte), (char) (value)))
+
+static inline bool srsvm_atomic_cas_size(volatile size_t *ptr, size_t *expected, const size_t desired)
+{
+    size_t seen = (size_t) InterlockedCompareExchangePointer((PVOID volatile*) ptr, (PVOID) desired, (PVOID) *expected);
+
+    if(seen == *expected){
+        return true;
+    }
+
+    *expected = seen;
+
+    return false;
+}
+
+#define srsvm_atomic_store_size(ptr, value) InterlockedExchangePointer((PVOID volatile*) (ptr), (PVOID) (size_t) (value))
+
+#define srsvm_aligned_alloc(alignment,size) _aligned_malloc((size),(alignment))
+#define srsvm_aligned_free(ptr) _aligned_free(ptr)
+
 typedef HANDLE srsvm_thread_native_handle;
 
 typedef HANDLE srsvm_native_module_handle;
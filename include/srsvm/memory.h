@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
 
 #include "srsvm/forward-decls.h"
 
@@ -55,6 +56,83 @@
 
 #endif
 
+#if WORD_SIZE == 32 || WORD_SIZE == 64
+#define SRSVM_SUPPORT_FLAT_MEMORY
+#endif
+
+#if WORD_SIZE == 32
+#define SRSVM_FLAT_MEMORY_SIZE ((uint64_t) 1 << 32)
+#elif WORD_SIZE == 64
+#define SRSVM_FLAT_MEMORY_SIZE ((uint64_t) 1 << 36)
+#endif
+
+#define SRSVM_FLAT_PAGE_READ 0x1
+#define SRSVM_FLAT_PAGE_WRITE 0x2
+#define SRSVM_FLAT_PAGE_MAPPED 0x4
+
+/* A flat address space reserves one host window for the whole guest
+ * address range and commits pages into it as segments are allocated, so
+ * that a guest address translates to base + address. page_flags records
+ * which pages belong to a live segment and what the guest may do with
+ * them; anything else falls back to the segment tree. */
+typedef struct
+{
+    char *base;
+    size_t size;
+
+    srsvm_word page_size;
+    unsigned page_shift;
+
+    unsigned char *page_flags;
+} srsvm_flat_memory;
+
+/* The contents of a literal segment that are still compressed, split into
+ * chunks that are inflated independently the first time the guest touches
+ * them. Chunk i covers [i * chunk_size, (i + 1) * chunk_size) of the
+ * segment and is stored at data + chunk_offsets[i]. */
+typedef struct
+{
+    const char *data;
+    unsigned codec;
+
+    size_t chunk_size;
+    size_t num_chunks;
+    size_t *chunk_offsets;
+
+    srsvm_atomic_counter *materialized;
+    srsvm_atomic_counter remaining;
+
+    /* When set, the CRC-32 of the stored_size bytes at data is checked
+     * before the first chunk is inflated. */
+    bool checksum_pending;
+    uint32_t checksum;
+    size_t stored_size;
+
+    srsvm_memory_segment *root_segment;
+} srsvm_compressed_memory;
+
+typedef struct srsvm_mmu_reader srsvm_mmu_reader;
+
+struct srsvm_mmu_reader
+{
+    srsvm_atomic_counter epoch;
+
+    srsvm_mmu_reader *next;
+};
+
+typedef struct srsvm_mmu_deferred srsvm_mmu_deferred;
+
+/* Host memory that readers may still be using, e.g. a retired decode table;
+ * release is called once no reader can reach it. */
+struct srsvm_mmu_deferred
+{
+    srsvm_atomic_counter retire_epoch;
+
+    void (*release)(srsvm_mmu_deferred *deferred);
+
+    srsvm_mmu_deferred *next;
+};
+
 struct srsvm_memory_segment
 {
     struct srsvm_memory_segment *parent;    
@@ -69,7 +147,30 @@ struct srsvm_memory_segment
     srsvm_ptr literal_start;
     srsvm_word literal_sz;
 
-    srsvm_memory_segment *children[WORD_SIZE];
+    srsvm_memory_segment *children;
+
+    srsvm_memory_segment *lchild;
+    srsvm_memory_segment *rchild;
+    unsigned long height;
+
+    srsvm_ptr subtree_min;
+    srsvm_ptr subtree_max;
+    srsvm_word max_gap;
+
+    srsvm_decode_cache *decode_cache;
+
+    srsvm_flat_memory *flat;
+    bool mapped;
+
+    /* literal_memory belongs to someone else, e.g. a mapped program file. */
+    bool borrowed;
+
+    srsvm_compressed_memory *compressed;
+
+    srsvm_heap_slab *slab;
+
+    bool region;
+    size_t region_used;
     
     bool readable;
     bool writable;
@@ -79,5 +180,15 @@ struct srsvm_memory_segment
 
     bool free_flag;
 
+    srsvm_atomic_counter generation;
+
+    srsvm_atomic_counter epoch;
+    srsvm_mmu_reader *readers;
+    srsvm_memory_segment *retired;
+    srsvm_mmu_deferred *deferred;
+
+    srsvm_atomic_counter retire_epoch;
+    srsvm_memory_segment *next_retired;
+
     srsvm_lock lock;
 };
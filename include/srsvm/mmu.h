@@ -7,10 +7,104 @@ bool srsvm_mmu_segment_contains_literal(const srsvm_memory_segment *segment, con
 
 srsvm_memory_segment*  srsvm_mmu_locate(srsvm_memory_segment *root_segment, srsvm_ptr address);
 
+/* Guest loads and stores run inside a read section rather than under a
+ * lock: translation is validated against the root segment's generation
+ * (a seqlock, odd while a structural change is in progress), and freed
+ * segments are only reclaimed once every reader has left the epoch in
+ * which they were unlinked. */
+
+void srsvm_mmu_reader_register(srsvm_memory_segment *root_segment, srsvm_mmu_reader *reader);
+void srsvm_mmu_reader_unregister(srsvm_memory_segment *root_segment, srsvm_mmu_reader *reader);
+
+static inline void srsvm_mmu_read_begin(srsvm_memory_segment *root_segment, srsvm_mmu_reader *reader)
+{
+    srsvm_atomic_store(&reader->epoch, srsvm_atomic_load_acquire(&root_segment->epoch));
+    srsvm_atomic_fence();
+}
+
+static inline void srsvm_mmu_read_end(srsvm_mmu_reader *reader)
+{
+    srsvm_atomic_store(&reader->epoch, 0);
+}
+
+/* Moves a long-lived read section forward to the current epoch. Only call
+ * it where the reader holds nothing it found inside the section. */
+static inline void srsvm_mmu_read_refresh(srsvm_memory_segment *root_segment, srsvm_mmu_reader *reader)
+{
+    if(srsvm_atomic_load(&root_segment->epoch) != srsvm_atomic_load(&reader->epoch)){
+        srsvm_mmu_read_begin(root_segment, reader);
+    }
+}
+
+/* Hands deferred to the root segment, which releases it once every reader
+ * has left the epoch it was retired in. Takes the root lock. */
+void srsvm_mmu_defer_release(srsvm_memory_segment *root_segment, srsvm_mmu_deferred *deferred);
+
+srsvm_memory_segment* srsvm_mmu_translate(srsvm_memory_segment *root_segment, const srsvm_ptr address);
+
+bool srsvm_mmu_map_flat(srsvm_memory_segment *root_segment);
+
+#if defined(SRSVM_SUPPORT_FLAT_MEMORY)
+/* Returns the host address backing [address, address + bytes) if it lies
+ * within a single page whose flags grant the requested access. Must be
+ * called inside a read section. */
+static inline char *srsvm_mmu_flat_translate(const srsvm_flat_memory *flat, const srsvm_ptr address, const srsvm_word bytes, const unsigned char access)
+{
+    if(address < flat->size && bytes > 0 && bytes <= flat->size - address){
+        size_t page = (size_t) (address >> flat->page_shift);
+
+        if(page == (size_t) ((address + bytes - 1) >> flat->page_shift) && (flat->page_flags[page] & access) == access){
+            return flat->base + (size_t) address;
+        }
+    }
+
+    return NULL;
+}
+#endif
+
+#define SRSVM_MMU_MAX_INFLATE_THREADS 16
+
+/* Inflates whatever part of [address, address + bytes) is still compressed,
+ * spreading the chunks over up to SRSVM_MMU_MAX_INFLATE_THREADS cores.
+ * Returns false if the chunks could not be inflated. */
+bool srsvm_mmu_segment_inflate(const srsvm_memory_segment *segment, const srsvm_ptr address, const srsvm_word bytes);
+
+static inline bool srsvm_mmu_segment_materialize(const srsvm_memory_segment *segment, const srsvm_ptr address, const srsvm_word bytes)
+{
+    return segment->compressed == NULL || srsvm_mmu_segment_inflate(segment, address, bytes);
+}
+
 bool srsvm_mmu_store(srsvm_memory_segment *root_segment, const srsvm_ptr address, const srsvm_word bytes, void* src);
 bool srsvm_mmu_load(srsvm_memory_segment *root_segment, const srsvm_ptr address, const srsvm_word bytes, void* dest);
 
+bool srsvm_mmu_segment_store(srsvm_memory_segment *segment, const srsvm_ptr address, const srsvm_word bytes, void* src);
+bool srsvm_mmu_segment_load(srsvm_memory_segment *segment, const srsvm_ptr address, const srsvm_word bytes, void* dest);
+
+/* Number of bytes the guest may read from address to the end of its
+ * allocation, or 0 if address is not readable. */
+srsvm_word srsvm_mmu_segment_extent(const srsvm_memory_segment *segment, const srsvm_ptr address);
+
+/* Host address backing address if the guest may read (or write) it. The
+ * allocation around address is contiguous in host memory: before and after
+ * receive how many bytes of it precede address and how many remain from
+ * address on. Must be called inside a read section. */
+char *srsvm_mmu_segment_span(const srsvm_memory_segment *segment, const srsvm_ptr address, const bool write, srsvm_word *before, srsvm_word *after);
+
+void srsvm_mmu_set_permissions(srsvm_memory_segment *segment, const bool readable, const bool writable, const bool executable, const bool locked);
+void srsvm_mmu_set_decode_cache(srsvm_memory_segment *segment, srsvm_decode_cache *cache);
+void srsvm_mmu_set_slab(srsvm_memory_segment *segment, srsvm_heap_slab *slab);
+
 srsvm_memory_segment* srsvm_mmu_alloc_literal(srsvm_memory_segment *parent_segment, const srsvm_word literal_size, const srsvm_ptr suggested_base_address);
+/* Backs the segment with memory that outlives it (a mapped program file)
+ * instead of a private copy. In a flat address space the segment gets its
+ * own pages and memory is copied into them. */
+srsvm_memory_segment* srsvm_mmu_alloc_literal_backed(srsvm_memory_segment *parent_segment, const srsvm_word literal_size, const srsvm_ptr suggested_base_address, void *memory);
+/* Leaves the segment's contents compressed until they are first touched.
+ * data must outlive the segment; the chunk table is copied. */
+srsvm_memory_segment* srsvm_mmu_alloc_literal_compressed(srsvm_memory_segment *parent_segment, const srsvm_word literal_size, const srsvm_ptr suggested_base_address, const void *data, const unsigned codec, const size_t chunk_size, const size_t num_chunks, const size_t *chunk_offsets);
+/* Has the stored contents of a compressed segment checked against checksum
+ * the first time any of it is inflated. */
+void srsvm_mmu_segment_expect_checksum(srsvm_memory_segment *segment, const size_t stored_size, const uint32_t checksum);
 srsvm_memory_segment* srsvm_mmu_alloc_virtual(srsvm_memory_segment *parent_segment, const srsvm_word virtual_size, const srsvm_ptr base_address);
 
 void srsvm_mmu_free(srsvm_memory_segment *segment);
@@ -13,6 +13,7 @@ typedef struct
     srsvm_opcode_map *opcode_map;
 
     srsvm_native_module_handle handle;
+    bool builtin;
     unsigned long ref_count;
 
     void *tag;
@@ -23,6 +24,12 @@ typedef struct
 srsvm_module *srsvm_module_alloc(const char* name, const char* filename, srsvm_word id);
 void srsvm_module_free(srsvm_module *mod);
 
+/* Modules linked into the runtime at build time (see BUILTIN_MODULES in
+ * src/arch/Makefile) are resolved by name without touching the filesystem
+ * and take precedence over a module file of the same name. */
+bool srsvm_module_is_builtin(const char* name);
+srsvm_module *srsvm_module_alloc_builtin(const char* name, srsvm_word id);
+
 /*typedef struct srsvm_module_map_node srsvm_module_map_node;
 
 struct srsvm_module_map_node
@@ -48,6 +55,18 @@ typedef struct
 
 char* srsvm_module_find(const char* module_name, const char* prog_cwd, char** search_path, bool search_multilib);
 
+/* Where srsvm_module_find last found each module, saved across runs in a
+ * file under srsvm_cache_directory() for each working directory and search
+ * path. The file is ignored once any searched directory has changed, and
+ * an entry once its module file has. Safe to share between threads. */
+typedef struct srsvm_module_path_cache srsvm_module_path_cache;
+
+srsvm_module_path_cache *srsvm_module_path_cache_alloc(void);
+void srsvm_module_path_cache_free(srsvm_module_path_cache *cache);
+
+char* srsvm_module_path_cache_find(srsvm_module_path_cache *cache, const char* module_name, const char* prog_cwd, char** search_path, bool search_multilib);
+void srsvm_module_path_cache_save(srsvm_module_path_cache *cache);
+
 /*srsvm_module_map *srsvm_module_map_alloc(void);
 void srsvm_module_map_free(srsvm_module_map* map);
 
@@ -58,12 +58,16 @@ static inline bool resolve_arg_word(srsvm_vm *vm, srsvm_thread *thread, const sr
 				break;
 
 			case SRSVM_ARG_TYPE_REGISTER:
-				if(arg->value < SRSVM_REGISTER_MAX_COUNT && vm->registers[arg->value] != NULL){
-					if(dest != NULL){
-						*dest = vm->registers[arg->value]->value.word;
-					}
+				{
+					srsvm_register *reg = srsvm_register_context_lookup(thread->registers, vm->registers, arg->value);
 
-					success = true;
+					if(reg != NULL){
+						if(dest != NULL){
+							*dest = reg->value.word;
+						}
+
+						success = true;
+					}
 				}
 				break;
 
@@ -90,7 +94,7 @@ static inline bool resolve_arg_word(srsvm_vm *vm, srsvm_thread *thread, const sr
 
 static inline bool register_writable(const srsvm_register *reg)
 {
-	return !(reg->locked || reg->read_only);
+	return !(reg->flags->locked || reg->flags->read_only);
 }
 
 #define ENSURE_WRITABLE(reg) do { \
@@ -100,28 +104,18 @@ static inline bool register_writable(const srsvm_register *reg)
 static inline bool fault_on_not_writable(srsvm_thread *thread, srsvm_register *reg)
 {
 	if(! register_writable(reg)){
-		thread_set_fault(thread, "Attempted to write to non-writable register %s", reg->name);
+		thread_set_fault(thread, "Attempted to write to non-writable register %s", srsvm_register_name(reg));
 		return true;
 	} else {
 		return false;
 	}
 }
 
-static inline bool set_register_error_bit(srsvm_register *reg, const char* fmt, ...)
+static inline bool set_register_error_bit(srsvm_register *reg, const srsvm_register_error code, const char *arg)
 {
 	ENSURE_WRITABLE(reg);
 
-	va_list args;
-
-	va_start(args, fmt);
-	
-	vsnprintf(reg->error_str, sizeof(reg->error_str), fmt, args);
-	
-	va_end(args);	
-
-	reg->error_flag = true;
-
-	return true;
+	return srsvm_register_set_error(reg, code, arg);
 }
 
 static inline bool clear_reg(srsvm_register *reg)
@@ -142,8 +136,9 @@ static inline bool clear_reg(srsvm_register *reg)
 	reg->value.str = NULL;
 	reg->value.str_len = 0;
 
-	memset(reg->error_str, 0, sizeof(reg->error_str));
-	reg->error_flag = false;
+	if(reg->flags->error_flag){
+		srsvm_register_set_error_flag(reg, false);
+	}
 
 	return true;
 }
@@ -171,18 +166,18 @@ static inline bool clear_reg(srsvm_register *reg)
 }
 
 #define MEM_LOAD_HELPER(name,type,field) \
-	static inline bool name(const srsvm_vm *vm, srsvm_register *reg, const srsvm_ptr ptr, const srsvm_word offset) \
+	static inline bool name(const srsvm_vm *vm, srsvm_thread *thread, srsvm_register *reg, const srsvm_ptr ptr, const srsvm_word offset) \
 { \
 	ENSURE_WRITABLE(reg); \
 	ENSURE_SPACE(type, field); \
     clear_reg(reg); \
-	return srsvm_mmu_load(vm->mem_root, ptr, sizeof(type), &reg->value.field + offset); \
+	return srsvm_tlb_load(&thread->tlb, ptr, sizeof(type), &reg->value.field + offset); \
 }
 
 #define MEM_STORE_HELPER(name,type,field) \
-	static inline bool name(const srsvm_vm *vm, srsvm_register *reg, const srsvm_ptr ptr, const srsvm_word offset) \
+	static inline bool name(const srsvm_vm *vm, srsvm_thread *thread, srsvm_register *reg, const srsvm_ptr ptr, const srsvm_word offset) \
 { \
-	return srsvm_mmu_store(vm->mem_root, ptr, sizeof(type), &reg->value.field + offset); \
+	return srsvm_tlb_store(&thread->tlb, ptr, sizeof(type), &reg->value.field + offset); \
 }
 
 #define MK_HELPERS(type,field) \
@@ -242,9 +237,9 @@ static inline bool load_str(srsvm_register *reg, const char* value, size_t len)
 	}
 }
 
-static inline bool mem_store_str(const srsvm_vm *vm, srsvm_register *reg, const srsvm_ptr ptr, const srsvm_word offset)
+static inline bool mem_store_str(const srsvm_vm *vm, srsvm_thread *thread, srsvm_register *reg, const srsvm_ptr ptr, const srsvm_word offset)
 {
-	return srsvm_mmu_store(vm->mem_root, ptr, (reg->value.str_len + 1) * sizeof(char), &reg->value.str);
+	return srsvm_tlb_store(&thread->tlb, ptr, (reg->value.str_len + 1) * sizeof(char), &reg->value.str);
 }
 
 static inline bool load_handle(const srsvm_vm *vm, srsvm_register *reg, srsvm_handle *hnd)
@@ -260,27 +255,36 @@ static inline bool load_handle(const srsvm_vm *vm, srsvm_register *reg, srsvm_ha
 }
 
 
-static inline bool mem_load_str(const srsvm_vm *vm, srsvm_register *reg, const srsvm_ptr ptr, const srsvm_word offset)
+static inline bool mem_load_str(const srsvm_vm *vm, srsvm_thread *thread, srsvm_register *reg, const srsvm_ptr ptr, const srsvm_word offset)
 {
 	ENSURE_WRITABLE(reg);
     
     clear_reg(reg);
 	
-    srsvm_memory_segment *seg = srsvm_mmu_locate(vm->mem_root, ptr);
+	bool success = false;
+
+	srsvm_tlb_read_begin(&thread->tlb);
+
+	srsvm_memory_segment *seg = srsvm_tlb_locate(&thread->tlb, ptr);
 
-	if(seg != NULL){
-		for(size_t str_len = 0; str_len < seg->literal_sz - (ptr - seg->literal_start); str_len++){
-			char *lit_ptr = ((char*) seg->literal_memory) + str_len;
+	srsvm_word extent = seg != NULL ? srsvm_mmu_segment_extent(seg, ptr) : 0;
 
-			if(*lit_ptr == 0){
-				reg->value.str = srsvm_strdup(lit_ptr - str_len);
+	if(extent > 0 && srsvm_mmu_segment_materialize(seg, ptr, extent)){
+		const char *str = ((char*) seg->literal_memory) + (uintptr_t) (ptr - seg->literal_start);
+
+		for(size_t str_len = 0; str_len < extent; str_len++){
+			if(str[str_len] == 0){
+				reg->value.str = srsvm_strdup(str);
 				reg->value.str_len = (srsvm_word) str_len;
-				return true;
+				success = true;
+				break;
 			}
 		}
 	}
 
-	return false;
+	srsvm_tlb_read_end(&thread->tlb);
+
+	return success;
 }
 
 static inline bool load_str_len(srsvm_register *reg, const char* value)
@@ -298,7 +302,7 @@ static inline srsvm_register* register_lookup(const srsvm_vm *vm, srsvm_thread *
 		srsvm_word register_id = arg->value;
 
 		if(register_id< SRSVM_REGISTER_MAX_COUNT){
-			reg = vm->registers[register_id];
+			reg = srsvm_register_context_lookup(thread->registers, vm->registers, register_id);
 
 			if(reg == NULL){
 				thread_set_fault(thread, "Attempt to access an unallocated register with index " PRINT_WORD_HEX, register_id);
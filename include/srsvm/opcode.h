@@ -58,6 +58,15 @@ typedef struct
 
 typedef void (srsvm_opcode_func)(srsvm_vm*, srsvm_thread*, const srsvm_word argc, const srsvm_arg argv[]);
 
+/* Result depends only on the operand registers; the only side effect is
+ * the write to the destination register. */
+#define SRSVM_OPCODE_FLAG_PURE 0x1
+/* Never faults on operand values; a missing or read-only register
+ * operand can still fault. */
+#define SRSVM_OPCODE_FLAG_NO_FAULT 0x2
+#define SRSVM_OPCODE_FLAG_READS_MEMORY 0x4
+#define SRSVM_OPCODE_FLAG_WRITES_MEMORY 0x8
+
 struct srsvm_opcode
 {
     srsvm_word code;    
@@ -67,30 +76,51 @@ struct srsvm_opcode
     unsigned short argc_max;
 
     srsvm_opcode_func *func;
+
+    unsigned flags;
 };
 
-typedef struct srsvm_opcode_map_node srsvm_opcode_map_node;
+#define SRSVM_OPCODE_TABLE_ABI_VERSION 2
 
-struct srsvm_opcode_map_node
+/* Module ABI v2: a module exports one of these as
+ * srsvm_opcode_table_<word size>, pointing at a const array of its
+ * opcodes. The loader indexes the array in place instead of copying it. */
+struct srsvm_opcode_table
 {
-    srsvm_opcode_map_node *name_parent;
-    srsvm_opcode_map_node *code_parent;
+    uint32_t abi_version;
 
-    srsvm_opcode *opcode;
-
-    srsvm_opcode_map_node *name_lchild;
-    srsvm_opcode_map_node *name_rchild;
-    
-    srsvm_opcode_map_node *code_lchild;
-    srsvm_opcode_map_node *code_rchild;
+    size_t count;
+    const srsvm_opcode *opcodes;
 };
 
+#define OPCODE_NS_SHIFT (WORD_SIZE - 8)
+
+#define OPCODE_NS(code) ((unsigned) (((code) >> OPCODE_NS_SHIFT) & 0xFF))
+#define OPCODE_ID(code) ((code) & ~((srsvm_word) 0xFF << OPCODE_NS_SHIFT))
+
+#define SRSVM_OPCODE_MAP_NAMESPACES 256
+#define SRSVM_OPCODE_MAP_DENSE_MAX 4096
+
+typedef struct
+{
+    srsvm_opcode **ops;
+    size_t size;
+} srsvm_opcode_map_namespace;
+
 struct srsvm_opcode_map
 {
     srsvm_lock lock;
 
-    srsvm_opcode_map_node *by_name_root;
-    srsvm_opcode_map_node *by_code_root;
+    bool borrowed;
+
+    srsvm_opcode_map_namespace by_code[SRSVM_OPCODE_MAP_NAMESPACES];
+
+    srsvm_opcode **sparse;
+    size_t num_sparse;
+
+    srsvm_opcode **by_name;
+    size_t name_capacity;
+
     size_t count;
 };
 
@@ -104,6 +134,7 @@ srsvm_opcode *opcode_lookup_by_name(const srsvm_opcode_map* map, const char* opc
 srsvm_opcode *opcode_lookup_by_code(const srsvm_opcode_map* map, const srsvm_word opcode_code);
 
 bool opcode_map_insert(srsvm_opcode_map* map, srsvm_opcode* opcode);
+bool opcode_map_insert_table(srsvm_opcode_map* map, const srsvm_opcode_table* table);
 
 typedef struct
 {
@@ -40,6 +40,11 @@ REGISTER_OPCODE(MK_OPCODE(NS_CORE,24), CJMP_FORWARD_IF, 2, 2);
 REGISTER_OPCODE(MK_OPCODE(NS_CORE,25), CJMP_BACK_ERR, 2, 2); 
 REGISTER_OPCODE(MK_OPCODE(NS_CORE,26), CJMP_FORWARD_ERR, 2, 2); 
 
+REGISTER_OPCODE(MK_OPCODE(NS_CORE,31), CALL, 1, 1);
+REGISTER_OPCODE(MK_OPCODE(NS_CORE,32), RET, 0, 0);
+REGISTER_OPCODE(MK_OPCODE(NS_CORE,33), PUSH, 1, 1);
+REGISTER_OPCODE(MK_OPCODE(NS_CORE,34), POP, 0, 1);
+
 REGISTER_OPCODE(MK_OPCODE(NS_CORE,51), REG_ID, 2, 2);
 
 REGISTER_OPCODE(MK_OPCODE(NS_CORE,71), LOAD_CONST, 2, 3);
@@ -63,6 +68,21 @@ REGISTER_OPCODE(MK_OPCODE(NS_MEM, 1), FREE, 1, 1);
 REGISTER_OPCODE(MK_OPCODE(NS_MEM,5), LOAD, 3, 4);
 REGISTER_OPCODE(MK_OPCODE(NS_MEM,6), STORE, 3, 4);
 
+REGISTER_OPCODE(MK_OPCODE(NS_MEM,8), REGION_CREATE, 2, 2);
+REGISTER_OPCODE(MK_OPCODE(NS_MEM,9), REGION_ALLOC, 3, 3);
+REGISTER_OPCODE(MK_OPCODE(NS_MEM,10), REGION_RESET, 1, 1);
+REGISTER_OPCODE(MK_OPCODE(NS_MEM,11), REGION_DESTROY, 1, 1);
+
+REGISTER_OPCODE(MK_OPCODE(NS_MEM,12), MEMCPY, 3, 3);
+REGISTER_OPCODE(MK_OPCODE(NS_MEM,13), MEMSET, 3, 3);
+REGISTER_OPCODE(MK_OPCODE(NS_MEM,14), MEMCMP, 4, 4);
+REGISTER_OPCODE(MK_OPCODE(NS_MEM,15), MEMCHR, 4, 4);
+
+REGISTER_OPCODE(MK_OPCODE(NS_MEM,16), LOAD_MULTI, 3, MAX_INSTRUCTION_ARGS);
+REGISTER_OPCODE(MK_OPCODE(NS_MEM,17), STORE_MULTI, 3, MAX_INSTRUCTION_ARGS);
+REGISTER_OPCODE(MK_OPCODE(NS_MEM,18), GATHER, 4, MAX_INSTRUCTION_ARGS);
+REGISTER_OPCODE(MK_OPCODE(NS_MEM,19), SCATTER, 4, MAX_INSTRUCTION_ARGS);
+
 REGISTER_OPCODE(MK_OPCODE(NS_MOD,1), MOD_ID, 2, 2);
 REGISTER_OPCODE(MK_OPCODE(NS_MOD,3), MOD_LOAD, 2, 2);
 REGISTER_OPCODE(MK_OPCODE(NS_MOD,4), MOD_UNLOAD, 1, 1);
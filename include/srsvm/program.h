@@ -5,12 +5,15 @@
 #endif
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+#include "srsvm/impl.h"
+
 #if defined(WORD_SIZE)
 #include "srsvm/constant.h" 
-#include "srsvm/impl.h"
 #include "srsvm/memory.h"
+#include "srsvm/module.h"
 #include "srsvm/register.h"
 #include "srsvm/word.h"
 #endif
@@ -29,6 +32,83 @@ typedef struct
 
 } srsvm_program_metadata;
 
+/* Version 2 files start with a fixed header (SRSVM_PROGRAM_MAGIC_V2, word
+ * size, version, section count, section table offset and entry point),
+ * followed by a table describing each section and then the section
+ * payloads, each aligned to SRSVM_PROGRAM_SECTION_ALIGN bytes. Every
+ * literal memory segment gets a section of its own, so that it can be
+ * located without parsing the rest of the file. Version 1 files are the
+ * same lists written back to back. */
+
+#define SRSVM_PROGRAM_MAGIC "SRS"
+#define SRSVM_PROGRAM_MAGIC_V2 "SR2"
+
+#define SRSVM_PROGRAM_FORMAT_VERSION 2
+
+#define SRSVM_PROGRAM_HEADER_SIZE 32
+#define SRSVM_PROGRAM_SECTION_ENTRY_SIZE 52
+#define SRSVM_PROGRAM_SECTION_ALIGN 16
+
+#define SRSVM_SECTION_REGISTERS 1
+#define SRSVM_SECTION_VMEM 2
+#define SRSVM_SECTION_LMEM 3
+#define SRSVM_SECTION_CONSTANTS 4
+
+/* The names of the modules the program calls into, one record (uint16_t
+ * length, then the name and its terminator) per module. Only written when
+ * the program uses modules. */
+#define SRSVM_SECTION_MODULES 5
+
+#define SRSVM_SECTION_COMPRESSED 0x01
+#define SRSVM_SECTION_READABLE 0x02
+#define SRSVM_SECTION_WRITABLE 0x04
+#define SRSVM_SECTION_EXECUTABLE 0x08
+#define SRSVM_SECTION_LOCKED 0x10
+#define SRSVM_SECTION_CHUNKED 0x20
+
+/* The SRSVM_CODEC_* used by a compressed section. */
+#define SRSVM_SECTION_CODEC_MASK 0x0F00
+#define SRSVM_SECTION_CODEC_SHIFT 8
+
+/* Compressed literal memory is written as independently compressed chunks
+ * of this many bytes: the payload starts with the chunk size and count
+ * (two uint32_t) and the offset of each chunk and of the end of the last
+ * one (uint64_t, from the start of the payload). */
+#define SRSVM_PROGRAM_CHUNK_SIZE 65536
+
+typedef struct
+{
+    uint16_t type;
+    uint16_t flags;
+
+    /* Number of records in the section; 1 for literal memory. */
+    uint32_t count;
+
+    /* Absolute file offset and stored size of the payload, and its size
+     * once decompressed. */
+    uint64_t offset;
+    uint64_t size;
+    uint64_t original_size;
+
+    /* CRC-32 of the stored payload. */
+    uint32_t checksum;
+
+    /* Start address of a literal memory segment, as a word. */
+    uint8_t address[16];
+} srsvm_program_section;
+
+/* The contents of a program file, mapped copy-on-write where possible and
+ * shared by the program and any VM whose segments are backed by it. */
+typedef struct
+{
+    char *data;
+    size_t size;
+
+    bool mapped;
+
+    srsvm_atomic_counter refs;
+} srsvm_program_file;
+
 #if defined(WORD_SIZE)
 typedef struct srsvm_register_specification srsvm_register_specification;
 
@@ -60,6 +140,7 @@ struct srsvm_literal_memory_specification
 
     bool is_compressed;
     size_t compressed_size;
+    uint8_t codec;
 
     bool readable;
     bool writable;
@@ -68,6 +149,20 @@ struct srsvm_literal_memory_specification
     bool locked;
 
     void *data;
+    bool file_backed;
+
+    /* CRC-32 of the compressed_size stored bytes at data, from the section
+     * table. It is not checked at load: compressed data is checked when it
+     * is first inflated, and data used in place only on request. */
+    bool has_checksum;
+    uint32_t checksum;
+
+    /* Compressed data is left for the MMU to inflate on first touch: data
+     * then points at the compressed chunks in the program file. */
+    bool deferred;
+    size_t chunk_size;
+    size_t num_chunks;
+    size_t *chunk_offsets;
     
     srsvm_literal_memory_specification *next;
 };
@@ -83,12 +178,33 @@ struct srsvm_constant_specification
     srsvm_constant_specification *next;
 };
 
+typedef struct srsvm_module_specification srsvm_module_specification;
+
+struct srsvm_module_specification
+{
+    uint16_t name_len;
+    char name[SRSVM_MODULE_MAX_NAME_LEN];
+
+    srsvm_module_specification *next;
+};
+
 #endif
 
 typedef struct
 {
     srsvm_program_metadata *metadata;
 
+    srsvm_program_file *file;
+
+    /* 0 when writing means the current version. */
+    uint16_t format_version;
+
+    /* Codec for compressed sections; version 1 files only use zlib. */
+    uint8_t codec;
+
+    uint16_t num_sections;
+    srsvm_program_section *sections;
+
 #if defined(WORD_SIZE)
     uint16_t num_registers;
     srsvm_register_specification *registers;
@@ -104,6 +220,9 @@ typedef struct
     size_t constants_compressed_size;
 
     srsvm_constant_specification *constants;
+
+    uint16_t num_modules;
+    srsvm_module_specification *modules;
 #endif
 } srsvm_program;
 
@@ -115,17 +234,28 @@ srsvm_program_metadata* srsvm_program_metadata_alloc(void);
 void srsvm_program_free_metadata(srsvm_program_metadata* metadata);
 
 srsvm_program *srsvm_program_deserialize(const char* program_path);
+
+const srsvm_program_section *srsvm_program_find_section(const srsvm_program *program, const uint16_t type, const uint16_t index);
+
+srsvm_program_file *srsvm_program_file_acquire(srsvm_program_file *file);
+void srsvm_program_file_release(srsvm_program_file *file);
 #if defined(WORD_SIZE)
 bool srsvm_program_serialize(const char* output_path, const srsvm_program* program);
 
+/* Checks a literal memory segment's stored data against its section
+ * checksum; segments without one always pass. */
+bool srsvm_program_lmem_verify(const srsvm_literal_memory_specification *lmem);
+
 void srsvm_program_free_register(srsvm_register_specification *reg);
 void srsvm_program_free_vmem(srsvm_virtual_memory_specification *vmem);
 void srsvm_program_free_lmem(srsvm_literal_memory_specification *lmem);
 void srsvm_program_free_const(srsvm_constant_specification *c);
+void srsvm_program_free_module(srsvm_module_specification *mod);
 
 srsvm_register_specification* srsvm_program_register_alloc(void);
 srsvm_virtual_memory_specification* srsvm_program_vmem_alloc(void);
 srsvm_literal_memory_specification* srsvm_program_lmem_alloc(void);
 srsvm_constant_specification* srsvm_program_const_alloc(void);
+srsvm_module_specification* srsvm_program_module_alloc(void);
 
 #endif
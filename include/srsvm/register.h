@@ -1,12 +1,17 @@
 #pragma once
 
 #include <stdbool.h>
+#include <string.h>
 
+#include "srsvm/impl.h"
 #include "srsvm/memory.h"
 #include "srsvm/word.h"
 
 #define SRSVM_REGISTER_MAX_COUNT (8 * WORD_SIZE)
 #define SRSVM_REGISTER_MAX_NAME_LEN 256
+#define SRSVM_REGISTER_ERROR_STR_LEN 1024
+#define SRSVM_REGISTER_FILE_ALIGNMENT 64
+#define SRSVM_REGISTER_SHARED_PREFIX "$$"
 
 typedef struct
 {
@@ -80,23 +85,134 @@ typedef struct
     size_t str_len;
 } srsvm_register_contents;
 
-typedef struct
+typedef enum
 {
-    srsvm_word index;
+    SRSVM_REGISTER_ERROR_NONE = 0,
+
+    SRSVM_REGISTER_ERROR_ALLOC,
+    SRSVM_REGISTER_ERROR_COPY_ADDRESS,
+    SRSVM_REGISTER_ERROR_COPY_RESULT,
+    SRSVM_REGISTER_ERROR_COPY_MODULE_ID,
+    SRSVM_REGISTER_ERROR_REGION_EXHAUSTED,
+    SRSVM_REGISTER_ERROR_BYTE_NOT_FOUND,
+    SRSVM_REGISTER_ERROR_MODULE_LOAD,
+    SRSVM_REGISTER_ERROR_REGISTER_LOOKUP, /* arg: register name */
+    SRSVM_REGISTER_ERROR_MODULE_LOOKUP, /* arg: module name */
+    SRSVM_REGISTER_ERROR_JOINED_THREAD, /* arg: fault text of the joined thread */
+    SRSVM_REGISTER_ERROR_MUTEX_INIT,
+    SRSVM_REGISTER_ERROR_PARSE_NULL,
+    SRSVM_REGISTER_ERROR_PARSE, /* arg: type name */
+    SRSVM_REGISTER_ERROR_SERIALIZE, /* arg: type name */
+
+    SRSVM_REGISTER_ERROR_COUNT
+} srsvm_register_error;
 
+typedef struct
+{
     char name[SRSVM_REGISTER_MAX_NAME_LEN];
 
-    bool read_only;
-    
-    bool locked;
+    srsvm_register_error error_code;
 
-    bool error_flag;
-    char error_str[1024];
+    /* argument of error_code, allocated the first time a register takes an
+     * error that has one */
+    char *error_arg;
+} srsvm_register_cold;
 
-    bool fault_on_error;
+typedef struct
+{
+    bool allocated : 1;
+    bool shared : 1;
+    bool read_only : 1;
+    bool locked : 1;
+    bool error_flag : 1;
+    bool fault_on_error : 1;
+} srsvm_register_flags;
 
+typedef struct
+{
     srsvm_register_contents value;
+
+    srsvm_word index;
+
+    srsvm_register_flags *flags;
+
+    srsvm_atomic_counter *pending_faults;
+
+    srsvm_register_cold *cold;
 } srsvm_register;
 
-srsvm_register *srsvm_register_alloc(const char* name, const srsvm_word index);
+typedef struct
+{
+    srsvm_register *slots;
+    srsvm_register_flags *flags;
+    srsvm_register_cold *cold;
+} srsvm_register_file;
+
+srsvm_register_file *srsvm_register_file_alloc(void);
+srsvm_register_file *srsvm_register_file_alloc_context(const srsvm_register_file *program_file, srsvm_atomic_counter *pending_faults);
+void srsvm_register_file_free(srsvm_register_file *file);
+
+srsvm_register *srsvm_register_alloc(srsvm_register_file *file, const char* name, const srsvm_word index);
 void srsvm_register_free(srsvm_register *reg);
+
+bool srsvm_register_set_error(srsvm_register *reg, const srsvm_register_error code, const char *arg);
+size_t srsvm_register_format_error(const srsvm_register *reg, char *buf, const size_t buf_len);
+
+static inline srsvm_register *srsvm_register_file_lookup(const srsvm_register_file *file, const srsvm_word index)
+{
+    if(index < SRSVM_REGISTER_MAX_COUNT && file->flags[index].allocated){
+        return &file->slots[index];
+    } else {
+        return NULL;
+    }
+}
+
+static inline srsvm_register *srsvm_register_context_lookup(const srsvm_register_file *context, const srsvm_register_file *shared, const srsvm_word index)
+{
+    if(index < SRSVM_REGISTER_MAX_COUNT){
+        const srsvm_register_file *file = context->flags[index].shared ? shared : context;
+
+        if(file->flags[index].allocated){
+            return &file->slots[index];
+        }
+    }
+
+    return NULL;
+}
+
+static inline bool srsvm_register_name_is_shared(const char *name)
+{
+    return strncmp(name, SRSVM_REGISTER_SHARED_PREFIX, sizeof(SRSVM_REGISTER_SHARED_PREFIX) - 1) == 0;
+}
+
+static inline const char *srsvm_register_name(const srsvm_register *reg)
+{
+    return reg->cold->name;
+}
+
+static inline void srsvm_register_set_fault_state(srsvm_register *reg, const bool error_flag, const bool fault_on_error)
+{
+    bool was_pending = reg->flags->error_flag && reg->flags->fault_on_error;
+    bool is_pending = error_flag && fault_on_error;
+
+    reg->flags->error_flag = error_flag;
+    reg->flags->fault_on_error = fault_on_error;
+
+    if(reg->pending_faults != NULL && was_pending != is_pending){
+        if(is_pending){
+            srsvm_atomic_increment(reg->pending_faults);
+        } else {
+            srsvm_atomic_decrement(reg->pending_faults);
+        }
+    }
+}
+
+static inline void srsvm_register_set_error_flag(srsvm_register *reg, const bool error_flag)
+{
+    srsvm_register_set_fault_state(reg, error_flag, reg->flags->fault_on_error);
+}
+
+static inline void srsvm_register_set_fault_on_error(srsvm_register *reg, const bool fault_on_error)
+{
+    srsvm_register_set_fault_state(reg, reg->flags->error_flag, fault_on_error);
+}
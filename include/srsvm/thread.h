@@ -1,39 +1,60 @@
 #pragma once
 
 #include "srsvm/forward-decls.h"
+#include "srsvm/heap.h"
 #include "srsvm/impl.h"
 #include "srsvm/register.h"
+#include "srsvm/tlb.h"
 
 #define SRSVM_THREAD_MAX_COUNT (4 * WORD_SIZE)
 
-typedef struct srsvm_spilled_register srsvm_spilled_register;
+#define SRSVM_CALL_STACK_INITIAL_FRAMES 64
+#define SRSVM_CALL_STACK_INITIAL_SPILLS 64
+#define SRSVM_CALL_STACK_INITIAL_SPILL_BYTES 1024
 
-struct srsvm_spilled_register
+#define SRSVM_SPILL_NO_BYTES SIZE_MAX
+
+typedef struct
 {
     srsvm_word index;
-    srsvm_register reg;
 
-    srsvm_spilled_register *last;
-    srsvm_spilled_register *next;
-};
+    bool error_flag;
+    bool fault_on_error;
 
-typedef struct srsvm_stack_frame srsvm_stack_frame;
+    srsvm_register_error error_code;
 
-struct srsvm_stack_frame
-{
-    srsvm_ptr next_PC;
+    /* offsets into the call stack's spill bytes, or SRSVM_SPILL_NO_BYTES;
+     * value.str is always NULL while the register is spilled */
+    size_t str_offset;
+    size_t error_arg_offset;
 
-    srsvm_spilled_register *spilled;
-    srsvm_spilled_register *last_spilled;
+    /* spill bytes in use before this spill was pushed */
+    size_t bytes_base;
 
-    srsvm_stack_frame *next;
-    srsvm_stack_frame *last;
-};
+    srsvm_register_contents value;
+} srsvm_spilled_register;
+
+typedef struct
+{
+    srsvm_ptr return_PC;
+
+    size_t spill_base;
+} srsvm_stack_frame;
 
 typedef struct
 {
-   srsvm_stack_frame *frames;
-   srsvm_stack_frame *top;
+    srsvm_stack_frame *frames;
+    size_t depth;
+    size_t frame_capacity;
+
+    srsvm_spilled_register *spills;
+    size_t num_spills;
+    size_t spill_capacity;
+
+    /* string and error bytes of the spills, released with them */
+    char *spill_bytes;
+    size_t spill_bytes_used;
+    size_t spill_bytes_capacity;
 } srsvm_call_stack;
 
 typedef void (*srsvm_thread_fault_handler)(srsvm_vm*, srsvm_thread*);
@@ -52,6 +73,16 @@ struct srsvm_thread
 
     srsvm_call_stack call_stack;
 
+    srsvm_register_file *registers;
+    srsvm_atomic_counter pending_register_faults;
+
+    srsvm_tlb tlb;
+
+    /* keeps the decode table the thread is running from alive */
+    srsvm_mmu_reader decode_reader;
+
+    srsvm_heap_cache heap_cache;
+
     srsvm_ptr PC;
 
     srsvm_ptr next_PC;
@@ -76,7 +107,7 @@ srsvm_thread *srsvm_thread_alloc(srsvm_vm *vm, srsvm_word id, srsvm_ptr start_ad
 void srsvm_thread_free(srsvm_vm *vm, srsvm_thread* thread);
 
 bool srsvm_push(srsvm_vm *vm, srsvm_thread *thread, const srsvm_register *reg);
-bool srsvm_pop(srsvm_vm *vm, srsvm_thread *thread);
+bool srsvm_pop(srsvm_vm *vm, srsvm_thread *thread, srsvm_register *dest);
 
 bool srsvm_call(srsvm_vm *vm, srsvm_thread *thread, const srsvm_ptr addr);
 bool srsvm_ret(srsvm_vm *vm, srsvm_thread *thread);
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "srsvm/forward-decls.h"
+#include "srsvm/impl.h"
+#include "srsvm/memory.h"
+#include "srsvm/mmu.h"
+#include "srsvm/word.h"
+
+#define SRSVM_TLB_ENTRIES 8
+
+typedef struct
+{
+    srsvm_memory_segment *segment;
+
+    srsvm_ptr base;
+    srsvm_word size;
+} srsvm_tlb_entry;
+
+typedef struct
+{
+    srsvm_tlb_entry entries[SRSVM_TLB_ENTRIES];
+    unsigned next_victim;
+
+    unsigned generation;
+
+    srsvm_memory_segment *root_segment;
+    srsvm_mmu_reader reader;
+
+    srsvm_flat_memory *flat;
+
+    unsigned long hits;
+    unsigned long misses;
+} srsvm_tlb;
+
+void srsvm_tlb_init(srsvm_tlb *tlb, srsvm_memory_segment *root_segment);
+void srsvm_tlb_release(srsvm_tlb *tlb);
+
+void srsvm_tlb_flush(srsvm_tlb *tlb);
+
+static inline void srsvm_tlb_read_begin(srsvm_tlb *tlb)
+{
+    srsvm_mmu_read_begin(tlb->root_segment, &tlb->reader);
+}
+
+static inline void srsvm_tlb_read_end(srsvm_tlb *tlb)
+{
+    srsvm_mmu_read_end(&tlb->reader);
+}
+
+/* The returned segment stays valid until the enclosing read section ends. */
+srsvm_memory_segment *srsvm_tlb_locate(srsvm_tlb *tlb, const srsvm_ptr address);
+
+bool srsvm_tlb_load(srsvm_tlb *tlb, const srsvm_ptr address, const srsvm_word bytes, void* dest);
+bool srsvm_tlb_store(srsvm_tlb *tlb, const srsvm_ptr address, const srsvm_word bytes, void* src);
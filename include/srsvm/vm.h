@@ -4,6 +4,7 @@
 
 #include "srsvm/constant.h"
 #include "srsvm/forward-decls.h"
+#include "srsvm/heap.h"
 #include "srsvm/map.h"
 #include "srsvm/memory.h"
 #include "srsvm/module.h"
@@ -14,6 +15,12 @@
 
 typedef void(*srsvm_vm_fault_handler)(srsvm_vm *vm);
 
+typedef enum
+{
+    SRSVM_ENGINE_CALL,
+    SRSVM_ENGINE_THREADED,
+} srsvm_vm_engine;
+
 struct srsvm_vm
 {
     srsvm_opcode_map *opcode_map;
@@ -21,14 +28,29 @@ struct srsvm_vm
     srsvm_string_map *register_map;
  
     srsvm_memory_segment *mem_root;
+    srsvm_heap *heap;
+    srsvm_decode_cache *decode_caches;
+
+    srsvm_program_file *program_file;
 
-    srsvm_register *registers[SRSVM_REGISTER_MAX_COUNT];
+    srsvm_register_file *registers;
 
     srsvm_thread *threads[SRSVM_THREAD_MAX_COUNT];
 
     srsvm_module *modules[SRSVM_MODULE_MAX_COUNT];
+
+    /* Bumped whenever a module is unloaded, which invalidates every MOD_OP
+     * call site bound to an opcode. */
+    srsvm_atomic_counter module_generation;
     char** module_search_path;
 
+    /* Modules listed by the program that were loaded ahead of time and are
+     * waiting for their first MOD_LOAD. */
+    srsvm_string_map *preloaded_modules;
+
+    /* Where each module was last found; see srsvm_module_path_cache. */
+    srsvm_module_path_cache *module_path_cache;
+
     srsvm_constant_value *constants[SRSVM_CONST_MAX_COUNT];
 
     bool has_program_loaded;
@@ -38,10 +60,22 @@ struct srsvm_vm
     bool has_fault;
     char fault_str[1024];
 
+    srsvm_atomic_counter pending_register_faults;
+
     const char** argv;
     int argc;
 
     srsvm_vm_fault_handler fault_handler;
+
+    srsvm_vm_engine engine;
+
+    /* Inflate compressed program memory while loading instead of on first
+     * touch. */
+    bool preload_memory;
+
+    /* Check literal memory that is used in place against its section
+     * checksum while loading. */
+    bool verify_memory;
 };
 
 srsvm_vm *srsvm_vm_alloc(void);
@@ -55,12 +89,28 @@ srsvm_register *srsvm_vm_register_alloc(srsvm_vm *vm, const char* name, const sr
 
 bool srsvm_vm_execute_instruction(srsvm_vm *vm, srsvm_thread *thread, const srsvm_instruction *instruction);
 
+srsvm_decode_cache *srsvm_vm_decode_cache(srsvm_vm *vm, const srsvm_ptr addr);
+
+bool srsvm_vm_raise_register_fault(srsvm_vm *vm, srsvm_thread *thread);
+
+static inline bool srsvm_vm_check_register_faults(srsvm_vm *vm, srsvm_thread *thread)
+{
+    if(srsvm_atomic_load(&vm->pending_register_faults) != 0 || srsvm_atomic_load(&thread->pending_register_faults) != 0){
+        return srsvm_vm_raise_register_fault(vm, thread);
+    }
+
+    return vm->has_fault;
+}
+
 srsvm_thread *srsvm_vm_alloc_thread(srsvm_vm *vm, const srsvm_ptr start_addr, const srsvm_ptr start_arg);
 void srsvm_vm_thread_exit(srsvm_vm *vm, srsvm_thread *thread, srsvm_thread_exit_info *info);
 bool srsvm_vm_start_thread(srsvm_vm *vm, const srsvm_word thread_id);
 bool srsvm_vm_join_thread(srsvm_vm *vm, const srsvm_word thread_id);
 
+#define SRSVM_VM_MAX_PRELOAD_THREADS 16
+
 void srsvm_vm_set_module_search_path(srsvm_vm *vm, const char* search_path);
+void srsvm_vm_preload_modules(srsvm_vm *vm, const srsvm_program *program);
 srsvm_module *srsvm_vm_load_module(srsvm_vm *vm, const char* module_name);
 srsvm_module *srsvm_vm_load_module_slot(srsvm_vm *vm, const char* module_name, const srsvm_word slot_num);
 void srsvm_vm_unload_module(srsvm_vm *vm, srsvm_module *mod);
@@ -98,3 +148,8 @@ bool srsvm_vm_load_const(srsvm_vm *vm, srsvm_register *dest_reg, const srsvm_wor
 void srsvm_vm_set_argv(srsvm_vm *vm, const char** argv, const int argc);
 
 void srsvm_vm_set_fault_handler(srsvm_vm *vm, srsvm_vm_fault_handler fault_handler);
+
+bool srsvm_vm_set_engine_name(srsvm_vm *vm, const char* engine_name);
+bool srsvm_vm_set_memory_name(srsvm_vm *vm, const char* memory_name);
+void srsvm_vm_set_preload_memory(srsvm_vm *vm, const bool preload_memory);
+void srsvm_vm_set_verify_memory(srsvm_vm *vm, const bool verify_memory);
@@ -18,6 +18,7 @@ void thread_fault_handler(srsvm_vm *vm, srsvm_thread *thread)
 {
 	if(thread->has_fault){
 		fprintf(stderr, "Thread " PRINT_WORD_HEX " has encountered a fault: %s\n", PRINTF_WORD_PARAM(thread->id), thread->fault_str);
+		thread->exit_status = 1;
 	}
 }
 
@@ -44,6 +45,10 @@ void show_usage(const char* error)
     fprintf(stderr, "    optional arguments:\n");
     fprintf(stderr, "\n");
     fprintf(stderr, "      -d  |  --debug        : enable srsvm debug messages\n");
+    fprintf(stderr, "      -e <engine>           : select the execution engine: threaded (default) or call\n");
+    fprintf(stderr, "      -m <memory>           : select the guest memory layout: segmented (default) or flat\n");
+    fprintf(stderr, "      -p  |  --preload      : inflate compressed program memory at load time, on all cores\n");
+    fprintf(stderr, "      -V  |  --verify       : check uncompressed program memory against its checksums at load time\n");
     fprintf(stderr, "      -h  |  --help         : show this help information\n");
 
     if(error != NULL){
@@ -59,6 +64,10 @@ int main(int argc, char* argv[]){
     char err_buf[1024] = { 0 };
     
     char* program_name = NULL;
+    char* engine_name = NULL;
+    char* memory_name = NULL;
+    bool preload_memory = false;
+    bool verify_memory = false;
 
     bool sys_opts_done = false;
 
@@ -77,6 +86,34 @@ int main(int argc, char* argv[]){
                     } else {
                         srsvm_debug_mode = true;
                     }
+                } else if(strcmp(argv[i], "-e") == 0 || strcmp(argv[i], "--engine") == 0){
+                    if(engine_name != NULL){
+                        show_usage("engine flag may only be specified once");
+                    } else if(i >= argc - 1){
+                        show_usage("engine flag specified with no argument");
+                    } else {
+                        engine_name = argv[++i];
+                    }
+                } else if(strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--memory") == 0){
+                    if(memory_name != NULL){
+                        show_usage("memory flag may only be specified once");
+                    } else if(i >= argc - 1){
+                        show_usage("memory flag specified with no argument");
+                    } else {
+                        memory_name = argv[++i];
+                    }
+                } else if(strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--preload") == 0){
+                    if(preload_memory){
+                        show_usage("preload flag may only be specified once");
+                    } else {
+                        preload_memory = true;
+                    }
+                } else if(strcmp(argv[i], "-V") == 0 || strcmp(argv[i], "--verify") == 0){
+                    if(verify_memory){
+                        show_usage("verify flag may only be specified once");
+                    } else {
+                        verify_memory = true;
+                    }
                 } else if(strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0){
                     show_usage(NULL);
                 } else if(strcmp(argv[i], "--") == 0){
@@ -125,7 +162,24 @@ int main(int argc, char* argv[]){
 
         exit_status = 1;
         goto cleanup;
-    } else if((program = srsvm_program_deserialize(program_name)) == NULL){
+    } else if(engine_name != NULL && ! srsvm_vm_set_engine_name(vm, engine_name)){
+        snprintf(err_buf, sizeof(err_buf), "unknown execution engine '%s'", engine_name);
+        write_error(err_buf);
+
+        exit_status = 1;
+        goto cleanup;
+    } else if(memory_name != NULL && ! srsvm_vm_set_memory_name(vm, memory_name)){
+        snprintf(err_buf, sizeof(err_buf), "unknown or unsupported memory layout '%s'", memory_name);
+        write_error(err_buf);
+
+        exit_status = 1;
+        goto cleanup;
+    }
+
+    srsvm_vm_set_preload_memory(vm, preload_memory);
+    srsvm_vm_set_verify_memory(vm, verify_memory);
+
+    if((program = srsvm_program_deserialize(program_name)) == NULL){
         snprintf(err_buf, sizeof(err_buf), "failed to deserialize program '%s'", program_name);
         write_error(err_buf);
 
@@ -145,6 +199,8 @@ int main(int argc, char* argv[]){
 
     srsvm_vm_set_module_search_path(vm, mod_path);
 
+    srsvm_vm_preload_modules(vm, program);
+
     main_thread = vm->main_thread;
 
     srsvm_thread_set_fault_handler_native(main_thread, thread_fault_handler);
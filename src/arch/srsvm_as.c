@@ -31,6 +31,9 @@ void show_usage(const char* error)
     fprintf(stderr, "      -o output_file.svm    : specify output filename\n");
     fprintf(stderr, "      -A <alignment>        : specify target output alignment (default: 0)\n");
     fprintf(stderr, "      -L <mod_search_path>  : specify module search path (semicolon separated)\n");
+    fprintf(stderr, "      -U  |  --uncompressed : store program memory uncompressed, so it can be mapped at load time\n");
+    fprintf(stderr, "      -F <version>          : specify output file format version (1/2, default: 2)\n");
+    fprintf(stderr, "      -C <codec>            : compress program memory with zlib, lz4 or zstd (default: zlib)\n");
     fprintf(stderr, "      -D  |  --debug        : enable srsvm debug messages\n");
     fprintf(stderr, "      -h  |  --help         : show this help information\n");
 
@@ -104,6 +107,13 @@ int main(int argc, char *argv[]){
 
     unsigned word_size = 0;
 
+    bool uncompressed = false;
+
+    unsigned format_version = 0;
+
+    const char *codec_name = NULL;
+    unsigned codec = SRSVM_CODEC_ZLIB;
+
     for(int arg_i = 1; arg_i < argc; arg_i++){
         char* arg = argv[arg_i];
 
@@ -161,6 +171,41 @@ int main(int argc, char *argv[]){
                 } else {
                     srsvm_debug_mode = true;
                 }
+            } else if(strcmp(arg, "-U") == 0 || strcmp(arg, "--uncompressed") == 0){
+                uncompressed = true;
+            } else if(strcmp(arg, "-F") == 0){
+                if(format_version != 0){
+                    show_usage("Error: duplicate -F argument\n");
+                } else if(arg_i >= argc - 1){
+                    show_usage("Error: -F specified with no argument\n");
+                } else if(sscanf(argv[++arg_i], "%u", &format_version) != 1 || format_version < 1 || format_version > SRSVM_PROGRAM_FORMAT_VERSION){
+                    fprintf(stderr, "Error: unsupported format version '%s'\n", argv[arg_i]);
+                    return 1;
+                }
+            } else if(strcmp(arg, "-C") == 0){
+                if(codec_name != NULL){
+                    show_usage("Error: duplicate -C argument\n");
+                } else if(arg_i >= argc - 1){
+                    show_usage("Error: -C specified with no argument\n");
+                }
+
+                codec_name = argv[++arg_i];
+
+                if(srsvm_strcasecmp(codec_name, "zlib") == 0){
+                    codec = SRSVM_CODEC_ZLIB;
+                } else if(srsvm_strcasecmp(codec_name, "lz4") == 0){
+                    codec = SRSVM_CODEC_LZ4;
+                } else if(srsvm_strcasecmp(codec_name, "zstd") == 0){
+                    codec = SRSVM_CODEC_ZSTD;
+                } else {
+                    fprintf(stderr, "Error: unknown codec '%s'\n", codec_name);
+                    return 1;
+                }
+
+                if(! srsvm_codec_supported(codec)){
+                    fprintf(stderr, "Error: codec '%s' is not available\n", codec_name);
+                    return 1;
+                }
             } else if(strcmp(arg, "-o") == 0){
                 if(output_filename != NULL){
                     show_usage("Error: duplicate -o argument\n");
@@ -212,6 +257,11 @@ int main(int argc, char *argv[]){
         return 1;
     }
 
+    if(format_version == 1 && codec != SRSVM_CODEC_ZLIB){
+        fprintf(stderr, "Error: format version 1 only supports zlib compression\n");
+        return 1;
+    }
+
     if(output_filename == NULL){
         if(strcmp(input_files[0], "-") == 0){
             output_filename = srsvm_strdup("out.svm");
@@ -246,6 +296,8 @@ int main(int argc, char *argv[]){
 
 	srsvm_asm_program_set_search_path(asm_prog, (const char**) module_search_path);
 
+    srsvm_asm_program_set_compression(asm_prog, ! uncompressed);
+
     bool have_fatal_error = false;
 
     for(size_t input_num = 0; input_num < num_input_files; input_num++){
@@ -295,7 +347,12 @@ int main(int argc, char *argv[]){
 
         srsvm_program *program = srsvm_asm_emit(asm_prog, 0x1000, (srsvm_word) word_alignment);
 
-        if(! srsvm_program_serialize(output_filename, program)){
+        if(program != NULL){
+            program->format_version = (uint16_t) format_version;
+            program->codec = (uint8_t) codec;
+        }
+
+        if(program == NULL || ! srsvm_program_serialize(output_filename, program)){
             fprintf(stderr, "Failed to serialize to %s\n", output_filename);
         } else {
             printf("Serialized to %s\n", output_filename);
@@ -48,6 +48,8 @@ void show_usage(const char* error)
 	fprintf(stderr, "      -A <alignment>        : specify target output alignment (default: 0)\n");
 	fprintf(stderr, "      -L <mod_search_path>  : specify module search path (semicolon separated)\n");
 	fprintf(stderr, "      -D  |  --debug        : enable srsvm debug messages\n");
+	fprintf(stderr, "      -e <engine>           : select the execution engine: threaded (default) or call\n");
+	fprintf(stderr, "      -m <memory>           : select the guest memory layout: segmented (default) or flat\n");
 	fprintf(stderr, "      -h  |  --help         : show this help information\n");
 
 	if(error != NULL){
@@ -118,6 +120,9 @@ int main(int argc, char *argv[]){
 	char ** module_search_path = NULL;
 	char *vm_mod_path = NULL;
 
+	char *engine_name = NULL;
+	char *memory_name = NULL;
+
 	unsigned word_alignment = 0;
 	bool alignment_specified = false;
 
@@ -187,6 +192,22 @@ int main(int argc, char *argv[]){
 				} else {
 					srsvm_debug_mode = true;
 				}
+			} else if(strcmp(arg, "-e") == 0 || strcmp(arg, "--engine") == 0){
+				if(engine_name != NULL){
+					show_usage("Error: duplicate -e argument\n");
+				} else if(arg_i >= argc - 1){
+					show_usage("Error: -e specified with no argument\n");
+				} else {
+					engine_name = argv[++arg_i];
+				}
+			} else if(strcmp(arg, "-m") == 0 || strcmp(arg, "--memory") == 0){
+				if(memory_name != NULL){
+					show_usage("Error: duplicate -m argument\n");
+				} else if(arg_i >= argc - 1){
+					show_usage("Error: -m specified with no argument\n");
+				} else {
+					memory_name = argv[++arg_i];
+				}
 			} else if(strcmp(arg, "-o") == 0){
 				if(output_filename != NULL){
 					show_usage("Error: duplicate -o argument\n");
@@ -323,6 +344,18 @@ int main(int argc, char *argv[]){
 			if((vm = srsvm_vm_alloc()) == NULL){
 				write_error("failed to allocate memory for virtual machine");
 
+				exit_status = 1;
+				goto cleanup;
+			} else if(engine_name != NULL && ! srsvm_vm_set_engine_name(vm, engine_name)){
+				snprintf(err_buf, sizeof(err_buf), "unknown execution engine '%s'", engine_name);
+				write_error(err_buf);
+
+				exit_status = 1;
+				goto cleanup;
+			} else if(memory_name != NULL && ! srsvm_vm_set_memory_name(vm, memory_name)){
+				snprintf(err_buf, sizeof(err_buf), "unknown or unsupported memory layout '%s'", memory_name);
+				write_error(err_buf);
+
 				exit_status = 1;
 				goto cleanup;
 			} else if(program == NULL){
@@ -343,6 +376,8 @@ int main(int argc, char *argv[]){
 
 			srsvm_vm_set_module_search_path(vm, vm_mod_path);
 
+			srsvm_vm_preload_modules(vm, program);
+
 			main_thread = vm->main_thread;
 
 			srsvm_thread_set_fault_handler_native(main_thread, thread_fault_handler);
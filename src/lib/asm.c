@@ -103,6 +103,7 @@ srsvm_assembly_program *srsvm_asm_program_alloc(srsvm_assembler_message_report_f
     LOAD_BUILTIN(CJMP_BACK_IF);
     LOAD_BUILTIN(CJMP_BACK_ERR);
     LOAD_BUILTIN(THREAD_START);
+    LOAD_BUILTIN(CALL);
 #undef xstr
 #undef str
 #undef LOAD_BUILTIN
@@ -881,9 +882,9 @@ bool srsvm_asm_line_parse(srsvm_assembly_program *program, const char* line_str,
 				char *mod_filename = NULL;
 
 search_again:
-				mod_filename = srsvm_module_find(module, NULL, program->module_search_path, search_multilib);
-
-				if(mod_filename == NULL){
+				if(srsvm_module_is_builtin(module)){
+					mod = srsvm_module_alloc_builtin(module, program->mod_map->count);
+				} else if((mod_filename = srsvm_module_find(module, NULL, program->module_search_path, search_multilib)) == NULL){
 					ERR_fmt("failed to locate module '%s'", module);
 				} else {
 					mod = srsvm_module_alloc(module, mod_filename, program->mod_map->count);
@@ -891,28 +892,28 @@ search_again:
 					if(mod == NULL){
 						ERR_fmt("failed to load module file '%s'", mod_filename);
 					}
+				}
 
-					if(mod != NULL){
-						if((mod->tag = malloc(sizeof(asm_mod_tag))) == NULL){
-							ERR_fmt("failed to allocate module tag: %s", strerror(errno));
-						} else {
-							((asm_mod_tag*) mod->tag)->is_loaded = false;
-							((asm_mod_tag*) mod->tag)->program = program;
-						}
+				if(mod != NULL){
+					if((mod->tag = malloc(sizeof(asm_mod_tag))) == NULL){
+						ERR_fmt("failed to allocate module tag: %s", strerror(errno));
+					} else {
+						((asm_mod_tag*) mod->tag)->is_loaded = false;
+						((asm_mod_tag*) mod->tag)->program = program;
+					}
 
-						mod->ref_count = 1;
+					mod->ref_count = 1;
 
-						if(! srsvm_string_map_insert(program->mod_map, module, mod)){
-							srsvm_module_free(mod);
-							mod = NULL;
+					if(! srsvm_string_map_insert(program->mod_map, module, mod)){
+						srsvm_module_free(mod);
+						mod = NULL;
 
-							goto error_cleanup;
-						}
-					} else if(search_multilib && (mod_filename == NULL || mod == NULL)){
-						search_multilib = false;
-
-						goto search_again;
+						goto error_cleanup;
 					}
+				} else if(search_multilib && mod_filename != NULL){
+					search_multilib = false;
+
+					goto search_again;
 				}
 
 				if(mod == NULL){
@@ -1117,6 +1118,13 @@ void srsvm_asm_program_set_search_path(srsvm_assembly_program *program, const ch
 	}
 }
 
+void srsvm_asm_program_set_compression(srsvm_assembly_program *program, const bool compress)
+{
+	if(program != NULL){
+		program->uncompressed = ! compress;
+	}
+}
+
 typedef struct
 {
 	void **data;
@@ -1285,6 +1293,31 @@ static void unload_modules(const char* key, void *data, void* arg)
 	tag->is_loaded = false;
 }
 
+/* The dependency list only lets the runtime load modules ahead of time, so
+ * a module that cannot be recorded is left to MOD_LOAD. */
+static void record_module(const char* key, void *data, void* arg)
+{
+	srsvm_program *out_program = arg;
+	srsvm_module_specification *spec, *last_spec;
+
+	size_t name_len = strlen(key);
+
+	if(out_program->num_modules < UINT16_MAX && name_len < SRSVM_MODULE_MAX_NAME_LEN && (spec = srsvm_program_module_alloc()) != NULL){
+		spec->name_len = (uint16_t) name_len;
+		memcpy(spec->name, key, name_len + 1);
+
+		if(out_program->modules == NULL){
+			out_program->modules = spec;
+		} else {
+			for(last_spec = out_program->modules; last_spec->next != NULL; last_spec = last_spec->next);
+
+			last_spec->next = spec;
+		}
+
+		out_program->num_modules++;
+	}
+}
+
 srsvm_program *srsvm_asm_emit(srsvm_assembly_program *program, const srsvm_ptr entry_point, const srsvm_word word_alignment)
 { 
 	srsvm_program *out_program = srsvm_program_alloc();
@@ -1570,7 +1603,7 @@ srsvm_program *srsvm_asm_emit(srsvm_assembly_program *program, const srsvm_ptr e
 					ERR_fmt("failed to locate label '%s'", line->jump_target);
 				} else {
 
-                    if(line->opcode == program->builtin_THREAD_START){
+                    if(line->opcode == program->builtin_THREAD_START || line->opcode == program->builtin_CALL){
                        line->assembled_instruction.argv[line->jump_target_arg_index].value = (srsvm_word) target_line->assembled_ptr; 
                        line->assembled_instruction.argv[line->jump_target_arg_index].type = SRSVM_ARG_TYPE_WORD;
                     } else {
@@ -1626,7 +1659,7 @@ srsvm_program *srsvm_asm_emit(srsvm_assembly_program *program, const srsvm_ptr e
         out_program->literal_memory = program_memory;
         program_memory->start_address = entry_point;
 #if defined(SRSVM_SUPPORT_COMPRESSION)
-        program_memory->is_compressed = true;
+        program_memory->is_compressed = ! program->uncompressed;
 #else
         program_memory->is_compressed = false;
 #endif
@@ -1706,6 +1739,7 @@ srsvm_program *srsvm_asm_emit(srsvm_assembly_program *program, const srsvm_ptr e
         program_memory->locked = true;
         out_program->num_lmem_segments = 1;
 
+        srsvm_string_map_walk(program->mod_map, record_module, out_program);
 
         if(mod_cache != NULL){
             srsvm_string_map_walk(mod_cache->map, unload_modules, NULL);
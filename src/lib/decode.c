@@ -0,0 +1,335 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "srsvm/debug.h"
+#include "srsvm/decode.h"
+#include "srsvm/memory.h"
+#include "srsvm/mmu.h"
+#include "srsvm/vm.h"
+
+static void free_blocks(srsvm_decode_table *table)
+{
+    srsvm_decode_arg_block *block = table->arg_blocks, *next_block;
+
+    while(block != NULL){
+        next_block = block->next;
+        free(block);
+        block = next_block;
+    }
+
+    srsvm_decode_binding_block *binding_block = table->binding_blocks, *next_binding_block;
+
+    while(binding_block != NULL){
+        next_binding_block = binding_block->next;
+        free(binding_block);
+        binding_block = next_binding_block;
+    }
+
+    table->arg_blocks = NULL;
+    table->binding_blocks = NULL;
+}
+
+static void table_free(srsvm_decode_table *table)
+{
+    if(table != NULL){
+        free_blocks(table);
+        free(table);
+    }
+}
+
+/* Empties a retired table for reuse, keeping one block of each kind so that
+ * re-decoding after a store does not go back to the allocator. */
+static void table_reset(srsvm_decode_table *table)
+{
+    srsvm_decode_arg_block *arg_block = table->arg_blocks;
+    srsvm_decode_binding_block *binding_block = table->binding_blocks;
+
+    if(arg_block != NULL){
+        table->arg_blocks = arg_block->next;
+    }
+
+    if(binding_block != NULL){
+        table->binding_blocks = binding_block->next;
+    }
+
+    free_blocks(table);
+
+    if(arg_block != NULL){
+        arg_block->next = NULL;
+        arg_block->used = 0;
+    }
+
+    if(binding_block != NULL){
+        memset(binding_block, 0, sizeof(srsvm_decode_binding_block));
+    }
+
+    table->arg_blocks = arg_block;
+    table->binding_blocks = binding_block;
+
+    memset(table->instructions, 0, table->cache->num_slots * sizeof(srsvm_decoded_instruction));
+
+    table->num_decoded = 0;
+}
+
+static void table_release(srsvm_mmu_deferred *deferred)
+{
+    srsvm_decode_table *table = (srsvm_decode_table*) deferred;
+    srsvm_decode_cache *cache = table->cache;
+
+    dbg_printf("releasing decode table %p", table);
+
+    srsvm_lock_acquire(&cache->lock);
+
+    if(cache->spare == NULL){
+        table_reset(table);
+
+        cache->spare = table;
+        table = NULL;
+    }
+
+    srsvm_lock_release(&cache->lock);
+
+    table_free(table);
+}
+
+static srsvm_decode_table *table_alloc(srsvm_decode_cache *cache)
+{
+    srsvm_decode_table *table = cache->spare;
+
+    if(table != NULL){
+        cache->spare = NULL;
+    } else if((table = calloc(1, sizeof(srsvm_decode_table) + cache->num_slots * sizeof(srsvm_decoded_instruction))) != NULL){
+        table->deferred.release = &table_release;
+        table->cache = cache;
+    }
+
+    return table;
+}
+
+srsvm_decode_cache *srsvm_decode_cache_alloc(srsvm_memory_segment *root_segment, srsvm_memory_segment *segment)
+{
+    srsvm_decode_cache *cache = NULL;
+
+    if(segment == NULL || segment->literal_sz == 0){
+        return NULL;
+    }
+
+    cache = malloc(sizeof(srsvm_decode_cache));
+
+    if(cache != NULL){
+        cache->root_segment = root_segment;
+        cache->segment = segment;
+        cache->base = segment->literal_start;
+        cache->size = segment->literal_sz;
+        cache->num_slots = (size_t) (segment->literal_sz / sizeof(srsvm_word)) + 1;
+        cache->spare = NULL;
+        cache->next = NULL;
+
+        if(! srsvm_lock_initialize(&cache->lock)){
+            free(cache);
+            cache = NULL;
+        } else if((cache->table = table_alloc(cache)) == NULL){
+            srsvm_lock_destroy(&cache->lock);
+            free(cache);
+            cache = NULL;
+        } else {
+            dbg_printf("allocated decode cache %p for segment %p, %lu slots", cache, segment, cache->num_slots);
+        }
+    }
+
+    return cache;
+}
+
+/* Tables retired by the cache are released with the root segment, which
+ * must already have been freed. */
+void srsvm_decode_cache_free(srsvm_decode_cache *cache)
+{
+    if(cache != NULL){
+        table_free(cache->table);
+        table_free(cache->spare);
+
+        srsvm_lock_destroy(&cache->lock);
+
+        free(cache);
+    }
+}
+
+/* Publishes replacement (which may be NULL) and retires the table it
+ * replaces. Called with the cache lock held; drops it. */
+static void replace_table(srsvm_decode_cache *cache, srsvm_decode_table *replacement)
+{
+    srsvm_decode_table *retired = cache->table;
+
+    srsvm_atomic_store_ptr(&cache->table, replacement);
+
+    srsvm_lock_release(&cache->lock);
+
+    if(retired != NULL){
+        srsvm_mmu_defer_release(cache->root_segment, &retired->deferred);
+    }
+}
+
+void srsvm_decode_cache_invalidate(srsvm_decode_cache *cache)
+{
+    dbg_printf("invalidating decode cache %p", cache);
+
+    srsvm_lock_acquire(&cache->lock);
+
+    if(cache->table != NULL && cache->table->num_decoded == 0){
+        srsvm_lock_release(&cache->lock);
+    } else {
+        replace_table(cache, cache->segment != NULL ? table_alloc(cache) : NULL);
+    }
+}
+
+void srsvm_decode_cache_detach(srsvm_decode_cache *cache)
+{
+    srsvm_lock_acquire(&cache->lock);
+
+    cache->segment = NULL;
+
+    replace_table(cache, NULL);
+}
+
+static srsvm_arg *alloc_args(srsvm_decode_table *table, const size_t count)
+{
+    srsvm_decode_arg_block *block = table->arg_blocks;
+
+    if(block == NULL || block->used + count > SRSVM_DECODE_ARG_BLOCK_SIZE){
+        block = calloc(1, sizeof(srsvm_decode_arg_block));
+
+        if(block == NULL){
+            return NULL;
+        }
+
+        block->next = table->arg_blocks;
+        table->arg_blocks = block;
+    }
+
+    srsvm_arg *args = &block->args[block->used];
+    block->used += count;
+
+    return args;
+}
+
+static bool decode_instruction(srsvm_vm *vm, srsvm_decode_table *table, const srsvm_ptr addr, srsvm_decoded_instruction *decoded)
+{
+    srsvm_instruction instruction;
+    srsvm_opcode *opcode;
+    srsvm_arg *argv;
+
+    if(! srsvm_opcode_load_instruction(vm, addr, &instruction)){
+        return false;
+    } else if((opcode = opcode_lookup_by_code(vm->opcode_map, instruction.opcode)) == NULL){
+        return false;
+    } else if(instruction.argc < opcode->argc_min || instruction.argc > opcode->argc_max){
+        return false;
+    } else if((argv = alloc_args(table, opcode->argc_max > 0 ? opcode->argc_max : 1)) == NULL){
+        return false;
+    }
+
+    memcpy(argv, instruction.argv, (size_t) instruction.argc * sizeof(srsvm_arg));
+
+    decoded->argc = instruction.argc;
+    decoded->argv = argv;
+    decoded->next_PC = addr + sizeof(instruction.opcode) + sizeof(srsvm_arg) * instruction.argc;
+    decoded->handler = srsvm_builtin_threaded_handler(opcode);
+
+    table->num_decoded++;
+
+    /* publishes the slot to lock-free readers */
+    srsvm_atomic_store_ptr(&decoded->opcode, opcode);
+
+    dbg_printf("decoded instruction at " PRINT_WORD_HEX ": %s", PRINTF_WORD_PARAM(addr), opcode->name);
+
+    return true;
+}
+
+const srsvm_decoded_instruction *srsvm_decode_cache_fetch(srsvm_vm *vm, srsvm_decode_cache *cache, const srsvm_ptr addr)
+{
+    srsvm_word offset = addr - cache->base;
+
+    if(offset % sizeof(srsvm_word) != 0){
+        return NULL;
+    }
+
+    size_t slot = (size_t) (offset / sizeof(srsvm_word));
+
+    srsvm_decode_table *table = srsvm_atomic_load_ptr(&cache->table);
+
+    if(table == NULL){
+        return NULL;
+    }
+
+    srsvm_decoded_instruction *decoded = &table->instructions[slot];
+
+    if(srsvm_atomic_load_ptr(&decoded->opcode) == NULL){
+        srsvm_lock_acquire(&cache->lock);
+
+        /* the table may have been replaced while waiting for the lock */
+        if(cache->segment == NULL || (table = cache->table) == NULL){
+            decoded = NULL;
+        } else if((decoded = &table->instructions[slot])->opcode == NULL && ! decode_instruction(vm, table, addr, decoded)){
+            decoded = NULL;
+        }
+
+        srsvm_lock_release(&cache->lock);
+    }
+
+    return decoded;
+}
+
+static srsvm_module_binding *alloc_binding(srsvm_decode_table *table)
+{
+    srsvm_decode_binding_block *block = table->binding_blocks;
+
+    if(block == NULL || block->used == SRSVM_DECODE_BINDING_BLOCK_SIZE){
+        block = calloc(1, sizeof(srsvm_decode_binding_block));
+
+        if(block == NULL){
+            return NULL;
+        }
+
+        block->next = table->binding_blocks;
+        table->binding_blocks = block;
+    }
+
+    return &block->bindings[block->used++];
+}
+
+bool srsvm_decode_cache_bind(srsvm_decode_cache *cache, const srsvm_decoded_instruction *decoded, const srsvm_word module_id, srsvm_opcode *opcode, const srsvm_atomic_counter generation)
+{
+    bool success = false;
+
+    /* The slot belongs to the cache, which only hands it out as const. */
+    srsvm_decoded_instruction *slot = (srsvm_decoded_instruction*) decoded;
+
+    srsvm_lock_acquire(&cache->lock);
+
+    srsvm_decode_table *table = cache->table;
+
+    /* a slot in a retired table must not take blocks from the live one */
+    if(cache->segment != NULL && table != NULL && slot >= table->instructions && slot < table->instructions + cache->num_slots && slot->opcode != NULL){
+        srsvm_module_binding *binding = slot->binding;
+
+        if(binding == NULL && (binding = alloc_binding(table)) != NULL){
+            srsvm_atomic_store_ptr(&slot->binding, binding);
+        }
+
+        if(binding != NULL){
+            srsvm_atomic_increment(&binding->sequence);
+
+            binding->module_id = module_id;
+            binding->opcode = opcode;
+            binding->generation = generation;
+
+            srsvm_atomic_increment(&binding->sequence);
+
+            success = true;
+        }
+    }
+
+    srsvm_lock_release(&cache->lock);
+
+    return success;
+}
@@ -0,0 +1,338 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include <errno.h>
+
+#include "srsvm/debug.h"
+#include "srsvm/heap.h"
+#include "srsvm/mmu.h"
+
+srsvm_heap *srsvm_heap_alloc(srsvm_memory_segment *root_segment)
+{
+    srsvm_heap *heap = malloc(sizeof(srsvm_heap));
+
+    if(heap != NULL){
+        memset(heap, 0, sizeof(srsvm_heap));
+
+        heap->root_segment = root_segment;
+
+        if(! srsvm_lock_initialize(&heap->lock)){
+            free(heap);
+            heap = NULL;
+        }
+    }
+
+    return heap;
+}
+
+void srsvm_heap_free(srsvm_heap *heap)
+{
+    if(heap != NULL){
+        /* Slabs are released along with their segments. */
+        srsvm_lock_destroy(&heap->lock);
+
+        free(heap);
+    }
+}
+
+void srsvm_heap_cache_init(srsvm_heap_cache *cache)
+{
+    memset(cache->count, 0, sizeof(cache->count));
+}
+
+static unsigned size_class_of(const srsvm_word bytes)
+{
+    unsigned size_class = 0;
+
+    while(((srsvm_word) 1 << (SRSVM_HEAP_MIN_BLOCK_SHIFT + size_class)) < bytes){
+        size_class++;
+    }
+
+    return size_class;
+}
+
+static void list_push(srsvm_heap *heap, srsvm_heap_slab *slab)
+{
+    slab->prev = NULL;
+    slab->next = heap->partial[slab->size_class];
+
+    if(slab->next != NULL){
+        slab->next->prev = slab;
+    }
+
+    heap->partial[slab->size_class] = slab;
+    slab->listed = true;
+}
+
+static void list_remove(srsvm_heap *heap, srsvm_heap_slab *slab)
+{
+    if(slab->prev != NULL){
+        slab->prev->next = slab->next;
+    } else {
+        heap->partial[slab->size_class] = slab->next;
+    }
+
+    if(slab->next != NULL){
+        slab->next->prev = slab->prev;
+    }
+
+    slab->prev = NULL;
+    slab->next = NULL;
+    slab->listed = false;
+}
+
+static srsvm_heap_slab *slab_alloc(srsvm_heap *heap, const unsigned size_class)
+{
+    unsigned block_shift = SRSVM_HEAP_MIN_BLOCK_SHIFT + size_class;
+    size_t num_blocks = SRSVM_HEAP_SLAB_SIZE >> block_shift;
+
+    srsvm_heap_slab *slab = malloc(sizeof(srsvm_heap_slab) + num_blocks * (sizeof(size_t) + sizeof(unsigned char)));
+
+    if(slab == NULL){
+        dbg_printf("malloc failed: %s", strerror(errno));
+
+        return NULL;
+    }
+
+    srsvm_memory_segment *segment = srsvm_mmu_alloc_literal(heap->root_segment, SRSVM_HEAP_SLAB_SIZE, 0);
+
+    if(segment == NULL){
+        dbg_puts("failed to allocate a slab segment");
+
+        free(slab);
+
+        return NULL;
+    }
+
+    slab->segment = segment;
+    slab->base = segment->literal_start;
+
+    slab->size_class = size_class;
+    slab->block_shift = block_shift;
+
+    slab->num_blocks = num_blocks;
+    slab->num_free = num_blocks;
+
+    slab->free_blocks = (size_t*) (slab + 1);
+    slab->allocated = (unsigned char*) (slab->free_blocks + num_blocks);
+
+    for(size_t i = 0; i < num_blocks; i++){
+        slab->free_blocks[i] = num_blocks - 1 - i;
+    }
+
+    memset(slab->allocated, 0, num_blocks * sizeof(unsigned char));
+
+    slab->prev = NULL;
+    slab->next = NULL;
+    slab->listed = false;
+
+    srsvm_mmu_set_slab(segment, slab);
+
+    dbg_printf("allocated slab %p for %lu byte blocks at " PRINT_WORD_HEX, slab, 1ul << block_shift, PRINTF_WORD_PARAM(slab->base));
+
+    return slab;
+}
+
+static bool refill(srsvm_heap *heap, srsvm_heap_cache *cache, const unsigned size_class)
+{
+    srsvm_heap_block *blocks = cache->blocks[size_class];
+
+    unsigned start = cache->count[size_class];
+
+    srsvm_lock_acquire(&heap->lock);
+
+    while(cache->count[size_class] < SRSVM_HEAP_CACHE_SIZE / 2){
+        srsvm_heap_slab *slab = heap->partial[size_class];
+
+        if(slab == NULL){
+            if((slab = slab_alloc(heap, size_class)) == NULL){
+                break;
+            }
+
+            list_push(heap, slab);
+        }
+
+        srsvm_heap_block *block = &blocks[cache->count[size_class]++];
+
+        block->slab = slab;
+        block->index = slab->free_blocks[--slab->num_free];
+
+        if(slab->num_free == 0){
+            list_remove(heap, slab);
+        }
+    }
+
+    srsvm_lock_release(&heap->lock);
+
+    /* The cache is popped from the top, so reverse the new blocks to hand
+     * them out in address order. */
+    for(unsigned i = start, j = cache->count[size_class]; i + 1 < j; i++, j--){
+        srsvm_heap_block tmp = blocks[i];
+
+        blocks[i] = blocks[j - 1];
+        blocks[j - 1] = tmp;
+    }
+
+    return cache->count[size_class] > 0;
+}
+
+static void flush(srsvm_heap *heap, srsvm_heap_cache *cache, const unsigned size_class, const unsigned count)
+{
+    srsvm_heap_block *blocks = cache->blocks[size_class];
+
+    srsvm_lock_acquire(&heap->lock);
+
+    for(unsigned i = 0; i < count; i++){
+        srsvm_heap_slab *slab = blocks[i].slab;
+
+        slab->free_blocks[slab->num_free++] = blocks[i].index;
+
+        if(! slab->listed){
+            list_push(heap, slab);
+        }
+
+        /* Keep one empty slab around per size class so that a thread
+         * allocating and freeing a single block doesn't churn segments. */
+        if(slab->num_free == slab->num_blocks && (slab->prev != NULL || slab->next != NULL)){
+            dbg_printf("releasing empty slab %p", slab);
+
+            list_remove(heap, slab);
+
+            srsvm_mmu_free(slab->segment);
+        }
+    }
+
+    srsvm_lock_release(&heap->lock);
+
+    cache->count[size_class] -= count;
+
+    memmove(blocks, blocks + count, cache->count[size_class] * sizeof(srsvm_heap_block));
+}
+
+void srsvm_heap_cache_flush(srsvm_heap *heap, srsvm_heap_cache *cache)
+{
+    for(unsigned size_class = 0; size_class < SRSVM_HEAP_NUM_CLASSES; size_class++){
+        if(cache->count[size_class] > 0){
+            flush(heap, cache, size_class, cache->count[size_class]);
+        }
+    }
+}
+
+bool srsvm_heap_get(srsvm_heap *heap, srsvm_heap_cache *cache, const srsvm_word bytes, srsvm_ptr *address)
+{
+    if(bytes == 0 || bytes > SRSVM_HEAP_MAX_BLOCK){
+        srsvm_memory_segment *segment = srsvm_mmu_alloc_literal(heap->root_segment, bytes, 0);
+
+        if(segment == NULL){
+            return false;
+        }
+
+        *address = segment->literal_start;
+
+        return true;
+    }
+
+    unsigned size_class = size_class_of(bytes);
+
+    if(cache->count[size_class] == 0 && ! refill(heap, cache, size_class)){
+        return false;
+    }
+
+    srsvm_heap_block *block = &cache->blocks[size_class][--cache->count[size_class]];
+
+    block->slab->allocated[block->index] = 1;
+
+    *address = block->slab->base + ((srsvm_ptr) block->index << block->slab->block_shift);
+
+    return true;
+}
+
+bool srsvm_heap_put(srsvm_heap *heap, srsvm_heap_cache *cache, srsvm_memory_segment *segment, const srsvm_ptr address)
+{
+    srsvm_heap_slab *slab = segment->slab;
+
+    if(segment->region){
+        dbg_puts("region memory can only be released with the region");
+
+        return false;
+    } else if(slab == NULL){
+        srsvm_mmu_free(segment);
+
+        return true;
+    }
+
+    srsvm_word index = (address - slab->base) >> slab->block_shift;
+
+    if(index >= slab->num_blocks || srsvm_atomic_swap_byte(&slab->allocated[(size_t) index], 0) == 0){
+        dbg_printf("block at " PRINT_WORD_HEX " is not allocated", PRINTF_WORD_PARAM(address));
+
+        return false;
+    }
+
+    unsigned size_class = slab->size_class;
+
+    if(cache->count[size_class] == SRSVM_HEAP_CACHE_SIZE){
+        flush(heap, cache, size_class, SRSVM_HEAP_CACHE_SIZE / 2);
+    }
+
+    srsvm_heap_block *block = &cache->blocks[size_class][cache->count[size_class]++];
+
+    block->slab = slab;
+    block->index = (size_t) index;
+
+    return true;
+}
+
+bool srsvm_heap_region_create(srsvm_heap *heap, const srsvm_word bytes, srsvm_ptr *address)
+{
+    srsvm_memory_segment *region = srsvm_mmu_alloc_literal(heap->root_segment, bytes, 0);
+
+    if(region == NULL){
+        return false;
+    }
+
+    region->region_used = 0;
+    region->region = true;
+
+    *address = region->literal_start;
+
+    return true;
+}
+
+bool srsvm_heap_region_alloc(srsvm_memory_segment *region, const srsvm_word bytes, srsvm_ptr *address)
+{
+    srsvm_word remainder = bytes % sizeof(srsvm_word);
+    srsvm_word aligned = remainder == 0 ? bytes : bytes + (sizeof(srsvm_word) - remainder);
+
+    if(region->free_flag){
+        dbg_puts("region has been destroyed");
+
+        return false;
+    }
+
+    /* Bump without the segment lock; the region is backed by host memory,
+     * so its size always fits in a size_t. */
+    size_t used = srsvm_atomic_load(&region->region_used);
+
+    do {
+        if(bytes == 0 || aligned < bytes || aligned > region->literal_sz - used){
+            dbg_printf("region %p cannot fit " PRINT_WORD " more bytes", region, PRINTF_WORD_PARAM(bytes));
+
+            return false;
+        }
+    } while(! srsvm_atomic_cas_size(&region->region_used, &used, used + (size_t) aligned));
+
+    *address = region->literal_start + used;
+
+    return true;
+}
+
+void srsvm_heap_region_reset(srsvm_memory_segment *region)
+{
+    srsvm_atomic_store_size(&region->region_used, 0);
+}
+
+void srsvm_heap_region_destroy(srsvm_memory_segment *region)
+{
+    srsvm_mmu_free(region);
+}
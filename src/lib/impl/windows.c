@@ -1,3 +1,4 @@
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -98,6 +99,35 @@ bool srsvm_thread_join(srsvm_thread *thread)
     return success;
 }
 
+bool srsvm_native_thread_start(srsvm_thread_native_handle *handle, native_thread_proc proc, void *arg)
+{
+    wrapped_thread_info *info = malloc(sizeof(wrapped_thread_info));
+
+    if(info == NULL){
+        return false;
+    }
+
+    info->proc = proc;
+    info->arg = arg;
+
+    if((*handle = CreateThread(NULL, 0, createthread_wrapper, info, 0, NULL)) == NULL){
+        free(info);
+
+        return false;
+    }
+
+    return true;
+}
+
+bool srsvm_native_thread_join(srsvm_thread_native_handle *handle)
+{
+    bool success = WaitForSingleObject(*handle, INFINITE) == WAIT_OBJECT_0;
+
+    CloseHandle(*handle);
+
+    return success;
+}
+
 void srsvm_sleep(const srsvm_word ms_timeout)
 {
 	Sleep((DWORD)ms_timeout);
@@ -150,6 +180,17 @@ bool srsvm_native_module_load_opcodes(srsvm_native_module_handle *handle, srsvm_
     return success;
 }
 
+const srsvm_opcode_table *srsvm_native_module_opcode_table(srsvm_native_module_handle *handle)
+{
+    const srsvm_opcode_table *table = NULL;
+
+    if(srsvm_native_module_supports_word_size(handle, WORD_SIZE)){
+        table = (const srsvm_opcode_table*) GetProcAddress(*handle, "srsvm_opcode_table_" STR(WORD_SIZE));
+    }
+
+    return table;
+}
+
 typedef bool(*word_size_check)(const uint8_t word_size);
 
 bool srsvm_native_module_supports_word_size(srsvm_native_module_handle *handle, const uint8_t word_size)
@@ -234,6 +275,35 @@ bool srsvm_file_exists(const char* file_name)
 		!(dwAttrib & FILE_ATTRIBUTE_DIRECTORY));
 }
 
+bool srsvm_file_mtime(const char* file_name, uint64_t *mtime)
+{
+	WIN32_FILE_ATTRIBUTE_DATA data;
+
+	if(! GetFileAttributesEx(file_name, GetFileExInfoStandard, &data)){
+		return false;
+	}
+
+	*mtime = ((uint64_t) data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+
+	return true;
+}
+
+char* srsvm_cache_directory(void)
+{
+	const char* base = getenv("LOCALAPPDATA");
+
+	char* cache_dir = NULL;
+
+	if(base != NULL && base[0] != '\0' && (cache_dir = srsvm_path_combine(base, "srsvm")) != NULL){
+		if(! CreateDirectory(cache_dir, NULL) && GetLastError() != ERROR_ALREADY_EXISTS){
+			free(cache_dir);
+			cache_dir = NULL;
+		}
+	}
+
+	return cache_dir;
+}
+
 char* srsvm_path_combine(const char* path_1, const char* path_2)
 {
     size_t len_1 = strlen(path_1);
@@ -302,47 +372,238 @@ error_cleanup:
     return NULL;
 }
 
+bool srsvm_zlib_inflate_into(const void* data, const size_t compressed_size, void *dest, const size_t original_size)
+{
+    unsigned long dest_len = original_size;
+    unsigned long source_len = compressed_size;
+
+    int uncompress_result = uncompress(dest, &dest_len, data, source_len);
+
+    switch(uncompress_result){
+        case Z_OK:
+            break;
+
+        case Z_MEM_ERROR:
+            dbg_puts("ERROR: failed to decompress memory: not enough memory");
+            return false;
+
+        case Z_BUF_ERROR:
+            dbg_puts("ERROR: failed to decompress memory: not enough room in output buffer");
+            return false;
+
+        case Z_DATA_ERROR:
+            dbg_puts("ERROR: failed to decompress memory: data is corrupted");
+            return false;
+
+        default:
+            dbg_puts("ERROR: failed to decompress memory: unknown error");
+            return false;
+    }
+
+    if(dest_len != original_size){
+        dbg_puts("ERROR: failed to decompress memory: data is shorter than expected");
+        return false;
+    }
+
+    return true;
+}
+
 void* srsvm_zlib_inflate(const void* data, const size_t compressed_size, const size_t original_size)
 {
     void* inflated_data = malloc(original_size);
 
-    if(inflated_data != NULL){
-        unsigned long dest_len = original_size;
-        unsigned long source_len = compressed_size;
+    if(inflated_data != NULL && ! srsvm_zlib_inflate_into(data, compressed_size, inflated_data, original_size)){
+        free(inflated_data);
+        inflated_data = NULL;
+    }
+    
+    return inflated_data;
+}
 
-        int uncompress_result = uncompress(inflated_data, &dest_len, data, source_len);
+uint32_t srsvm_zlib_crc32(const void* data, const size_t size)
+{
+    unsigned long crc = crc32(0L, Z_NULL, 0);
 
-        switch(uncompress_result){
-            case Z_OK:
-                break;
+    const unsigned char *bytes = data;
+    size_t remaining = size;
 
-            case Z_MEM_ERROR:
-                dbg_puts("ERROR: failed to decompress memory: not enough memory");
-                goto error_cleanup;
+    while(remaining > 0){
+        unsigned chunk = remaining > 0x40000000 ? 0x40000000 : (unsigned) remaining;
 
-            case Z_BUF_ERROR:
-                dbg_puts("ERROR: failed to decompress memory: not enough room in output buffer");
-                goto error_cleanup;
+        crc = crc32(crc, bytes, chunk);
 
-            case Z_DATA_ERROR:
-                dbg_puts("ERROR: failed to decompress memory: data is corrupted");
-                goto error_cleanup;
+        bytes += chunk;
+        remaining -= chunk;
+    }
 
-            default:
-                dbg_puts("ERROR: failed to decompress memory: unknown error");
-                goto error_cleanup;
+    return (uint32_t) crc;
+}
+
+/* LZ4 and Zstandard are optional: their libraries are looked up the first
+ * time a codec is asked for, and the codec is unsupported without them. */
+typedef int (*lz4_compress_bound_proc)(int);
+typedef int (*lz4_compress_proc)(const char*, char*, int, int, int);
+typedef int (*lz4_decompress_proc)(const char*, char*, int, int);
+
+typedef size_t (*zstd_compress_bound_proc)(size_t);
+typedef size_t (*zstd_compress_proc)(void*, size_t, const void*, size_t, int);
+typedef size_t (*zstd_decompress_proc)(void*, size_t, const void*, size_t);
+typedef unsigned (*zstd_is_error_proc)(size_t);
+
+#define LZ4_HC_LEVEL 9
+#define ZSTD_LEVEL 9
+
+static struct
+{
+    lz4_compress_bound_proc lz4_compress_bound;
+    lz4_compress_proc lz4_compress;
+    lz4_decompress_proc lz4_decompress;
+
+    zstd_compress_bound_proc zstd_compress_bound;
+    zstd_compress_proc zstd_compress;
+    zstd_decompress_proc zstd_decompress;
+    zstd_is_error_proc zstd_is_error;
+} codecs;
+
+static INIT_ONCE codecs_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK load_codecs(PINIT_ONCE once, PVOID param, PVOID *context)
+{
+    HMODULE lz4 = LoadLibrary("liblz4.dll");
+
+    if(lz4 != NULL){
+        codecs.lz4_compress_bound = (lz4_compress_bound_proc) GetProcAddress(lz4, "LZ4_compressBound");
+        codecs.lz4_compress = (lz4_compress_proc) GetProcAddress(lz4, "LZ4_compress_HC");
+        codecs.lz4_decompress = (lz4_decompress_proc) GetProcAddress(lz4, "LZ4_decompress_safe");
+    }
+
+    HMODULE zstd = LoadLibrary("libzstd.dll");
+
+    if(zstd != NULL){
+        codecs.zstd_compress_bound = (zstd_compress_bound_proc) GetProcAddress(zstd, "ZSTD_compressBound");
+        codecs.zstd_compress = (zstd_compress_proc) GetProcAddress(zstd, "ZSTD_compress");
+        codecs.zstd_decompress = (zstd_decompress_proc) GetProcAddress(zstd, "ZSTD_decompress");
+        codecs.zstd_is_error = (zstd_is_error_proc) GetProcAddress(zstd, "ZSTD_isError");
+    }
+
+    return TRUE;
+}
+
+bool srsvm_codec_supported(const unsigned codec)
+{
+    InitOnceExecuteOnce(&codecs_once, load_codecs, NULL, NULL);
+
+    switch(codec){
+        case SRSVM_CODEC_ZLIB:
+            return true;
+
+        case SRSVM_CODEC_LZ4:
+            return codecs.lz4_compress_bound != NULL && codecs.lz4_compress != NULL && codecs.lz4_decompress != NULL;
+
+        case SRSVM_CODEC_ZSTD:
+            return codecs.zstd_compress_bound != NULL && codecs.zstd_compress != NULL && codecs.zstd_decompress != NULL && codecs.zstd_is_error != NULL;
+
+        default:
+            return false;
+    }
+}
+
+void *srsvm_codec_compress(const unsigned codec, const void* data, size_t *compressed_size, const size_t original_size)
+{
+    if(! srsvm_codec_supported(codec)){
+        dbg_printf("ERROR: codec %u is not supported", codec);
+        return NULL;
+    } else if(codec == SRSVM_CODEC_ZLIB){
+        return srsvm_zlib_deflate(data, compressed_size, original_size);
+    }
+
+    size_t bound = 0;
+
+    if(codec == SRSVM_CODEC_LZ4){
+        if(original_size > INT_MAX || (bound = (size_t) codecs.lz4_compress_bound((int) original_size)) == 0){
+            dbg_puts("ERROR: failed to compress memory: too large for LZ4");
+            return NULL;
         }
+    } else {
+        bound = codecs.zstd_compress_bound(original_size);
     }
-    
-    return inflated_data;
 
-error_cleanup:
-    if(inflated_data != NULL){
-        free(inflated_data);
+    void *compressed_data = malloc(bound > 0 ? bound : 1);
+
+    if(compressed_data == NULL){
+        return NULL;
     }
 
+    if(codec == SRSVM_CODEC_LZ4){
+        int result = codecs.lz4_compress(data, compressed_data, (int) original_size, bound > INT_MAX ? INT_MAX : (int) bound, LZ4_HC_LEVEL);
+
+        if(result <= 0 && original_size > 0){
+            dbg_puts("ERROR: failed to compress memory with LZ4");
+            goto error_cleanup;
+        }
+
+        *compressed_size = (size_t) result;
+    } else {
+        size_t result = codecs.zstd_compress(compressed_data, bound, data, original_size, ZSTD_LEVEL);
+
+        if(codecs.zstd_is_error(result)){
+            dbg_puts("ERROR: failed to compress memory with Zstandard");
+            goto error_cleanup;
+        }
+
+        *compressed_size = result;
+    }
+
+    return compressed_data;
+
+error_cleanup:
+    free(compressed_data);
+
     return NULL;
 }
+
+bool srsvm_codec_decompress_into(const unsigned codec, const void* data, const size_t compressed_size, void *dest, const size_t original_size)
+{
+    if(! srsvm_codec_supported(codec)){
+        dbg_printf("ERROR: codec %u is not supported", codec);
+        return false;
+    } else if(codec == SRSVM_CODEC_ZLIB){
+        return srsvm_zlib_inflate_into(data, compressed_size, dest, original_size);
+    } else if(codec == SRSVM_CODEC_LZ4){
+        if(compressed_size > INT_MAX || original_size > INT_MAX){
+            dbg_puts("ERROR: failed to decompress memory: too large for LZ4");
+            return false;
+        }
+
+        int result = codecs.lz4_decompress(data, dest, (int) compressed_size, (int) original_size);
+
+        if(result < 0 || (size_t) result != original_size){
+            dbg_puts("ERROR: failed to decompress memory: data is corrupted");
+            return false;
+        }
+    } else {
+        size_t result = codecs.zstd_decompress(dest, original_size, data, compressed_size);
+
+        if(codecs.zstd_is_error(result) || result != original_size){
+            dbg_puts("ERROR: failed to decompress memory: data is corrupted");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void *srsvm_codec_decompress(const unsigned codec, const void* data, const size_t compressed_size, const size_t original_size)
+{
+    void* decompressed_data = malloc(original_size > 0 ? original_size : 1);
+
+    if(decompressed_data != NULL && ! srsvm_codec_decompress_into(codec, data, compressed_size, decompressed_data, original_size)){
+        free(decompressed_data);
+        decompressed_data = NULL;
+    }
+
+    return decompressed_data;
+}
 #endif
 
 int srsvm_strcasecmp(const char* a, const char* b)
@@ -364,3 +625,85 @@ char* srsvm_strndup(const char* s, const size_t n)
 {
     return _strdup(s);
 }
+
+size_t srsvm_vmem_page_size(void)
+{
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+
+    return (size_t) info.dwPageSize;
+}
+
+size_t srsvm_cpu_count(void)
+{
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+
+    return info.dwNumberOfProcessors > 0 ? (size_t) info.dwNumberOfProcessors : 1;
+}
+
+void *srsvm_vmem_reserve(const size_t size)
+{
+    return VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+void srsvm_vmem_release(void *addr, const size_t size)
+{
+    VirtualFree(addr, 0, MEM_RELEASE);
+}
+
+bool srsvm_vmem_protect(void *addr, const size_t size, const bool readable, const bool writable)
+{
+    DWORD protect = PAGE_NOACCESS, old_protect;
+
+    if(writable){
+        protect = PAGE_READWRITE;
+    } else if(readable){
+        protect = PAGE_READONLY;
+    }
+
+    if(VirtualAlloc(addr, size, MEM_COMMIT, PAGE_READWRITE) == NULL){
+        return false;
+    }
+
+    return VirtualProtect(addr, size, protect, &old_protect) != 0;
+}
+
+void srsvm_vmem_decommit(void *addr, const size_t size)
+{
+    VirtualFree(addr, size, MEM_DECOMMIT);
+}
+
+void *srsvm_file_map(const char* file_name, size_t *size)
+{
+    void *addr = NULL;
+
+    LARGE_INTEGER file_size;
+
+    HANDLE file = CreateFileA(file_name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if(file == INVALID_HANDLE_VALUE){
+        return NULL;
+    } else if(GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0 && (unsigned long long) file_size.QuadPart <= SIZE_MAX){
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+
+        if(mapping != NULL){
+            if((addr = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0)) != NULL){
+                *size = (size_t) file_size.QuadPart;
+            }
+
+            CloseHandle(mapping);
+        }
+    }
+
+    CloseHandle(file);
+
+    return addr;
+}
+
+void srsvm_file_unmap(void *addr, const size_t size)
+{
+    UnmapViewOfFile(addr);
+}
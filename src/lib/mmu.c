@@ -1,10 +1,18 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <errno.h>
 #include <limits.h>
 
 #include "srsvm/debug.h"
+#include "srsvm/decode.h"
+#include "srsvm/heap.h"
 #include "srsvm/memory.h"
+#include "srsvm/mmu.h"
+
+#define SRSVM_MMU_ALIGNMENT ((srsvm_word) sizeof(srsvm_word))
+#define SRSVM_MMU_MIN_ADDRESS SRSVM_MMU_ALIGNMENT
+#define SRSVM_MMU_MAX_WALK 256
 
 bool srsvm_mmu_segment_contains(const srsvm_memory_segment *segment, const srsvm_ptr address, const srsvm_word size)
 {
@@ -20,6 +28,21 @@ bool srsvm_mmu_segment_contains_literal(const srsvm_memory_segment *segment, con
     }
 }
 
+static srsvm_memory_segment *find_child(srsvm_memory_segment *node, const srsvm_ptr address)
+{
+    while(node != NULL){
+        if(address < node->min_address){
+            node = node->lchild;
+        } else if(address >= node->max_address){
+            node = node->rchild;
+        } else {
+            break;
+        }
+    }
+
+    return node;
+}
+
 srsvm_memory_segment* srsvm_mmu_locate(srsvm_memory_segment *root_segment, const srsvm_ptr address)
 {
     dbg_printf("attempting to locate address " PRINT_WORD_HEX " in segment %p", PRINTF_WORD_PARAM(address), root_segment);
@@ -41,21 +64,12 @@ srsvm_memory_segment* srsvm_mmu_locate(srsvm_memory_segment *root_segment, const
             dbg_puts("  out of bounds");
             segment = NULL;
         } else {
-            struct srsvm_memory_segment *child_segment;
-            struct srsvm_memory_segment *locate_result;
+            srsvm_memory_segment *child_segment = find_child(root_segment->children, address);
 
-            for(int segment_idx = 0; segment_idx < WORD_SIZE; segment_idx++){
-                child_segment = root_segment->children[segment_idx];
+            if(child_segment != NULL){
+                dbg_printf("  searching in child segment %p", child_segment);
 
-                if(child_segment != NULL){
-                    dbg_printf("  searching in child segment %p", child_segment);
-
-                    if((locate_result = srsvm_mmu_locate(child_segment, address)) != NULL){
-                        dbg_printf("  found address in child segment %p", child_segment);
-                        segment = locate_result;
-                        break;
-                    }
-                }
+                segment = srsvm_mmu_locate(child_segment, address);
             }
         }
     }
@@ -69,33 +83,60 @@ srsvm_memory_segment* srsvm_mmu_locate(srsvm_memory_segment *root_segment, const
     return segment;
 }
 
-bool srsvm_mmu_store(srsvm_memory_segment *root_segment, const srsvm_ptr address, const srsvm_word bytes, void* src)
+static bool walk(srsvm_memory_segment *segment, const srsvm_ptr address, srsvm_memory_segment **result)
 {
-    dbg_printf("attemping to store " PRINT_WORD " bytes to address " PRINT_WORD_HEX, PRINTF_WORD_PARAM(bytes), PRINTF_WORD_PARAM(address));
-
-    srsvm_memory_segment *segment = srsvm_mmu_locate(root_segment, address);
-
-    if(segment == NULL || !srsvm_mmu_segment_contains_literal(segment, address, bytes) || ! segment->writable || segment->locked){
-        if(segment == NULL){
-            dbg_puts("failed to locate segment");
-        } else if(! segment->writable){
-            dbg_puts("segment not writable");
-        } else if(segment->locked){
-            dbg_puts("segment locked");
+    srsvm_memory_segment *node = NULL;
+
+    *result = NULL;
+
+    for(unsigned steps = 0; steps < SRSVM_MMU_MAX_WALK; steps++){
+        if(node == NULL){
+            if(srsvm_mmu_segment_contains_literal(segment, address, 0)){
+                *result = segment;
+                return true;
+            } else if(address < segment->min_address || address >= segment->max_address){
+                return true;
+            } else if((node = srsvm_atomic_load(&segment->children)) == NULL){
+                return true;
+            }
+        } else if(address < node->min_address){
+            if((node = srsvm_atomic_load(&node->lchild)) == NULL){
+                return true;
+            }
+        } else if(address >= node->max_address){
+            if((node = srsvm_atomic_load(&node->rchild)) == NULL){
+                return true;
+            }
         } else {
-            dbg_puts("resolved segment does not contain address");
+            segment = node;
+            node = NULL;
         }
-
-        return false;
     }
 
-    dbg_puts("segment resolved, storing...");
+    return false;
+}
 
-    srsvm_lock_acquire(&segment->lock);
+srsvm_memory_segment* srsvm_mmu_translate(srsvm_memory_segment *root_segment, const srsvm_ptr address)
+{
+    srsvm_memory_segment *segment;
+
+    unsigned generation = srsvm_atomic_load_acquire(&root_segment->generation);
+
+    if(generation % 2 == 0 && walk(root_segment, address, &segment)){
+        srsvm_atomic_fence();
+
+        if(srsvm_atomic_load(&root_segment->generation) == generation){
+            return segment;
+        }
+    }
 
-    char* cpy_dest = (((char*)segment->literal_memory) + (uintptr_t)(address - segment->literal_start));
-    char* cpy_src = src; 
+    dbg_puts("translation raced with a segment update, retrying under lock");
+
+    return srsvm_mmu_locate(root_segment, address);
+}
 
+static void copy_memory(char *cpy_dest, const char *cpy_src, const srsvm_word bytes)
+{
     if(sizeof(srsvm_word) > sizeof(size_t)){
         srsvm_word bytes_remaining = bytes;
 
@@ -118,426 +159,1066 @@ bool srsvm_mmu_store(srsvm_memory_segment *root_segment, const srsvm_ptr address
     } else {
         memcpy(cpy_dest, cpy_src, (size_t) bytes);
     }
-
-    srsvm_lock_release(&segment->lock);
-    
-    dbg_puts("store successful");
-
-    return true;
 }
 
-bool srsvm_mmu_load(srsvm_memory_segment *root_segment, const srsvm_ptr address, const srsvm_word bytes, void* dest)
+bool srsvm_mmu_segment_store(srsvm_memory_segment *segment, const srsvm_ptr address, const srsvm_word bytes, void* src)
 {
-    dbg_printf("attempting to load " PRINT_WORD " bytes from address " PRINT_WORD_HEX " to native address %p", PRINTF_WORD_PARAM(bytes), PRINTF_WORD_PARAM(address), dest);
-
-    srsvm_memory_segment *segment = srsvm_mmu_locate(root_segment, address);
-
-    if(segment == NULL || !srsvm_mmu_segment_contains_literal(segment, address, bytes) || ! segment->readable){
-        if(segment == NULL){
-            dbg_puts("failed to locate segment");
-        } else if(! segment->readable){
+    if(!srsvm_mmu_segment_contains_literal(segment, address, bytes) || ! segment->writable || segment->locked || (segment->slab != NULL && ! srsvm_heap_slab_contains(segment->slab, address, bytes))){
+        if(! segment->writable){
             dbg_puts("segment not writable");
+        } else if(segment->locked){
+            dbg_puts("segment locked");
+        } else if(segment->slab != NULL){
+            dbg_puts("address is not in an allocated block");
         } else {
             dbg_puts("resolved segment does not contain address");
         }
-        
+
         return false;
     }
-    
-    dbg_puts("segment resolved, loading...");
-
-    srsvm_lock_acquire(&segment->lock);
-
-    char *cpy_dest = dest;
-    char *cpy_src = ((char*)segment->literal_memory) + (uintptr_t)(address - segment->literal_start);
 
-    if(sizeof(srsvm_word) > sizeof(size_t)){
-        srsvm_word bytes_remaining = bytes;
+    if(! srsvm_mmu_segment_materialize(segment, address, bytes)){
+        return false;
+    }
 
-        while(bytes_remaining > 0){
-            size_t single_copy;
+    dbg_puts("segment resolved, storing...");
 
-            if(bytes_remaining > SIZE_MAX){
-                single_copy = SIZE_MAX;
-            } else {
-                single_copy = (size_t) bytes_remaining;
-            }
+    copy_memory(((char*)segment->literal_memory) + (uintptr_t)(address - segment->literal_start), src, bytes);
 
-            memcpy(cpy_dest, cpy_src, single_copy);
+    if(segment->executable && segment->decode_cache != NULL){
+        srsvm_decode_cache_invalidate(segment->decode_cache);
+    }
+    
+    dbg_puts("store successful");
 
-            cpy_dest += single_copy;
-            cpy_src += single_copy;
+    return true;
+}
 
-            bytes_remaining -= single_copy;
+bool srsvm_mmu_segment_load(srsvm_memory_segment *segment, const srsvm_ptr address, const srsvm_word bytes, void* dest)
+{
+    if(!srsvm_mmu_segment_contains_literal(segment, address, bytes) || ! segment->readable || (segment->slab != NULL && ! srsvm_heap_slab_contains(segment->slab, address, bytes))){
+        if(! segment->readable){
+            dbg_puts("segment not readable");
+        } else if(segment->slab != NULL){
+            dbg_puts("address is not in an allocated block");
+        } else {
+            dbg_puts("resolved segment does not contain address");
         }
-    } else {
-        memcpy(cpy_dest, cpy_src, (size_t) bytes);
+        
+        return false;
+    }
+    
+    if(! srsvm_mmu_segment_materialize(segment, address, bytes)){
+        return false;
     }
 
-    srsvm_lock_release(&segment->lock);
+    dbg_puts("segment resolved, loading...");
+
+    copy_memory(dest, ((char*)segment->literal_memory) + (uintptr_t)(address - segment->literal_start), bytes);
     
     dbg_puts("load successful");
 
     return true;
 }
 
-static void lock_all(srsvm_memory_segment *segment)
+srsvm_word srsvm_mmu_segment_extent(const srsvm_memory_segment *segment, const srsvm_ptr address)
 {
-    if(segment->parent != NULL){
-        lock_all(segment->parent);
+    if(! segment->readable || ! srsvm_mmu_segment_contains_literal(segment, address, 0)){
+        return 0;
+    } else if(segment->slab != NULL){
+        return srsvm_heap_slab_extent(segment->slab, address);
     }
 
-    srsvm_lock_acquire(&segment->lock);
+    return segment->literal_start + segment->literal_sz - address;
 }
 
-static void release_all(srsvm_memory_segment *segment)
+char *srsvm_mmu_segment_span(const srsvm_memory_segment *segment, const srsvm_ptr address, const bool write, srsvm_word *before, srsvm_word *after)
 {
-    if(segment->parent != NULL){
-        release_all(segment->parent);
+    if(write ? (! segment->writable || segment->locked) : ! segment->readable){
+        return NULL;
+    } else if(! srsvm_mmu_segment_contains_literal(segment, address, 1)){
+        return NULL;
     }
 
-    srsvm_lock_release(&segment->lock);
-}
-
-static bool has_room(srsvm_memory_segment *parent, const srsvm_word bytes, const srsvm_ptr base_address, srsvm_memory_segment *prev_parent, bool child_slot)
-{
-    dbg_printf("looking for room for " PRINT_WORD " bytes in segment %p", PRINTF_WORD_PARAM(bytes), parent);
-
-    if(base_address > 0){
-        dbg_printf("  requested base address: " PRINT_WORD_HEX, PRINTF_WORD_PARAM(base_address));
-        
-        if(base_address < parent->min_address || base_address + bytes > parent->max_address){
-            if(parent->parent != NULL){
-                if(! has_room(parent->parent, bytes, base_address, parent, false)){
-                    dbg_printf("parent segment %p does not have room", parent->parent);
-
-                    return false;
-                }
-            }
-        } else if (base_address >= parent->literal_start && base_address + bytes < parent->literal_start + parent->literal_sz){
-            dbg_puts("literal intersect 1");
-
-            return false;
-        } else if(base_address + bytes >= parent->literal_start + parent->literal_sz && base_address < parent->literal_start + parent->literal_sz){
-            dbg_puts("literal intersect 2");
+    srsvm_ptr start = segment->literal_start;
+    srsvm_word size = segment->literal_sz;
 
-            return false;
-        } else {
-            dbg_puts("  requested region lies in this segment");
+    if(segment->slab != NULL){
+        if(! srsvm_heap_slab_contains(segment->slab, address, 1)){
+            return NULL;
         }
 
-        dbg_puts("  found room");
+        size = (srsvm_word) 1 << segment->slab->block_shift;
+        start = address - ((address - segment->slab->base) & (size - 1));
     }
 
-    if(! child_slot){
-        dbg_puts("  looking at child slots...");
-        for(int child_slot = 0; child_slot < WORD_SIZE; child_slot++){
-            if(parent->children[child_slot] != NULL){
-                if(prev_parent != NULL && prev_parent == parent->children[child_slot]){
-                    continue;
-                } else {
-                    if(base_address > 0){
-                        dbg_printf("  checking region intersection for child segment %p", parent->children[child_slot]);
-                        
-                        if(base_address >= parent->children[child_slot]->min_address && base_address + bytes < parent->children[child_slot]->max_address && !has_room(parent->children[child_slot], bytes, base_address, NULL, true)){
-                            dbg_puts("intersection found 1");
-
-                            return false;
-                        } else if(base_address + bytes >= parent->children[child_slot]->min_address && base_address < parent->children[child_slot]->max_address && !has_room(parent->children[child_slot], bytes, base_address, NULL, true)){
-                            dbg_puts("intersection found 2");
-
-                            return false;
-                        }
-                    } 
-                }
-            } else break;
-        }
+    if(! srsvm_mmu_segment_materialize(segment, start, size)){
+        return NULL;
     }
 
-    dbg_puts("sufficient room located");
+    *before = address - start;
+    *after = start + size - address;
 
-    return true;
+    return ((char*) segment->literal_memory) + (uintptr_t)(address - segment->literal_start);
 }
 
-static int find_free_slot(srsvm_memory_segment *parent)
+static void compressed_free(srsvm_compressed_memory *compressed)
 {
-    for(int slot = 0; slot < WORD_SIZE; slot++){
-        if(parent->children[slot] == NULL){
-            return slot;
-        }
-    }
+    if(compressed != NULL){
+        if(compressed->chunk_offsets != NULL) free(compressed->chunk_offsets);
+        if(compressed->materialized != NULL) free(compressed->materialized);
 
-    return -1;
+        free(compressed);
+    }
 }
 
-int compare_segment_bounds(const void* seg_a, const void* seg_b)
+#if defined(SRSVM_SUPPORT_FLAT_MEMORY)
+static void flat_set_compressed_flags(srsvm_flat_memory *flat, const srsvm_memory_segment *segment, const size_t first_page, const size_t end_page);
+#endif
+
+#if defined(SRSVM_SUPPORT_COMPRESSION)
+typedef struct
 {
-    const srsvm_memory_segment *a = *(const srsvm_memory_segment**)seg_a;
-    const srsvm_memory_segment *b = *(const srsvm_memory_segment**)seg_b;
+    const srsvm_memory_segment *segment;
+    const srsvm_compressed_memory *compressed;
 
-    if(a == NULL && b != NULL){
-        return 1;
-    } else if(a != NULL && b == NULL){
-        return -1;
-    } else if(a == NULL && b == NULL){
-        return 0;
-    } else {
-        if(a->min_address < b->min_address){
-            return -1;
-        } else if(a->min_address > b->min_address){
-            return 1;
-        } else {
-            return 0;
-        }
-    }
-}
+    size_t first_chunk;
+    size_t end_chunk;
 
-static void update_seg_bounds(srsvm_memory_segment *child, srsvm_memory_segment *parent)
-{
-    if(parent != NULL){
-        if(parent->max_address < child->max_address){
-            parent->max_address = child->max_address;
-        }
+    srsvm_atomic_counter next;
+    srsvm_atomic_counter failed;
+} inflate_job;
 
-        if(parent->min_address > child->min_address){
-            parent->min_address = child->min_address;
-        }
+static bool decode_chunk(const srsvm_memory_segment *segment, const srsvm_compressed_memory *compressed, const size_t chunk)
+{
+    size_t offset = chunk * compressed->chunk_size;
+    size_t size = (size_t) segment->literal_sz - offset;
 
-        update_seg_bounds(parent, parent->parent);
+    if(size > compressed->chunk_size){
+        size = compressed->chunk_size;
     }
 
-    qsort(&child->children, WORD_SIZE, sizeof(srsvm_memory_segment*), compare_segment_bounds);
+    return srsvm_codec_decompress_into(compressed->codec, compressed->data + compressed->chunk_offsets[chunk], compressed->chunk_offsets[chunk + 1] - compressed->chunk_offsets[chunk], (char*) segment->literal_memory + offset, size);
 }
 
-static bool insert_segment(srsvm_memory_segment *parent, srsvm_memory_segment *child, const srsvm_ptr suggested_base_address, const bool force_virtual)
-{   
-    dbg_printf("attempting to insert child segment %p into parent segment %p", child, parent);
+/* Chunks are claimed one at a time until the range runs out, so that every
+ * worker stays busy however unevenly the chunks compress. */
+static void inflate_worker(void *arg)
+{
+    inflate_job *job = arg;
 
-    dbg_printf("child virtual size: " PRINT_WORD, PRINTF_WORD_PARAM(child->sz));
-    dbg_printf("child literal size: " PRINT_WORD, PRINTF_WORD_PARAM(child->literal_sz));
+    for(;;){
+        size_t chunk = job->first_chunk + srsvm_atomic_increment(&job->next) - 1;
 
-    bool success = false;
+        if(chunk >= job->end_chunk){
+            break;
+        } else if(srsvm_atomic_load(&job->compressed->materialized[chunk]) == 0 && ! decode_chunk(job->segment, job->compressed, chunk)){
+            dbg_printf("failed to inflate chunk %lu of segment %p", (unsigned long) chunk, job->segment);
+
+            srsvm_atomic_store(&job->failed, 1);
+        }
+    }
+}
 
-    int child_slot;
+/* Decodes the chunks on as many cores as there are chunks to go around;
+ * the caller decodes alongside the workers, and on its own if none start. */
+static bool decode_chunks(inflate_job *job)
+{
+    size_t num_workers = srsvm_cpu_count();
 
-    if(suggested_base_address > 0){
-        dbg_printf("  requested base address: " PRINT_WORD_HEX, PRINTF_WORD_PARAM(suggested_base_address));
+    if(num_workers > job->end_chunk - job->first_chunk){
+        num_workers = job->end_chunk - job->first_chunk;
     }
 
-    if(! has_room(parent, child->sz, suggested_base_address, NULL, false)){
-        dbg_puts("insufficient room for requested base address");
+    num_workers = num_workers > SRSVM_MMU_MAX_INFLATE_THREADS ? SRSVM_MMU_MAX_INFLATE_THREADS - 1 : num_workers - 1;
 
-        if(!force_virtual){
-            if(suggested_base_address > 0 && has_room(parent, child->sz, 0, NULL, false)){
-                dbg_puts("  sufficient room for different base address");
+    srsvm_thread_native_handle workers[SRSVM_MMU_MAX_INFLATE_THREADS];
+    size_t started = 0;
 
-                if((child_slot = find_free_slot(parent)) != -1){
-                    dbg_printf("  inserting child into parent slot %d", child_slot);
-                    
-                    parent->children[child_slot] = child;
-                    child->parent = parent;
+    while(started < num_workers && srsvm_native_thread_start(&workers[started], inflate_worker, job)){
+        started++;
+    }
 
-                    if(child_slot == 0){
-                        child->min_address = parent->literal_start + parent->literal_sz;
-                        child->literal_start = parent->literal_start + parent->literal_sz;
+    inflate_worker(job);
 
-                        child->max_address = child->literal_start + child->sz;
+    for(size_t i = 0; i < started; i++){
+        srsvm_native_thread_join(&workers[i]);
+    }
 
-                        child->level = parent->level+1;
+    return srsvm_atomic_load(&job->failed) == 0;
+}
+#endif
 
-                        update_seg_bounds(child, child->parent);
+/* Chunks are inflated under the root lock, which guest accesses that miss
+ * the fast path may already hold. */
+static bool inflate_chunks(const srsvm_memory_segment *segment, srsvm_compressed_memory *compressed, const size_t first_chunk, const size_t end_chunk)
+{
+#if defined(SRSVM_SUPPORT_COMPRESSION)
+    srsvm_memory_segment *root_segment = compressed->root_segment;
 
-                        success = true;
-                    } else {
-                        srsvm_memory_segment *previous_child = parent->children[child_slot-1];
+    srsvm_lock_acquire(&root_segment->lock);
 
-                        child->min_address = previous_child->max_address;
-                        child->literal_start = previous_child->max_address;
+    if(compressed->checksum_pending){
+        if(srsvm_zlib_crc32(compressed->data, compressed->stored_size) != compressed->checksum){
+            dbg_printf("ERROR: checksum mismatch in compressed segment %p", segment);
 
-                        child->max_address = child->literal_start + child->sz;
+            srsvm_lock_release(&root_segment->lock);
 
-                        child->level = parent->level+1;
+            return false;
+        }
 
-                        update_seg_bounds(child, child->parent);
+        compressed->checksum_pending = false;
+    }
 
-                        success = true;
-                    }
-                } else {
-                    dbg_puts("no free slot found in parent, looking for space in a child segment...");
+    inflate_job job = { segment, compressed, first_chunk, end_chunk, 0, 0 };
 
-                    for(child_slot = 0; child_slot < WORD_SIZE; child_slot++){
-                        if(insert_segment(parent->children[child_slot], child, 0, force_virtual)){
-                            dbg_printf("found space in child segment %p", parent->children[child_slot]);
+    size_t offset = first_chunk * compressed->chunk_size;
+    size_t size = (size_t) segment->literal_sz - offset;
 
-                            success = true;
-                            break;
-                        }
-                    }
-                }
-            }
-        } else {
-            dbg_puts("bailing since a virtual segment is being forced");
-        }
-    } else {
-        dbg_puts("  sufficient room found in parent");
+    if(size > (end_chunk - first_chunk) * compressed->chunk_size){
+        size = (end_chunk - first_chunk) * compressed->chunk_size;
+    }
 
-        if((child_slot = find_free_slot(parent)) != -1){
-            dbg_printf("  inserting child into parent slot %d", child_slot);
-           
-            parent->children[child_slot] = child;
-            child->parent = parent;
+#if defined(SRSVM_SUPPORT_FLAT_MEMORY)
+    srsvm_flat_memory *flat = root_segment->flat;
 
-            child->min_address = suggested_base_address;
-            child->literal_start = suggested_base_address;
+    size_t first_page = 0, end_page = 0;
 
-            child->max_address = suggested_base_address + child->sz;
+    if(segment->mapped){
+        first_page = offset >> flat->page_shift;
+        end_page = (offset + size + (size_t) flat->page_size - 1) >> flat->page_shift;
 
-            child->level = parent->level+1;
+        srsvm_vmem_protect((char*) segment->literal_memory + (first_page << flat->page_shift), (end_page - first_page) << flat->page_shift, true, true);
+    }
+#endif
 
-            update_seg_bounds(child, child->parent);
+    bool success = decode_chunks(&job);
 
-            dbg_puts("base address granted");
+#if defined(SRSVM_SUPPORT_FLAT_MEMORY)
+    if(segment->mapped){
+        srsvm_vmem_protect((char*) segment->literal_memory + (first_page << flat->page_shift), (end_page - first_page) << flat->page_shift, segment->readable, segment->writable && ! segment->locked);
+    }
+#endif
 
-            success = true;
-        } else {
-            dbg_puts("no free slot found in parent, looking for space in a child segment...");
-            
-            for(child_slot = 0; child_slot < WORD_SIZE; child_slot++){
-                if(insert_segment(parent->children[child_slot], child, suggested_base_address, force_virtual)){ 
-                    dbg_printf("found space in child segment %p", parent->children[child_slot]);
-                    dbg_puts("base address granted");
-                    
-                    success = true;
-                    break;
-                }
-            }
+    if(success){
+        dbg_printf("inflated chunks %lu to %lu of segment %p", (unsigned long) first_chunk, (unsigned long) end_chunk - 1, segment);
 
-            if(! success){
-                for(child_slot = 0; child_slot < WORD_SIZE; child_slot++){
-                    if(insert_segment(parent->children[child_slot], child, 0, force_virtual)){
-                        dbg_printf("found space in child segment %p", parent->children[child_slot]);
+        for(size_t chunk = first_chunk; chunk < end_chunk; chunk++){
+            if(srsvm_atomic_load(&compressed->materialized[chunk]) == 0){
+                srsvm_atomic_store(&compressed->materialized[chunk], 1);
+                srsvm_atomic_decrement(&compressed->remaining);
+            }
+        }
 
-                        success = true;
-                        break;
-                    }
-                }
+#if defined(SRSVM_SUPPORT_FLAT_MEMORY)
+        if(segment->mapped){
+            if(end_chunk == compressed->num_chunks){
+                end_page = (size_t) (segment->sz >> flat->page_shift);
             }
+
+            flat_set_compressed_flags(flat, segment, first_page, end_page);
         }
+#endif
     }
 
+    srsvm_lock_release(&root_segment->lock);
+
     return success;
+#else
+    dbg_puts("compressed memory is not supported by this implementation");
+
+    return false;
+#endif
 }
 
-srsvm_word alloc_size(const srsvm_word requested_bytes)
+bool srsvm_mmu_segment_inflate(const srsvm_memory_segment *segment, const srsvm_ptr address, const srsvm_word bytes)
 {
-    /* https://stackoverflow.com/a/35485579/1633848 */
+    srsvm_compressed_memory *compressed = segment->compressed;
 
-    srsvm_word actual_bytes = requested_bytes;
-
-    actual_bytes--;
+    /* Anything outside the segment is rejected by the caller. */
+    if(srsvm_atomic_load_acquire(&compressed->remaining) == 0 || ! srsvm_mmu_segment_contains_literal(segment, address, bytes)){
+        return true;
+    }
 
-    actual_bytes |= actual_bytes >> 1;
-    actual_bytes |= actual_bytes >> 2;
-    actual_bytes |= actual_bytes >> 4;
-    actual_bytes |= actual_bytes >> 8;
+    size_t offset = (size_t) (address - segment->literal_start);
+    size_t last = offset + (bytes > 0 ? (size_t) bytes - 1 : 0);
 
-#if WORD_SIZE == 32
-    actual_bytes |= actual_bytes >> 16;
-#elif WORD_SIZE == 64
-    actual_bytes |= actual_bytes >> 16;
-    actual_bytes |= actual_bytes >> 32;
-#elif WORD_SIZE == 128
-    actual_bytes |= actual_bytes >> 16;
-    actual_bytes |= actual_bytes >> 32;
-    actual_bytes |= actual_bytes >> 64;
-#endif
+    size_t first_chunk = offset / compressed->chunk_size;
+    size_t end_chunk = last / compressed->chunk_size + 1;
 
-    actual_bytes++;
+    /* Trim chunks that are already inflated off both ends of the range. */
+    while(first_chunk < end_chunk && srsvm_atomic_load_acquire(&compressed->materialized[first_chunk]) != 0){
+        first_chunk++;
+    }
 
-    if(actual_bytes < requested_bytes){
-        // overflow?
-        return requested_bytes;
-    } else {
-        return actual_bytes;
+    while(end_chunk > first_chunk && srsvm_atomic_load_acquire(&compressed->materialized[end_chunk - 1]) != 0){
+        end_chunk--;
     }
+
+    return first_chunk == end_chunk || inflate_chunks(segment, compressed, first_chunk, end_chunk);
 }
 
-static srsvm_memory_segment* srsvm_mmu_alloc(srsvm_memory_segment *parent_segment, const srsvm_word literal_size, const srsvm_word virtual_size, const srsvm_ptr suggested_base_address, const bool force_virtual)
+bool srsvm_mmu_store(srsvm_memory_segment *root_segment, const srsvm_ptr address, const srsvm_word bytes, void* src)
 {
-    dbg_printf("allocating memory segment, literal size: " PRINT_WORD ", virtual_size: " PRINT_WORD ", requested base address: " PRINT_WORD_HEX, PRINTF_WORD_PARAM(literal_size), PRINTF_WORD_PARAM(virtual_size), PRINTF_WORD_PARAM(suggested_base_address));
+    dbg_printf("attemping to store " PRINT_WORD " bytes to address " PRINT_WORD_HEX, PRINTF_WORD_PARAM(bytes), PRINTF_WORD_PARAM(address));
 
-    srsvm_memory_segment *segment = NULL;
+    bool success = false;
 
-    if(literal_size == 0 && virtual_size == 0){
-        dbg_puts("empty segment requested, bailing");
+    srsvm_lock_acquire(&root_segment->lock);
 
-        goto error_cleanup;
-    } else {
-        segment = malloc(sizeof(srsvm_memory_segment));
+    srsvm_memory_segment *segment = srsvm_mmu_locate(root_segment, address);
 
-        if(segment == NULL){
-            dbg_printf("malloc failed: %s", strerror(errno));
-        } else memset(segment, 0, sizeof(srsvm_memory_segment));
+    if(segment == NULL){
+        dbg_puts("failed to locate segment");
+    } else {
+        success = srsvm_mmu_segment_store(segment, address, bytes, src);
     }
 
-    if(segment != NULL){
-        segment->literal_memory = NULL;
+    srsvm_lock_release(&root_segment->lock);
 
-        if(! srsvm_lock_initialize(&segment->lock)){
-            goto error_cleanup;
-        } else if(literal_size > 0 && (segment->literal_memory = malloc(literal_size * sizeof(char))) == NULL){
-            goto error_cleanup;
-        } else {
-            segment->literal_sz = literal_size;
+    return success;
+}
 
-            if(literal_size > 0){
-                segment->literal_start = suggested_base_address;
-            } else {
-                segment->literal_start = SRSVM_NULL_PTR;
-            }
+bool srsvm_mmu_load(srsvm_memory_segment *root_segment, const srsvm_ptr address, const srsvm_word bytes, void* dest)
+{
+    dbg_printf("attempting to load " PRINT_WORD " bytes from address " PRINT_WORD_HEX " to native address %p", PRINTF_WORD_PARAM(bytes), PRINTF_WORD_PARAM(address), dest);
 
-            if(virtual_size == 0){
-                segment->sz = alloc_size(literal_size);
-            } else {
-                segment->sz = virtual_size;
-            }
+    bool success = false;
 
-            segment->readable = true;
-            segment->writable = true;
-            segment->executable = true;
+    srsvm_lock_acquire(&root_segment->lock);
 
-            segment->locked = false;
+    srsvm_memory_segment *segment = srsvm_mmu_locate(root_segment, address);
 
-            segment->free_flag = false;
+    if(segment == NULL){
+        dbg_puts("failed to locate segment");
+    } else {
+        success = srsvm_mmu_segment_load(segment, address, bytes, dest);
+    }
 
-            for(int child_idx = 0; child_idx < WORD_SIZE; child_idx++){
-                segment->children[child_idx] = NULL;
-            }
+    srsvm_lock_release(&root_segment->lock);
 
-            if(parent_segment != NULL){
-                dbg_printf("allocated child segment %p", segment);
+    return success;
+}
 
-                dbg_printf("attempting to insert segment into parent segment %p...", parent_segment);
+static srsvm_memory_segment *root_of(srsvm_memory_segment *segment)
+{
+    while(segment->parent != NULL){
+        segment = segment->parent;
+    }
 
-                lock_all(parent_segment);
+    return segment;
+}
 
-                if(! insert_segment(parent_segment, segment, suggested_base_address, force_virtual)){
-                    dbg_puts("failed to insert segment");
+static void write_begin(srsvm_memory_segment *root_segment)
+{
+    srsvm_atomic_increment(&root_segment->generation);
+}
 
-                    release_all(parent_segment);
+static void write_end(srsvm_memory_segment *root_segment)
+{
+    srsvm_atomic_increment(&root_segment->generation);
+}
 
-                    goto error_cleanup;
-                } else {
-                    dbg_puts("segment inserted");
-                }
+static srsvm_word alignment_of(const srsvm_memory_segment *root_segment)
+{
+    if(root_segment->flat != NULL){
+        return root_segment->flat->page_size;
+    }
+
+    return SRSVM_MMU_ALIGNMENT;
+}
+
+#if defined(SRSVM_SUPPORT_FLAT_MEMORY)
+static unsigned char flat_flags(const srsvm_memory_segment *segment)
+{
+    unsigned char flags = SRSVM_FLAT_PAGE_MAPPED;
+
+    /* Slabs check each access against their block map. */
+    if(segment->slab != NULL){
+        return flags;
+    }
+
+    if(segment->readable){
+        flags |= SRSVM_FLAT_PAGE_READ;
+    }
+
+    /* Stores into a decoded segment have to invalidate its cache, so they
+     * stay on the slow path. */
+    if(segment->writable && ! segment->locked && segment->decode_cache == NULL){
+        flags |= SRSVM_FLAT_PAGE_WRITE;
+    }
+
+    return flags;
+}
+
+static void flat_set_flags(srsvm_flat_memory *flat, const srsvm_memory_segment *segment, const unsigned char flags)
+{
+    memset(&flat->page_flags[(size_t) (segment->literal_start >> flat->page_shift)], flags, (size_t) (segment->sz >> flat->page_shift));
+}
+
+/* A page of a segment that is still partly compressed only takes the fast
+ * path once every chunk it overlaps has been inflated. */
+static void flat_set_compressed_flags(srsvm_flat_memory *flat, const srsvm_memory_segment *segment, const size_t first_page, const size_t end_page)
+{
+    const srsvm_compressed_memory *compressed = segment->compressed;
+
+    unsigned char flags = flat_flags(segment);
+
+    size_t base_page = (size_t) (segment->literal_start >> flat->page_shift);
+    size_t literal_sz = (size_t) segment->literal_sz;
+
+    for(size_t page = first_page; page < end_page; page++){
+        size_t first = page << flat->page_shift;
+        size_t last = first + ((size_t) flat->page_size - 1);
+
+        bool ready = true;
+
+        if(first < literal_sz){
+            if(last >= literal_sz){
+                last = literal_sz - 1;
+            }
+
+            for(size_t chunk = first / compressed->chunk_size; ready && chunk <= last / compressed->chunk_size; chunk++){
+                ready = srsvm_atomic_load_acquire(&compressed->materialized[chunk]) != 0;
+            }
+        }
+
+        flat->page_flags[base_page + page] = ready ? flags : SRSVM_FLAT_PAGE_MAPPED;
+    }
+}
+
+static void flat_update_flags(srsvm_flat_memory *flat, const srsvm_memory_segment *segment)
+{
+    if(segment->compressed != NULL){
+        flat_set_compressed_flags(flat, segment, 0, (size_t) (segment->sz >> flat->page_shift));
+    } else {
+        flat_set_flags(flat, segment, flat_flags(segment));
+    }
+}
+
+static bool flat_map(srsvm_flat_memory *flat, srsvm_memory_segment *segment)
+{
+    srsvm_ptr start = segment->literal_start;
+
+    if(start % flat->page_size != 0 || segment->sz % flat->page_size != 0){
+        dbg_puts("segment is not page aligned");
+
+        return false;
+    } else if(start >= flat->size || segment->sz > flat->size - start){
+        dbg_puts("segment lies outside of the flat address space");
+
+        return false;
+    } else if(! srsvm_vmem_protect(flat->base + (size_t) start, (size_t) segment->sz, true, true)){
+        return false;
+    }
+
+    segment->literal_memory = flat->base + (size_t) start;
+    segment->mapped = true;
+
+    flat_update_flags(flat, segment);
+
+    return true;
+}
+
+/* Decommits the pages of a reclaimed segment, skipping any that have since
+ * been handed to a newer segment. */
+static void flat_unmap(srsvm_flat_memory *flat, const srsvm_memory_segment *segment)
+{
+    size_t page = (size_t) (segment->literal_start >> flat->page_shift);
+    size_t end = page + (size_t) (segment->sz >> flat->page_shift);
+
+    while(page < end){
+        size_t run = page;
+
+        while(run < end && (flat->page_flags[run] & SRSVM_FLAT_PAGE_MAPPED) == 0){
+            run++;
+        }
+
+        if(run > page){
+            srsvm_vmem_decommit(flat->base + (page << flat->page_shift), (run - page) << flat->page_shift);
+        }
+
+        page = run + 1;
+    }
+}
+#endif
+
+static bool back_segment(srsvm_memory_segment *root_segment, srsvm_memory_segment *segment, void *backing)
+{
+    if(backing != NULL && root_segment->flat == NULL){
+        segment->literal_memory = backing;
+        segment->borrowed = true;
+
+        return true;
+    }
+
+    bool flat_mapped = false;
+
+#if defined(SRSVM_SUPPORT_FLAT_MEMORY)
+    if(root_segment->flat != NULL && flat_map(root_segment->flat, segment)){
+        dbg_printf("mapped segment %p into the flat address space", segment);
+
+        flat_mapped = true;
+    }
+#endif
+
+    if(! flat_mapped && (segment->literal_memory = malloc(segment->literal_sz * sizeof(char))) == NULL){
+        dbg_printf("malloc failed: %s", strerror(errno));
+
+        return false;
+    }
+
+    if(backing != NULL){
+        copy_memory(segment->literal_memory, backing, segment->literal_sz);
+    }
+
+    return true;
+}
+
+bool srsvm_mmu_map_flat(srsvm_memory_segment *root_segment)
+{
+#if defined(SRSVM_SUPPORT_FLAT_MEMORY)
+    bool success = false;
+
+    srsvm_flat_memory *flat = NULL;
+
+    srsvm_lock_acquire(&root_segment->lock);
+
+    if(root_segment->parent != NULL || root_segment->children != NULL || root_segment->flat != NULL){
+        dbg_puts("the flat address space must be set up on an empty root segment");
+
+        goto error_cleanup;
+    } else if(SRSVM_FLAT_MEMORY_SIZE > SIZE_MAX){
+        dbg_puts("flat address space does not fit in the host address space");
+
+        goto error_cleanup;
+    } else if((flat = calloc(1, sizeof(srsvm_flat_memory))) == NULL){
+        goto error_cleanup;
+    }
+
+    flat->size = (size_t) SRSVM_FLAT_MEMORY_SIZE;
+    flat->page_size = (srsvm_word) srsvm_vmem_page_size();
+
+    while(((srsvm_word) 1 << flat->page_shift) < flat->page_size){
+        flat->page_shift++;
+    }
+
+    if(((srsvm_word) 1 << flat->page_shift) != flat->page_size){
+        dbg_puts("host page size is not a power of two");
+
+        goto error_cleanup;
+    } else if((flat->page_flags = calloc(flat->size >> flat->page_shift, sizeof(unsigned char))) == NULL){
+        goto error_cleanup;
+    } else if((flat->base = srsvm_vmem_reserve(flat->size)) == NULL){
+        goto error_cleanup;
+    }
+
+    dbg_printf("reserved flat address space at %p, %lu bytes", flat->base, (unsigned long) flat->size);
+
+    root_segment->flat = flat;
+
+    success = true;
+
+error_cleanup:
+    if(! success && flat != NULL){
+        if(flat->page_flags != NULL) free(flat->page_flags);
+        free(flat);
+    }
+
+    srsvm_lock_release(&root_segment->lock);
+
+    return success;
+#else
+    dbg_puts("flat address spaces are only supported for 32 and 64 bit words");
+
+    return false;
+#endif
+}
+
+void srsvm_mmu_set_permissions(srsvm_memory_segment *segment, const bool readable, const bool writable, const bool executable, const bool locked)
+{
+    srsvm_memory_segment *root_segment = root_of(segment);
+
+    srsvm_lock_acquire(&root_segment->lock);
+    write_begin(root_segment);
+
+    segment->readable = readable;
+    segment->writable = writable;
+    segment->executable = executable;
+    segment->locked = locked;
+
+#if defined(SRSVM_SUPPORT_FLAT_MEMORY)
+    if(segment->mapped){
+        flat_set_flags(root_segment->flat, segment, SRSVM_FLAT_PAGE_MAPPED);
+
+        srsvm_vmem_protect(segment->literal_memory, (size_t) segment->sz, readable, writable && ! locked);
+
+        flat_update_flags(root_segment->flat, segment);
+    }
+#endif
+
+    write_end(root_segment);
+    srsvm_lock_release(&root_segment->lock);
+}
+
+void srsvm_mmu_set_decode_cache(srsvm_memory_segment *segment, srsvm_decode_cache *cache)
+{
+    srsvm_memory_segment *root_segment = root_of(segment);
+
+    srsvm_lock_acquire(&root_segment->lock);
+
+    segment->decode_cache = cache;
+
+#if defined(SRSVM_SUPPORT_FLAT_MEMORY)
+    if(segment->mapped){
+        flat_update_flags(root_segment->flat, segment);
+    }
+#endif
+
+    srsvm_lock_release(&root_segment->lock);
+}
+
+void srsvm_mmu_set_slab(srsvm_memory_segment *segment, srsvm_heap_slab *slab)
+{
+    srsvm_memory_segment *root_segment = root_of(segment);
+
+    srsvm_lock_acquire(&root_segment->lock);
+
+    segment->slab = slab;
+
+#if defined(SRSVM_SUPPORT_FLAT_MEMORY)
+    if(segment->mapped){
+        flat_update_flags(root_segment->flat, segment);
+    }
+#endif
+
+    srsvm_lock_release(&root_segment->lock);
+}
+
+static void lock_all(srsvm_memory_segment *segment)
+{
+    if(segment->parent != NULL){
+        lock_all(segment->parent);
+    }
+
+    srsvm_lock_acquire(&segment->lock);
+}
+
+static void release_all(srsvm_memory_segment *segment)
+{
+    if(segment->parent != NULL){
+        release_all(segment->parent);
+    }
+
+    srsvm_lock_release(&segment->lock);
+}
+
+static bool align_up(const srsvm_word value, const srsvm_word alignment, srsvm_word *aligned)
+{
+    srsvm_word remainder = value % alignment;
+
+    if(remainder == 0){
+        *aligned = value;
+    } else {
+        *aligned = value + (alignment - remainder);
+    }
+
+    return *aligned >= value;
+}
+
+/* Children of a segment are kept in an AVL tree ordered by base address.
+ * Each node also tracks the bounds of its subtree and the largest unused
+ * gap between the segments beneath it, so a free range can be found
+ * without visiting subtrees that are too fragmented to hold it. */
+
+static unsigned long tree_height(const srsvm_memory_segment *node)
+{
+    return node != NULL ? node->height : 0;
+}
+
+static void tree_update(srsvm_memory_segment *node)
+{
+    srsvm_memory_segment *left = node->lchild, *right = node->rchild;
+
+    unsigned long left_height = tree_height(left), right_height = tree_height(right);
+
+    node->height = (left_height > right_height ? left_height : right_height) + 1;
+
+    node->subtree_min = left != NULL ? left->subtree_min : node->min_address;
+    node->subtree_max = right != NULL ? right->subtree_max : node->max_address;
+
+    node->max_gap = 0;
+
+    if(left != NULL){
+        node->max_gap = left->max_gap;
+
+        if(node->min_address - left->subtree_max > node->max_gap){
+            node->max_gap = node->min_address - left->subtree_max;
+        }
+    }
+
+    if(right != NULL){
+        if(right->max_gap > node->max_gap){
+            node->max_gap = right->max_gap;
+        }
+
+        if(right->subtree_min - node->max_address > node->max_gap){
+            node->max_gap = right->subtree_min - node->max_address;
+        }
+    }
+}
+
+static srsvm_memory_segment *rotate_left(srsvm_memory_segment *node)
+{
+    srsvm_memory_segment *pivot = node->rchild;
+
+    node->rchild = pivot->lchild;
+    pivot->lchild = node;
+
+    tree_update(node);
+    tree_update(pivot);
+
+    return pivot;
+}
+
+static srsvm_memory_segment *rotate_right(srsvm_memory_segment *node)
+{
+    srsvm_memory_segment *pivot = node->lchild;
+
+    node->lchild = pivot->rchild;
+    pivot->rchild = node;
+
+    tree_update(node);
+    tree_update(pivot);
+
+    return pivot;
+}
+
+static srsvm_memory_segment *tree_balance(srsvm_memory_segment *node)
+{
+    tree_update(node);
+
+    if(tree_height(node->lchild) > tree_height(node->rchild) + 1){
+        if(tree_height(node->lchild->lchild) < tree_height(node->lchild->rchild)){
+            node->lchild = rotate_left(node->lchild);
+        }
+
+        node = rotate_right(node);
+    } else if(tree_height(node->rchild) > tree_height(node->lchild) + 1){
+        if(tree_height(node->rchild->rchild) < tree_height(node->rchild->lchild)){
+            node->rchild = rotate_right(node->rchild);
+        }
+
+        node = rotate_left(node);
+    }
+
+    return node;
+}
+
+static srsvm_memory_segment *tree_insert(srsvm_memory_segment *node, srsvm_memory_segment *segment)
+{
+    if(node == NULL){
+        segment->lchild = NULL;
+        segment->rchild = NULL;
+
+        tree_update(segment);
+
+        return segment;
+    } else if(segment->min_address < node->min_address){
+        node->lchild = tree_insert(node->lchild, segment);
+    } else {
+        node->rchild = tree_insert(node->rchild, segment);
+    }
+
+    return tree_balance(node);
+}
+
+static srsvm_memory_segment *tree_remove_min(srsvm_memory_segment *node, srsvm_memory_segment **min)
+{
+    if(node->lchild == NULL){
+        *min = node;
+
+        return node->rchild;
+    }
+
+    node->lchild = tree_remove_min(node->lchild, min);
+
+    return tree_balance(node);
+}
+
+static srsvm_memory_segment *tree_remove(srsvm_memory_segment *node, srsvm_memory_segment *segment)
+{
+    if(node == NULL){
+        return NULL;
+    } else if(segment->min_address < node->min_address){
+        node->lchild = tree_remove(node->lchild, segment);
+    } else if(segment->min_address > node->min_address){
+        node->rchild = tree_remove(node->rchild, segment);
+    } else if(node->lchild == NULL){
+        return node->rchild;
+    } else if(node->rchild == NULL){
+        return node->lchild;
+    } else {
+        srsvm_memory_segment *successor = NULL;
+
+        node->rchild = tree_remove_min(node->rchild, &successor);
+
+        successor->lchild = node->lchild;
+        successor->rchild = node->rchild;
+
+        node = successor;
+    }
+
+    return tree_balance(node);
+}
+
+static bool range_is_free(const srsvm_memory_segment *parent, const srsvm_ptr start, const srsvm_word bytes)
+{
+    srsvm_ptr end = start + bytes;
+
+    if(end < start || start < parent->min_address || end > parent->max_address){
+        dbg_puts("requested region lies outside of the parent segment");
+
+        return false;
+    } else if(parent->literal_sz > 0 && start < parent->literal_start + parent->literal_sz && end > parent->literal_start){
+        dbg_puts("requested region intersects the parent's literal memory");
+
+        return false;
+    }
+
+    const srsvm_memory_segment *node = parent->children;
+
+    while(node != NULL){
+        if(end <= node->min_address){
+            node = node->lchild;
+        } else if(start >= node->max_address){
+            node = node->rchild;
+        } else {
+            dbg_printf("requested region intersects child segment %p", node);
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool gap_fits(srsvm_ptr start, const srsvm_ptr end, const srsvm_word bytes, const srsvm_word alignment, srsvm_ptr *address)
+{
+    if(start < SRSVM_MMU_MIN_ADDRESS){
+        start = SRSVM_MMU_MIN_ADDRESS;
+    }
+
+    if(! align_up(start, alignment, &start) || start > end || end - start < bytes){
+        return false;
+    }
+
+    *address = start;
+
+    return true;
+}
+
+static bool find_gap(const srsvm_memory_segment *node, const srsvm_word bytes, const srsvm_word alignment, srsvm_ptr *address)
+{
+    if(node == NULL || node->max_gap < bytes){
+        return false;
+    }
+
+    if(node->lchild != NULL){
+        if(find_gap(node->lchild, bytes, alignment, address) || gap_fits(node->lchild->subtree_max, node->min_address, bytes, alignment, address)){
+            return true;
+        }
+    }
+
+    if(node->rchild != NULL){
+        if(gap_fits(node->max_address, node->rchild->subtree_min, bytes, alignment, address) || find_gap(node->rchild, bytes, alignment, address)){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool find_free_range(const srsvm_memory_segment *parent, const srsvm_word bytes, const srsvm_word alignment, srsvm_ptr *address)
+{
+    const srsvm_memory_segment *tree = parent->children;
+
+    srsvm_ptr floor = parent->min_address;
+
+    if(parent->literal_sz > 0){
+        floor = parent->literal_start + parent->literal_sz;
+    }
+
+    if(tree == NULL){
+        return gap_fits(floor, parent->max_address, bytes, alignment, address);
+    } else {
+        return gap_fits(floor, tree->subtree_min, bytes, alignment, address) || find_gap(tree, bytes, alignment, address) || gap_fits(tree->subtree_max, parent->max_address, bytes, alignment, address);
+    }
+}
+
+static bool insert_segment(srsvm_memory_segment *parent, srsvm_memory_segment *child, const srsvm_ptr suggested_base_address, const bool force_virtual, const srsvm_word alignment)
+{
+    dbg_printf("attempting to insert child segment %p into parent segment %p", child, parent);
+
+    dbg_printf("child virtual size: " PRINT_WORD, PRINTF_WORD_PARAM(child->sz));
+    dbg_printf("child literal size: " PRINT_WORD, PRINTF_WORD_PARAM(child->literal_sz));
+
+    srsvm_ptr base_address = suggested_base_address;
+
+    bool placed = false;
+
+    if(suggested_base_address > 0){
+        dbg_printf("  requested base address: " PRINT_WORD_HEX, PRINTF_WORD_PARAM(suggested_base_address));
+
+        srsvm_memory_segment *container = find_child(parent->children, suggested_base_address);
+
+        if(container != NULL && container->literal_sz == 0 && suggested_base_address + child->sz > suggested_base_address && suggested_base_address + child->sz <= container->max_address){
+            dbg_printf("  requested region lies in virtual segment %p", container);
+
+            srsvm_lock_acquire(&container->lock);
+
+            placed = insert_segment(container, child, suggested_base_address, force_virtual, alignment);
+
+            srsvm_lock_release(&container->lock);
+
+            if(placed || force_virtual){
+                return placed;
+            }
+        } else if(range_is_free(parent, suggested_base_address, child->sz)){
+            dbg_puts("base address granted");
+
+            placed = true;
+        } else if(force_virtual){
+            dbg_puts("bailing since a virtual segment is being forced");
+
+            return false;
+        }
+    }
+
+    if(! placed){
+        if(! find_free_range(parent, child->sz, alignment, &base_address)){
+            dbg_puts("insufficient room in parent segment");
+
+            return false;
+        }
+
+        dbg_printf("  placing child at " PRINT_WORD_HEX, PRINTF_WORD_PARAM(base_address));
+    }
+
+    child->parent = parent;
+    child->level = parent->level + 1;
+
+    child->min_address = base_address;
+    child->max_address = base_address + child->sz;
+
+    if(child->literal_sz > 0){
+        child->literal_start = base_address;
+    }
+
+    parent->children = tree_insert(parent->children, child);
+
+    return true;
+}
+
+static srsvm_memory_segment *reclaim(srsvm_memory_segment *root_segment, srsvm_mmu_deferred **deferred);
+static void release_reclaimed(srsvm_memory_segment *reclaimed, srsvm_mmu_deferred *deferred);
+
+static srsvm_memory_segment* srsvm_mmu_alloc(srsvm_memory_segment *parent_segment, const srsvm_word literal_size, const srsvm_word virtual_size, const srsvm_ptr suggested_base_address, const bool force_virtual, void *backing)
+{
+    dbg_printf("allocating memory segment, literal size: " PRINT_WORD ", virtual_size: " PRINT_WORD ", requested base address: " PRINT_WORD_HEX, PRINTF_WORD_PARAM(literal_size), PRINTF_WORD_PARAM(virtual_size), PRINTF_WORD_PARAM(suggested_base_address));
+
+    srsvm_memory_segment *segment = NULL;
+
+    if(literal_size == 0 && virtual_size == 0){
+        dbg_puts("empty segment requested, bailing");
+
+        goto error_cleanup;
+    } else {
+        segment = malloc(sizeof(srsvm_memory_segment));
+
+        if(segment == NULL){
+            dbg_printf("malloc failed: %s", strerror(errno));
+        } else memset(segment, 0, sizeof(srsvm_memory_segment));
+    }
+
+    if(segment != NULL){
+        segment->literal_memory = NULL;
+
+        if(! srsvm_lock_initialize(&segment->lock)){
+            goto error_cleanup;
+        } else if(literal_size > 0 && parent_segment == NULL && (segment->literal_memory = malloc(literal_size * sizeof(char))) == NULL){
+            goto error_cleanup;
+        } else {
+            segment->literal_sz = literal_size;
+
+            if(literal_size > 0){
+                segment->literal_start = suggested_base_address;
+            } else {
+                segment->literal_start = SRSVM_NULL_PTR;
+            }
+
+            srsvm_word alignment = parent_segment != NULL ? alignment_of(root_of(parent_segment)) : SRSVM_MMU_ALIGNMENT;
+
+            if(virtual_size == 0){
+                if(! align_up(literal_size, alignment, &segment->sz)){
+                    segment->sz = literal_size;
+                }
+            } else {
+                segment->sz = virtual_size;
+            }
+
+            segment->readable = true;
+            segment->writable = true;
+            segment->executable = true;
+
+            segment->locked = false;
+
+            segment->free_flag = false;
+
+            segment->children = NULL;
+
+            if(parent_segment != NULL){
+                dbg_printf("allocated child segment %p", segment);
+
+                dbg_printf("attempting to insert segment into parent segment %p...", parent_segment);
+
+                srsvm_memory_segment *root_segment = root_of(parent_segment);
+
+                lock_all(parent_segment);
+                write_begin(root_segment);
+
+                bool inserted = insert_segment(parent_segment, segment, suggested_base_address, force_virtual, alignment);
+
+                if(inserted && literal_size > 0 && ! back_segment(root_segment, segment, backing)){
+                    segment->parent->children = tree_remove(segment->parent->children, segment);
+
+                    inserted = false;
+                }
+
+                write_end(root_segment);
+
+                srsvm_mmu_deferred *deferred;
+                srsvm_memory_segment *reclaimed = reclaim(root_segment, &deferred);
 
                 release_all(parent_segment);
+
+                release_reclaimed(reclaimed, deferred);
+
+                if(! inserted){
+                    dbg_puts("failed to insert segment");
+
+                    goto error_cleanup;
+                } else {
+                    dbg_puts("segment inserted");
+                }
             } else {
                 dbg_printf("allocated root segment: %p", segment);
 
                 segment->parent = NULL;
                 segment->level = 0;
 
+                segment->epoch = 1;
+
                 segment->min_address = suggested_base_address;
                 segment->max_address = suggested_base_address + segment->sz;
             }
@@ -558,113 +1239,373 @@ error_cleanup:
 
 srsvm_memory_segment *srsvm_mmu_alloc_literal(srsvm_memory_segment *parent_segment, const srsvm_word literal_size, const srsvm_ptr suggested_base_address)
 {
-    return srsvm_mmu_alloc(parent_segment, literal_size, 0, suggested_base_address,  false);
+    return srsvm_mmu_alloc(parent_segment, literal_size, 0, suggested_base_address,  false, NULL);
+}
+
+srsvm_memory_segment *srsvm_mmu_alloc_literal_backed(srsvm_memory_segment *parent_segment, const srsvm_word literal_size, const srsvm_ptr suggested_base_address, void *memory)
+{
+    return srsvm_mmu_alloc(parent_segment, literal_size, 0, suggested_base_address, false, memory);
+}
+
+srsvm_memory_segment *srsvm_mmu_alloc_literal_compressed(srsvm_memory_segment *parent_segment, const srsvm_word literal_size, const srsvm_ptr suggested_base_address, const void *data, const unsigned codec, const size_t chunk_size, const size_t num_chunks, const size_t *chunk_offsets)
+{
+    srsvm_memory_segment *segment = NULL;
+
+    srsvm_compressed_memory *compressed = NULL;
+
+    if(parent_segment == NULL || chunk_size == 0 || num_chunks == 0 || num_chunks != ((size_t) literal_size + chunk_size - 1) / chunk_size){
+        dbg_puts("chunks do not cover the segment");
+
+        return NULL;
+    } else if((compressed = calloc(1, sizeof(srsvm_compressed_memory))) == NULL){
+        goto error_cleanup;
+    } else if((compressed->chunk_offsets = malloc((num_chunks + 1) * sizeof(size_t))) == NULL){
+        goto error_cleanup;
+    } else if((compressed->materialized = calloc(num_chunks, sizeof(srsvm_atomic_counter))) == NULL){
+        goto error_cleanup;
+    }
+
+    memcpy(compressed->chunk_offsets, chunk_offsets, (num_chunks + 1) * sizeof(size_t));
+
+    compressed->data = data;
+    compressed->codec = codec;
+    compressed->chunk_size = chunk_size;
+    compressed->num_chunks = num_chunks;
+    compressed->remaining = (srsvm_atomic_counter) num_chunks;
+
+    if((segment = srsvm_mmu_alloc(parent_segment, literal_size, 0, suggested_base_address, false, NULL)) == NULL){
+        goto error_cleanup;
+    }
+
+    srsvm_memory_segment *root_segment = root_of(segment);
+
+    compressed->root_segment = root_segment;
+
+    srsvm_lock_acquire(&root_segment->lock);
+    write_begin(root_segment);
+
+    segment->compressed = compressed;
+
+#if defined(SRSVM_SUPPORT_FLAT_MEMORY)
+    if(segment->mapped){
+        flat_update_flags(root_segment->flat, segment);
+    }
+#endif
+
+    write_end(root_segment);
+    srsvm_lock_release(&root_segment->lock);
+
+    return segment;
+
+error_cleanup:
+    compressed_free(compressed);
+
+    return NULL;
+}
+
+void srsvm_mmu_segment_expect_checksum(srsvm_memory_segment *segment, const size_t stored_size, const uint32_t checksum)
+{
+    srsvm_compressed_memory *compressed = segment->compressed;
+
+    if(compressed != NULL){
+        srsvm_memory_segment *root_segment = compressed->root_segment;
+
+        srsvm_lock_acquire(&root_segment->lock);
+
+        compressed->checksum = checksum;
+        compressed->stored_size = stored_size;
+        compressed->checksum_pending = true;
+
+        srsvm_lock_release(&root_segment->lock);
+    }
 }
 
 srsvm_memory_segment *srsvm_mmu_alloc_virtual(srsvm_memory_segment *parent_segment, const srsvm_word virtual_size, const srsvm_ptr base_address)
 {
-    return srsvm_mmu_alloc(parent_segment, 0, virtual_size, base_address, true); 
+    return srsvm_mmu_alloc(parent_segment, 0, virtual_size, base_address, true, NULL);
 }
 
-static bool children_freed(srsvm_memory_segment *segment)
+static void release_segment(srsvm_memory_segment *segment);
+
+static void release_tree(srsvm_memory_segment *node)
 {
-    bool all_freed = true;
+    if(node != NULL){
+        release_tree(node->lchild);
+        release_tree(node->rchild);
 
-    for(int child_slot = 0; child_slot < WORD_SIZE; child_slot++){
-        if(segment->children[child_slot] != NULL){
-            if(! segment->children[child_slot]->free_flag){
-                all_freed = false;
-            } else if(! children_freed(segment->children[child_slot]))
-            {
-                all_freed = false;
-            }
-        } else break;
+        release_segment(node);
+    }
+}
+
+static void release_segment(srsvm_memory_segment *segment)
+{
+    release_tree(segment->children);
+
+    while(segment->retired != NULL){
+        srsvm_memory_segment *retired = segment->retired;
+
+        segment->retired = retired->next_retired;
+
+        release_segment(retired);
+    }
+
+    while(segment->deferred != NULL){
+        srsvm_mmu_deferred *deferred = segment->deferred;
+
+        segment->deferred = deferred->next;
+
+        deferred->release(deferred);
+    }
+
+    if(segment->decode_cache != NULL){
+        srsvm_decode_cache_detach(segment->decode_cache);
+    }
+
+    if(segment->literal_memory != NULL && ! segment->mapped && ! segment->borrowed){
+        free(segment->literal_memory);
+    }
+
+    compressed_free(segment->compressed);
+
+    if(segment->slab != NULL){
+        free(segment->slab);
     }
 
-    return all_freed;
+    if(segment->flat != NULL){
+        srsvm_vmem_release(segment->flat->base, segment->flat->size);
+
+        free(segment->flat->page_flags);
+        free(segment->flat);
+    }
+
+    srsvm_lock_destroy(&segment->lock);
+
+    free(segment);
 }
 
-bool free_tree(srsvm_memory_segment *segment)
+static bool epoch_before(const unsigned a, const unsigned b)
 {
-    if(! segment->free_flag){
-        return false;
+    return (int) (a - b) < 0;
+}
+
+/* Unlinks every retired segment and deferred block that no reader can
+ * still reach. The caller releases them with release_reclaimed once the
+ * root lock has been dropped, since releasing a segment takes its decode
+ * cache lock. */
+static srsvm_memory_segment *reclaim(srsvm_memory_segment *root_segment, srsvm_mmu_deferred **deferred)
+{
+    srsvm_memory_segment *reclaimed = NULL;
+
+    *deferred = NULL;
+
+    if(root_segment->retired == NULL && root_segment->deferred == NULL){
+        return NULL;
     }
 
-    bool can_free = true;
+    unsigned oldest = srsvm_atomic_load(&root_segment->epoch);
 
-    for(int child_slot = 0; child_slot < WORD_SIZE; child_slot++){
-        if(segment->children[child_slot] != NULL){
-            if(segment->children[child_slot]->free_flag && children_freed(segment->children[child_slot])){
-                if(free_tree(segment->children[child_slot])){
-                    segment->children[child_slot] = NULL;
-                } else {
-                    can_free = false;
-                }
+    for(srsvm_mmu_reader *reader = root_segment->readers; reader != NULL; reader = reader->next){
+        unsigned epoch = srsvm_atomic_load_acquire(&reader->epoch);
+
+        if(epoch != 0 && epoch_before(epoch, oldest)){
+            oldest = epoch;
+        }
+    }
+
+    srsvm_memory_segment **link = &root_segment->retired;
+
+    while(*link != NULL){
+        srsvm_memory_segment *segment = *link;
+
+        if(epoch_before(segment->retire_epoch, oldest)){
+            *link = segment->next_retired;
+
+#if defined(SRSVM_SUPPORT_FLAT_MEMORY)
+            if(segment->mapped){
+                flat_unmap(root_segment->flat, segment);
             }
-        } else break;
+#endif
+
+            segment->next_retired = reclaimed;
+            reclaimed = segment;
+        } else {
+            link = &segment->next_retired;
+        }
     }
 
-    if(can_free && children_freed(segment)){
-        if(segment->literal_memory != NULL){
-            free(segment->literal_memory);
-            segment->literal_memory = NULL;
+    srsvm_mmu_deferred **deferred_link = &root_segment->deferred;
+
+    while(*deferred_link != NULL){
+        srsvm_mmu_deferred *block = *deferred_link;
+
+        if(epoch_before(block->retire_epoch, oldest)){
+            *deferred_link = block->next;
+
+            block->next = *deferred;
+            *deferred = block;
+        } else {
+            deferred_link = &block->next;
         }
+    }
 
-        srsvm_lock_release(&segment->lock);
-        srsvm_lock_destroy(&segment->lock);
+    return reclaimed;
+}
 
-        free(segment);
+static void release_reclaimed(srsvm_memory_segment *reclaimed, srsvm_mmu_deferred *deferred)
+{
+    while(reclaimed != NULL){
+        srsvm_memory_segment *next = reclaimed->next_retired;
 
-        return true;
-    } else {
-        return false;
+        dbg_printf("reclaiming segment %p", reclaimed);
+
+        release_segment(reclaimed);
+
+        reclaimed = next;
+    }
+
+    while(deferred != NULL){
+        srsvm_mmu_deferred *next = deferred->next;
+
+        deferred->release(deferred);
+
+        deferred = next;
     }
 }
 
-void srsvm_mmu_set_all_free(srsvm_memory_segment *segment)
+static void advance_epoch(srsvm_memory_segment *root_segment)
 {
-	if(segment != NULL){
-		segment->free_flag = true;
+    if(srsvm_atomic_increment(&root_segment->epoch) == 0){
+        srsvm_atomic_increment(&root_segment->epoch);
+    }
 
-		for(int i = 0; i < WORD_SIZE; i++){
-			if(segment->children[i] != NULL){
-				srsvm_mmu_set_all_free(segment->children[i]);
-			}
-		}
-	}
+    srsvm_atomic_fence();
 }
 
-void srsvm_mmu_free(srsvm_memory_segment *segment)
+static srsvm_memory_segment *retire(srsvm_memory_segment *root_segment, srsvm_memory_segment *segment, srsvm_mmu_deferred **deferred)
 {
-    segment->free_flag = true;
+    segment->retire_epoch = root_segment->epoch;
+    segment->next_retired = root_segment->retired;
+    root_segment->retired = segment;
 
-    if(segment->parent != NULL){
-   	//lock_all(segment->parent);
-	
-	for(int i = 0; i < WORD_SIZE; i++){
-	    if(segment->parent->children[i] != NULL){
-		if(segment->parent->children[i] == segment){
-			segment->parent->children[i] = NULL;
-		}
-	    } else break;
-	}
-    
-	//release_all(segment->parent);
+    advance_epoch(root_segment);
+
+    return reclaim(root_segment, deferred);
+}
+
+void srsvm_mmu_defer_release(srsvm_memory_segment *root_segment, srsvm_mmu_deferred *deferred)
+{
+    srsvm_mmu_deferred *reclaimed_deferred;
+
+    srsvm_lock_acquire(&root_segment->lock);
+
+    deferred->retire_epoch = root_segment->epoch;
+    deferred->next = root_segment->deferred;
+    root_segment->deferred = deferred;
+
+    advance_epoch(root_segment);
+
+    srsvm_memory_segment *reclaimed = reclaim(root_segment, &reclaimed_deferred);
+
+    srsvm_lock_release(&root_segment->lock);
+
+    release_reclaimed(reclaimed, reclaimed_deferred);
+}
+
+void srsvm_mmu_reader_register(srsvm_memory_segment *root_segment, srsvm_mmu_reader *reader)
+{
+    srsvm_lock_acquire(&root_segment->lock);
+
+    reader->epoch = 0;
+    reader->next = root_segment->readers;
+    root_segment->readers = reader;
+
+    srsvm_lock_release(&root_segment->lock);
+}
+
+void srsvm_mmu_reader_unregister(srsvm_memory_segment *root_segment, srsvm_mmu_reader *reader)
+{
+    srsvm_lock_acquire(&root_segment->lock);
+
+    for(srsvm_mmu_reader **link = &root_segment->readers; *link != NULL; link = &(*link)->next){
+        if(*link == reader){
+            *link = reader->next;
+            break;
+        }
     }
 
-    free_tree(segment);
+    srsvm_mmu_deferred *deferred;
+    srsvm_memory_segment *reclaimed = reclaim(root_segment, &deferred);
+
+    srsvm_lock_release(&root_segment->lock);
+
+    release_reclaimed(reclaimed, deferred);
 }
 
-void srsvm_mmu_free_force(srsvm_memory_segment *segment)
+static void set_tree_free(srsvm_memory_segment *node)
 {
-    for(int child_slot = 0; child_slot < WORD_SIZE; child_slot++){
-        if(segment->children[child_slot] != NULL){
-            srsvm_mmu_free_force(segment->children[child_slot]);
-        } else break;
+    if(node != NULL){
+        node->free_flag = true;
+
+        set_tree_free(node->children);
+        set_tree_free(node->lchild);
+        set_tree_free(node->rchild);
     }
+}
 
-    //srsvm_lock_release(&segment->lock);
-    srsvm_lock_destroy(&segment->lock);
+void srsvm_mmu_set_all_free(srsvm_memory_segment *segment)
+{
+    if(segment != NULL){
+        segment->free_flag = true;
 
-    free(segment);
+        set_tree_free(segment->children);
+    }
+}
+
+void srsvm_mmu_free(srsvm_memory_segment *segment)
+{
+    srsvm_memory_segment *parent = segment->parent;
+
+    if(parent == NULL){
+        release_segment(segment);
+    } else {
+        srsvm_memory_segment *root_segment = root_of(segment);
+
+        if(segment->decode_cache != NULL){
+            srsvm_decode_cache_detach(segment->decode_cache);
+        }
+
+        srsvm_memory_segment *reclaimed = NULL;
+        srsvm_mmu_deferred *deferred = NULL;
+
+        lock_all(parent);
+
+        if(segment->retire_epoch != 0){
+            dbg_printf("segment %p has already been freed", segment);
+        } else {
+            write_begin(root_segment);
+
+#if defined(SRSVM_SUPPORT_FLAT_MEMORY)
+            if(segment->mapped){
+                flat_set_flags(root_segment->flat, segment, 0);
+            }
+#endif
+
+            parent->children = tree_remove(parent->children, segment);
+
+            write_end(root_segment);
+
+            segment->free_flag = true;
+
+            reclaimed = retire(root_segment, segment, &deferred);
+        }
+
+        release_all(parent);
+
+        release_reclaimed(reclaimed, deferred);
+    }
+}
+
+void srsvm_mmu_free_force(srsvm_memory_segment *segment)
+{
+    release_segment(segment);
 }
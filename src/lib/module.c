@@ -1,5 +1,8 @@
+#include <stddef.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #if defined(__unix__)
 #include <unistd.h>
@@ -11,32 +14,131 @@
 
 #include "srsvm/debug.h"
 
+#include "srsvm/map.h"
 #include "srsvm/module.h"
 
 #define STR_HELPER(x) #x
 #define STR(x) STR_HELPER(x)
 
+/* Modules that enumerate their opcodes predate srsvm_opcode.flags and
+ * allocate the shorter struct, so only the fields before flags are read;
+ * the map holds a full-size copy with no flags set. */
 static bool load_opcode(void* arg, srsvm_opcode* opcode)
 {
     srsvm_module *mod = arg;
 
     bool success = false;
 
+    srsvm_opcode *copy = NULL;
+
     dbg_printf("got name %s", opcode->name);
     
     if(strlen(opcode->name) > 0 && opcode_lookup_by_name(mod->opcode_map, opcode->name) != NULL){
         dbg_puts("duplicate name");
     } else if(opcode_lookup_by_code(mod->opcode_map, opcode->code) != NULL){
         dbg_puts("duplicate code");
-    } else if(! opcode_map_insert(mod->opcode_map, opcode)) {
-        dbg_puts("insert failed");
+    } else if((copy = malloc(sizeof(srsvm_opcode))) == NULL){
+        dbg_puts("failed to alloc opcode");
     } else {
-        success = true;
+        memcpy(copy, opcode, offsetof(srsvm_opcode, flags));
+        copy->flags = 0;
+
+        if(! opcode_map_insert(mod->opcode_map, copy)) {
+            dbg_puts("insert failed");
+            free(copy);
+        } else {
+            free(opcode);
+            success = true;
+        }
     }
 
     return success;
 }
 
+#define BUILTIN_TABLE_HELPER(mod, ws) srsvm_builtin_ ## mod ## _opcode_table_ ## ws
+#define BUILTIN_TABLE(mod, ws) BUILTIN_TABLE_HELPER(mod, ws)
+
+#if defined(SRSVM_BUILTIN_MOD_MATH)
+extern const srsvm_opcode_table BUILTIN_TABLE(math, WORD_SIZE);
+#endif
+#if defined(SRSVM_BUILTIN_MOD_CONVERSION)
+extern const srsvm_opcode_table BUILTIN_TABLE(conversion, WORD_SIZE);
+#endif
+
+static const struct
+{
+    const char* name;
+    const srsvm_opcode_table *table;
+} builtin_modules[] = {
+#if defined(SRSVM_BUILTIN_MOD_MATH)
+    { "math", &BUILTIN_TABLE(math, WORD_SIZE) },
+#endif
+#if defined(SRSVM_BUILTIN_MOD_CONVERSION)
+    { "conversion", &BUILTIN_TABLE(conversion, WORD_SIZE) },
+#endif
+    { NULL, NULL }
+};
+
+static const srsvm_opcode_table *builtin_lookup(const char* name)
+{
+    for(size_t i = 0; builtin_modules[i].name != NULL; i++){
+        if(strcmp(builtin_modules[i].name, name) == 0){
+            return builtin_modules[i].table;
+        }
+    }
+
+    return NULL;
+}
+
+bool srsvm_module_is_builtin(const char* name)
+{
+    return name != NULL && builtin_lookup(name) != NULL;
+}
+
+srsvm_module *srsvm_module_alloc_builtin(const char* name, srsvm_word id)
+{
+    srsvm_module *mod = NULL;
+
+    const srsvm_opcode_table *table = name != NULL ? builtin_lookup(name) : NULL;
+
+    if(table != NULL && strlen(name) < SRSVM_MODULE_MAX_NAME_LEN){
+        mod = malloc(sizeof(srsvm_module));
+
+        if(mod != NULL){
+            mod->ref_count = 1;
+            mod->id = id;
+
+            mod->tag = NULL;
+
+            mod->handle = NULL;
+            mod->builtin = true;
+
+            srsvm_strncpy(mod->name, name, sizeof(mod->name));
+
+            mod->opcode_map = srsvm_opcode_map_alloc();
+
+            if(mod->opcode_map == NULL){
+                dbg_puts("failed to alloc opcode map");
+                goto error_cleanup;
+            } else if(! opcode_map_insert_table(mod->opcode_map, table)){
+                dbg_puts("failed to load opcodes");
+                goto error_cleanup;
+            }
+
+            dbg_printf("builtin mod %s loaded", name);
+        }
+    }
+
+    return mod;
+
+error_cleanup:
+    if(mod != NULL){
+        srsvm_module_free(mod);
+    }
+
+    return NULL;
+}
+
 srsvm_module *srsvm_module_alloc(const char* name, const char* filename, srsvm_word id)
 {
     srsvm_module *mod = NULL;
@@ -49,6 +151,9 @@ srsvm_module *srsvm_module_alloc(const char* name, const char* filename, srsvm_w
 
         mod->tag = NULL;
 
+        mod->opcode_map = NULL;
+        mod->builtin = false;
+
         if(strlen(name) < SRSVM_MODULE_MAX_NAME_LEN){
 			srsvm_strncpy(mod->name, name, sizeof(mod->name));
 
@@ -61,10 +166,17 @@ srsvm_module *srsvm_module_alloc(const char* name, const char* filename, srsvm_w
                 }
 
                 mod->opcode_map = srsvm_opcode_map_alloc();
+
+                const srsvm_opcode_table *table = srsvm_native_module_opcode_table(&mod->handle);
                 
                 if(mod->opcode_map == NULL){
 					dbg_puts("failed to alloc opcode map");
                     goto error_cleanup;
+                } else if(table != NULL){
+                    if(! opcode_map_insert_table(mod->opcode_map, table)){
+                        dbg_puts("failed to load opcode table");
+                        goto error_cleanup;
+                    }
                 } else if(! srsvm_native_module_load_opcodes(&mod->handle, load_opcode, mod)){
 					dbg_puts("failed to load opcodes");
                     goto error_cleanup;
@@ -92,7 +204,7 @@ void srsvm_module_free(srsvm_module *mod)
 {
     if(mod != NULL){
         if(mod->opcode_map != NULL) srsvm_opcode_map_free(mod->opcode_map);
-        srsvm_native_module_unload(mod->handle);
+        if(! mod->builtin) srsvm_native_module_unload(mod->handle);
         free(mod);
     }
 }
@@ -376,3 +488,409 @@ char* srsvm_module_find(const char* module_name, const char* prog_cwd, char** se
 
     return module_path;
 }
+
+#define MODULE_PATH_CACHE_MAGIC "srsvm-module-paths"
+#define MODULE_PATH_CACHE_VERSION 1
+#define MODULE_PATH_CACHE_LINE_MAX 4096
+
+/* Indexed by whether the multilib directories were searched. */
+typedef struct
+{
+    char *path[2];
+    uint64_t mtime[2];
+} module_path_cache_entry;
+
+struct srsvm_module_path_cache
+{
+    srsvm_lock lock;
+
+    srsvm_string_map *entries;
+
+    char *cache_dir;
+
+    /* names the cache file for the working directory and search path the
+     * entries belong to */
+    char *key;
+    char *file_path;
+    uint64_t stamp;
+
+    /* bumped whenever the entries are swapped for another key */
+    size_t generation;
+    bool dirty;
+};
+
+static uint64_t fnv1a(uint64_t hash, const void* data, const size_t size)
+{
+    const unsigned char *bytes = data;
+
+    for(size_t i = 0; i < size; i++){
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+#define FNV1A_INIT 0xcbf29ce484222325ULL
+
+static uint64_t stamp_directory(uint64_t stamp, const char* dir)
+{
+    uint64_t mtime = 0;
+
+    srsvm_file_mtime(dir, &mtime);
+
+    stamp = fnv1a(stamp, dir, strlen(dir) + 1);
+
+    return fnv1a(stamp, &mtime, sizeof(mtime));
+}
+
+static uint64_t stamp_search_dir(uint64_t stamp, const char* dir)
+{
+    char *subdir;
+
+    stamp = stamp_directory(stamp, dir);
+
+    if((subdir = srsvm_path_combine(dir, "multilib")) != NULL){
+        stamp = stamp_directory(stamp, subdir);
+        free(subdir);
+    }
+
+    if((subdir = srsvm_path_combine(dir, STR(WORD_SIZE))) != NULL){
+        stamp = stamp_directory(stamp, subdir);
+        free(subdir);
+    }
+
+    return stamp;
+}
+
+/* Adding or removing a module file changes the mtime of its directory, so
+ * this changes whenever srsvm_module_find could give a different answer. */
+static uint64_t search_path_stamp(char** search_path)
+{
+    uint64_t stamp = FNV1A_INIT;
+
+    for(size_t i = 0; search_path != NULL && search_path[i] != NULL; i++){
+        stamp = stamp_search_dir(stamp, search_path[i]);
+    }
+
+#if defined(__unix__)
+#if defined(SRSVM_LIB_DIR)
+    stamp = stamp_search_dir(stamp, SRSVM_LIB_DIR);
+#endif
+#if defined(SRSVM_USER_HOME_LIB_DIR)
+    const char* home_dir = getenv("HOME");
+
+    if(home_dir != NULL){
+        char *lib_dir = srsvm_path_combine(home_dir, SRSVM_USER_HOME_LIB_DIR);
+
+        if(lib_dir != NULL){
+            stamp = stamp_search_dir(stamp, lib_dir);
+            free(lib_dir);
+        }
+    }
+#endif
+#endif
+
+    return stamp;
+}
+
+static char *cache_key(const char* prog_cwd, char** search_path)
+{
+    uint64_t hash = FNV1A_INIT;
+
+    char *key = malloc(64);
+
+    if(key != NULL){
+        if(prog_cwd != NULL){
+            hash = fnv1a(hash, prog_cwd, strlen(prog_cwd));
+        }
+
+        hash = fnv1a(hash, "", 1);
+
+        for(size_t i = 0; search_path != NULL && search_path[i] != NULL; i++){
+            hash = fnv1a(hash, search_path[i], strlen(search_path[i]) + 1);
+        }
+
+        snprintf(key, 64, "modules-%d-%016llx", WORD_SIZE, (unsigned long long) hash);
+    }
+
+    return key;
+}
+
+static void path_cache_entry_free(const char* key, void* value, void* arg)
+{
+    module_path_cache_entry *entry = value;
+
+    if(entry != NULL){
+        if(entry->path[0] != NULL) free(entry->path[0]);
+        if(entry->path[1] != NULL) free(entry->path[1]);
+
+        free(entry);
+    }
+}
+
+static bool path_cache_set(srsvm_module_path_cache *cache, const char* module_name, const int i, const char* path, const uint64_t mtime)
+{
+    module_path_cache_entry *entry = srsvm_string_map_lookup(cache->entries, module_name);
+    char *path_copy = srsvm_strdup(path);
+
+    if(path_copy == NULL){
+        return false;
+    } else if(entry == NULL){
+        if((entry = calloc(1, sizeof(module_path_cache_entry))) == NULL){
+            free(path_copy);
+            return false;
+        } else if(! srsvm_string_map_insert(cache->entries, module_name, entry)){
+            free(entry);
+            free(path_copy);
+            return false;
+        }
+    }
+
+    if(entry->path[i] != NULL){
+        free(entry->path[i]);
+    }
+
+    entry->path[i] = path_copy;
+    entry->mtime[i] = mtime;
+
+    return true;
+}
+
+/* One entry per line: whether multilib was searched, the module file's
+ * mtime, the module name and its path, separated by tabs. */
+static void path_cache_load(srsvm_module_path_cache *cache, char** search_path)
+{
+    char line[MODULE_PATH_CACHE_LINE_MAX];
+    unsigned version;
+    unsigned long long stamp;
+
+    FILE *file;
+
+    cache->stamp = search_path_stamp(search_path);
+
+    if(cache->file_path == NULL || (file = fopen(cache->file_path, "r")) == NULL){
+        return;
+    }
+
+    if(fgets(line, sizeof(line), file) != NULL
+            && sscanf(line, MODULE_PATH_CACHE_MAGIC " %u %llx", &version, &stamp) == 2
+            && version == MODULE_PATH_CACHE_VERSION
+            && stamp == cache->stamp){
+        while(fgets(line, sizeof(line), file) != NULL){
+            char *newline = strchr(line, '\n');
+            char *name, *path, *end;
+            unsigned long long mtime;
+            int multilib;
+
+            if(newline == NULL){
+                break;
+            }
+
+            *newline = '\0';
+
+            if((name = strchr(line, '\t')) == NULL || (name = strchr(name + 1, '\t')) == NULL || (path = strchr(++name, '\t')) == NULL){
+                continue;
+            }
+
+            *path++ = '\0';
+
+            multilib = (int) strtol(line, &end, 10);
+            mtime = strtoull(end, &end, 10);
+
+            if((multilib == 0 || multilib == 1) && *end == '\t'){
+                path_cache_set(cache, name, multilib ? 0 : 1, path, mtime);
+            }
+        }
+    } else {
+        dbg_printf("discarding module path cache %s", cache->file_path);
+    }
+
+    fclose(file);
+}
+
+static void path_cache_write_entry(const char* key, void* value, void* arg)
+{
+    module_path_cache_entry *entry = value;
+
+    for(int i = 0; i < 2; i++){
+        if(entry->path[i] != NULL && strpbrk(entry->path[i], "\t\n") == NULL && strpbrk(key, "\t\n") == NULL){
+            fprintf(arg, "%d\t%llu\t%s\t%s\n", i == 0, (unsigned long long) entry->mtime[i], key, entry->path[i]);
+        }
+    }
+}
+
+/* Written beside the cache file and renamed over it, so a concurrent run
+ * reads either the old or the new cache in full. */
+static void path_cache_flush(srsvm_module_path_cache *cache)
+{
+    char *tmp_path;
+    size_t tmp_len;
+    FILE *file;
+
+    if(! cache->dirty || cache->file_path == NULL){
+        return;
+    }
+
+    tmp_len = strlen(cache->file_path) + 32;
+
+    if((tmp_path = malloc(tmp_len)) == NULL){
+        return;
+    }
+
+    snprintf(tmp_path, tmp_len, "%s.%lx", cache->file_path, (unsigned long) (uintptr_t) cache ^ (unsigned long) time(NULL));
+
+    if((file = fopen(tmp_path, "w")) != NULL){
+        fprintf(file, MODULE_PATH_CACHE_MAGIC " %u %016llx\n", MODULE_PATH_CACHE_VERSION, (unsigned long long) cache->stamp);
+
+        srsvm_string_map_walk(cache->entries, path_cache_write_entry, file);
+
+        if(fclose(file) == 0 && (rename(tmp_path, cache->file_path) == 0 || (remove(cache->file_path) == 0 && rename(tmp_path, cache->file_path) == 0))){
+            cache->dirty = false;
+        } else {
+            remove(tmp_path);
+        }
+    }
+
+    free(tmp_path);
+}
+
+static void path_cache_clear(srsvm_module_path_cache *cache)
+{
+    srsvm_string_map_walk(cache->entries, path_cache_entry_free, NULL);
+    srsvm_string_map_clear(cache->entries, false);
+
+    if(cache->key != NULL){
+        free(cache->key);
+        cache->key = NULL;
+    }
+
+    if(cache->file_path != NULL){
+        free(cache->file_path);
+        cache->file_path = NULL;
+    }
+
+    cache->dirty = false;
+}
+
+/* Called with the lock held. */
+static bool path_cache_select(srsvm_module_path_cache *cache, const char* prog_cwd, char** search_path)
+{
+    char *key = cache_key(prog_cwd, search_path);
+
+    if(key == NULL){
+        return false;
+    } else if(cache->key != NULL && strcmp(cache->key, key) == 0){
+        free(key);
+        return true;
+    }
+
+    path_cache_flush(cache);
+    path_cache_clear(cache);
+
+    cache->key = key;
+    cache->generation++;
+
+    if(cache->cache_dir != NULL){
+        cache->file_path = srsvm_path_combine(cache->cache_dir, key);
+    }
+
+    path_cache_load(cache, search_path);
+
+    return true;
+}
+
+srsvm_module_path_cache *srsvm_module_path_cache_alloc(void)
+{
+    srsvm_module_path_cache *cache = calloc(1, sizeof(srsvm_module_path_cache));
+
+    if(cache != NULL){
+        if(! srsvm_lock_initialize(&cache->lock)){
+            free(cache);
+            return NULL;
+        } else if((cache->entries = srsvm_string_map_alloc(false)) == NULL){
+            srsvm_lock_destroy(&cache->lock);
+            free(cache);
+            return NULL;
+        }
+
+        cache->cache_dir = srsvm_cache_directory();
+    }
+
+    return cache;
+}
+
+void srsvm_module_path_cache_free(srsvm_module_path_cache *cache)
+{
+    if(cache != NULL){
+        path_cache_flush(cache);
+        path_cache_clear(cache);
+
+        srsvm_string_map_free(cache->entries, false);
+
+        if(cache->cache_dir != NULL){
+            free(cache->cache_dir);
+        }
+
+        srsvm_lock_destroy(&cache->lock);
+
+        free(cache);
+    }
+}
+
+void srsvm_module_path_cache_save(srsvm_module_path_cache *cache)
+{
+    if(cache != NULL){
+        srsvm_lock_acquire(&cache->lock);
+        path_cache_flush(cache);
+        srsvm_lock_release(&cache->lock);
+    }
+}
+
+char* srsvm_module_path_cache_find(srsvm_module_path_cache *cache, const char* module_name, const char* prog_cwd, char** search_path, bool search_multilib)
+{
+    int i = search_multilib ? 0 : 1;
+
+    module_path_cache_entry *entry;
+    char *file_path = NULL;
+    size_t generation;
+    uint64_t mtime;
+
+    if(cache == NULL){
+        return srsvm_module_find(module_name, prog_cwd, search_path, search_multilib);
+    }
+
+    srsvm_lock_acquire(&cache->lock);
+
+    if(! path_cache_select(cache, prog_cwd, search_path)){
+        srsvm_lock_release(&cache->lock);
+
+        return srsvm_module_find(module_name, prog_cwd, search_path, search_multilib);
+    }
+
+    generation = cache->generation;
+
+    if((entry = srsvm_string_map_lookup(cache->entries, module_name)) != NULL && entry->path[i] != NULL){
+        if(srsvm_file_mtime(entry->path[i], &mtime) && mtime == entry->mtime[i]){
+            file_path = srsvm_strdup(entry->path[i]);
+        } else {
+            free(entry->path[i]);
+            entry->path[i] = NULL;
+            cache->dirty = true;
+        }
+    }
+
+    srsvm_lock_release(&cache->lock);
+
+    if(file_path == NULL && (file_path = srsvm_module_find(module_name, prog_cwd, search_path, search_multilib)) != NULL && srsvm_file_mtime(file_path, &mtime)){
+        srsvm_lock_acquire(&cache->lock);
+
+        if(cache->generation == generation && path_cache_set(cache, module_name, i, file_path, mtime)){
+            cache->dirty = true;
+        }
+
+        srsvm_lock_release(&cache->lock);
+    }
+
+    return file_path;
+}
@@ -1,3 +1,4 @@
+#include <ctype.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -7,6 +8,8 @@
 #include "srsvm/opcode.h"
 #include "srsvm/vm.h"
 
+#define NAME_INDEX_MIN_CAPACITY 64
+
 srsvm_opcode_map *srsvm_opcode_map_alloc(void)
 {
     srsvm_opcode_map *map;
@@ -15,73 +18,104 @@ srsvm_opcode_map *srsvm_opcode_map_alloc(void)
 
     if(map != NULL){
         srsvm_lock_initialize(&map->lock);
-        map->by_name_root = NULL;
-        map->by_code_root = NULL;
+        map->borrowed = false;
+        memset(map->by_code, 0, sizeof(map->by_code));
+        map->sparse = NULL;
+        map->num_sparse = 0;
+        map->by_name = NULL;
+        map->name_capacity = 0;
         map->count = 0;
     }
 
     return map;
 }
 
-void free_node(srsvm_opcode_map_node *node)
+void srsvm_opcode_map_free(srsvm_opcode_map *map)
 {
-    if(node != NULL){
-        if(node->code_lchild != NULL){
-            free_node(node->code_lchild);
+    if(map != NULL){
+        srsvm_lock_destroy(&map->lock);
+
+        for(unsigned ns = 0; ns < SRSVM_OPCODE_MAP_NAMESPACES; ns++){
+            if(map->by_code[ns].ops != NULL){
+                for(size_t id = 0; id < map->by_code[ns].size && ! map->borrowed; id++){
+                    if(map->by_code[ns].ops[id] != NULL){
+                        free(map->by_code[ns].ops[id]);
+                    }
+                }
+
+                free(map->by_code[ns].ops);
+            }
         }
 
-        if(node->code_rchild != NULL){
-            free_node(node->code_rchild);
+        for(size_t i = 0; i < map->num_sparse && ! map->borrowed; i++){
+            free(map->sparse[i]);
         }
 
-	free(node->opcode);
+        if(map->sparse != NULL) free(map->sparse);
+        if(map->by_name != NULL) free(map->by_name);
 
-        free(node);
+        free(map);
     }
 }
 
-void srsvm_opcode_map_free(srsvm_opcode_map *map)
+static size_t name_hash(const char* name)
 {
-    if(map != NULL){
-        srsvm_lock_destroy(&map->lock);
-
-        free_node(map->by_code_root);
+    size_t hash = 2166136261u;
 
-        free(map);
+    for(; *name != '\0'; name++){
+        hash ^= (unsigned char) tolower((unsigned char) *name);
+        hash *= 16777619u;
     }
+
+    return hash;
 }
 
-static srsvm_opcode_map_node *search_by_name(const srsvm_opcode_map *map, const char* opcode_name)
+static srsvm_opcode *search_by_name(const srsvm_opcode_map *map, const char* opcode_name)
 {
-    srsvm_opcode_map_node *node = map->by_name_root;
-    int cmp_result;
+    if(map->name_capacity == 0){
+        return NULL;
+    }
 
-    while(node != NULL){
-        cmp_result = srsvm_strcasecmp(opcode_name, node->opcode->name);
-        
-        if(cmp_result == 0){
-            return node;
-        } else if(cmp_result < 0){
-            node = node->name_lchild;
-        } else {
-            node = node->name_rchild;
+    size_t mask = map->name_capacity - 1;
+
+    for(size_t slot = name_hash(opcode_name) & mask; map->by_name[slot] != NULL; slot = (slot + 1) & mask){
+        if(srsvm_strcasecmp(opcode_name, map->by_name[slot]->name) == 0){
+            return map->by_name[slot];
         }
     }
 
     return NULL;
 }
 
-static srsvm_opcode_map_node *search_by_code(const srsvm_opcode_map *map, const srsvm_word opcode_code)
+static srsvm_opcode **search_sparse(const srsvm_opcode_map *map, const srsvm_word opcode_code)
 {
-    srsvm_opcode_map_node *node = map->by_code_root;
-    
-    while(node != NULL){
-        if(node->opcode->code == opcode_code){
-            return node;
-        } else if(node->opcode->code > opcode_code){
-            node = node->code_lchild;
+    size_t lo = 0, hi = map->num_sparse;
+
+    while(lo < hi){
+        size_t mid = lo + (hi - lo) / 2;
+
+        if(map->sparse[mid]->code < opcode_code){
+            lo = mid + 1;
         } else {
-            node = node->code_rchild;
+            hi = mid;
+        }
+    }
+
+    return &map->sparse[lo];
+}
+
+static srsvm_opcode *search_by_code(const srsvm_opcode_map *map, const srsvm_word opcode_code)
+{
+    const srsvm_opcode_map_namespace *ns = &map->by_code[OPCODE_NS(opcode_code)];
+    srsvm_word id = OPCODE_ID(opcode_code);
+
+    if(id < ns->size){
+        return ns->ops[(size_t) id];
+    } else if(id >= SRSVM_OPCODE_MAP_DENSE_MAX && map->num_sparse > 0){
+        srsvm_opcode **entry = search_sparse(map, opcode_code);
+
+        if(entry < map->sparse + map->num_sparse && (*entry)->code == opcode_code){
+            return *entry;
         }
     }
 
@@ -100,101 +134,184 @@ bool opcode_code_exists(const srsvm_opcode_map *map, const srsvm_word opcode_cod
 
 srsvm_opcode *opcode_lookup_by_name(const srsvm_opcode_map *map, const char* opcode_name)
 {
-    srsvm_opcode_map_node *node = search_by_name(map, opcode_name);
+    return search_by_name(map, opcode_name);
+}
 
-    if(node == NULL){
-        return NULL;
-    } else {
-        return node->opcode;
+srsvm_opcode *opcode_lookup_by_code(const srsvm_opcode_map *map, const srsvm_word opcode_code)
+{
+    return search_by_code(map, opcode_code);
+}
+
+static void name_index_place(srsvm_opcode **table, const size_t capacity, srsvm_opcode *opcode)
+{
+    size_t mask = capacity - 1;
+    size_t slot = name_hash(opcode->name) & mask;
+
+    while(table[slot] != NULL){
+        slot = (slot + 1) & mask;
     }
+
+    table[slot] = opcode;
 }
 
-srsvm_opcode *opcode_lookup_by_code(const srsvm_opcode_map *map, const srsvm_word opcode_code)
+static bool name_index_reserve(srsvm_opcode_map *map, const size_t count)
 {
-    srsvm_opcode_map_node *node = search_by_code(map, opcode_code);
+    if(count * 2 > map->name_capacity){
+        size_t capacity = map->name_capacity == 0 ? NAME_INDEX_MIN_CAPACITY : map->name_capacity * 2;
 
-    if(node == NULL){
-        return NULL;
+        while(count * 2 > capacity){
+            capacity *= 2;
+        }
+
+        srsvm_opcode **table = calloc(capacity, sizeof(srsvm_opcode*));
+
+        if(table == NULL){
+            return false;
+        }
+
+        for(size_t i = 0; i < map->name_capacity; i++){
+            if(map->by_name[i] != NULL){
+                name_index_place(table, capacity, map->by_name[i]);
+            }
+        }
+
+        if(map->by_name != NULL) free(map->by_name);
+
+        map->by_name = table;
+        map->name_capacity = capacity;
+    }
+
+    return true;
+}
+
+static bool name_index_insert(srsvm_opcode_map *map, srsvm_opcode *opcode)
+{
+    if(! name_index_reserve(map, map->count + 1)){
+        return false;
+    }
+
+    name_index_place(map->by_name, map->name_capacity, opcode);
+
+    return true;
+}
+
+static bool code_index_reserve(srsvm_opcode_map *map, const unsigned ns_index, const size_t min_size)
+{
+    srsvm_opcode_map_namespace *ns = &map->by_code[ns_index];
+
+    if(min_size > ns->size){
+        size_t size = ns->size == 0 ? 16 : ns->size;
+
+        while(size < min_size){
+            size *= 2;
+        }
+
+        srsvm_opcode **ops = realloc(ns->ops, size * sizeof(srsvm_opcode*));
+
+        if(ops == NULL){
+            return false;
+        }
+
+        memset(ops + ns->size, 0, (size - ns->size) * sizeof(srsvm_opcode*));
+
+        ns->ops = ops;
+        ns->size = size;
+    }
+
+    return true;
+}
+
+static bool code_index_insert(srsvm_opcode_map *map, srsvm_opcode *opcode)
+{
+    srsvm_opcode_map_namespace *ns = &map->by_code[OPCODE_NS(opcode->code)];
+    srsvm_word id = OPCODE_ID(opcode->code);
+
+    if(id < SRSVM_OPCODE_MAP_DENSE_MAX){
+        if(! code_index_reserve(map, OPCODE_NS(opcode->code), (size_t) id + 1)){
+            return false;
+        }
+
+        ns->ops[(size_t) id] = opcode;
     } else {
-        return node->opcode;
+        srsvm_opcode **sparse = realloc(map->sparse, (map->num_sparse + 1) * sizeof(srsvm_opcode*));
+
+        if(sparse == NULL){
+            return false;
+        }
+
+        map->sparse = sparse;
+
+        srsvm_opcode **entry = search_sparse(map, opcode->code);
+
+        memmove(entry + 1, entry, (size_t) (map->sparse + map->num_sparse - entry) * sizeof(srsvm_opcode*));
+        *entry = opcode;
+
+        map->num_sparse++;
     }
+
+    return true;
 }
 
 bool opcode_map_insert(srsvm_opcode_map *map, srsvm_opcode* opcode)
 {
     bool success = false;
 
+    bool has_name = strlen(opcode->name) > 0;
+
     if(search_by_code(map, opcode->code) != NULL){
 
-    } else if(strlen(opcode->name) > 0 && search_by_name(map, opcode->name) != NULL){
+    } else if(has_name && search_by_name(map, opcode->name) != NULL){
+
+    } else if(has_name && ! name_index_insert(map, opcode)){
+
+    } else if(! code_index_insert(map, opcode)){
 
     } else {
-        srsvm_opcode_map_node *node = malloc(sizeof(srsvm_opcode_map_node));
-        
-        if(node != NULL){
-            node->name_parent = NULL;
-            node->code_parent = NULL;
-            node->opcode = opcode;
-            node->name_lchild = NULL;
-            node->name_rchild = NULL;
-            node->code_lchild = NULL;
-            node->code_rchild = NULL;
-
-            if(strlen(opcode->name) > 0){
-                if(map->by_name_root == NULL){
-                    map->by_name_root = node;
-                } else {
-                    srsvm_opcode_map_node *parent_node = map->by_name_root;
-
-                    while(parent_node != NULL){
-                        int cmp_result = srsvm_strncasecmp(opcode->name, parent_node->opcode->name, sizeof(opcode->name));
-
-                        if(cmp_result < 0){
-                            if(parent_node->name_lchild == NULL){
-                                parent_node->name_lchild = node;
-                                break;
-                            } else parent_node = parent_node->name_lchild;
-                        } else {
-                            if(parent_node->name_rchild == NULL){
-                                parent_node->name_rchild = node;
-                                break;
-                            } else parent_node = parent_node->name_rchild;
-                        }
-                    }
+        map->count++;
 
-                    node->name_parent = parent_node;
-                }
-            }
+        success = true;
+    }
 
-            if(map->by_code_root == NULL){
-                map->by_code_root = node;
-            } else {
-                srsvm_opcode_map_node *parent_node = map->by_code_root;
-
-                while(parent_node != NULL){
-                    if(opcode->code < parent_node->opcode->code){
-                        if(parent_node->code_lchild == NULL){
-                            parent_node->code_lchild = node;
-                            break;
-                        } else parent_node = parent_node->code_lchild;
-                    } else {
-                        if(parent_node->code_rchild == NULL){
-                            parent_node->code_rchild = node;
-                            break;
-                        } else parent_node = parent_node->code_rchild;
-                    }
-                }
+    return success;
+}
 
-                node->code_parent = parent_node;
-            }
+bool opcode_map_insert_table(srsvm_opcode_map *map, const srsvm_opcode_table *table)
+{
+    size_t dense_size[SRSVM_OPCODE_MAP_NAMESPACES] = { 0 };
+
+    if(table->abi_version != SRSVM_OPCODE_TABLE_ABI_VERSION || map->count > 0){
+        return false;
+    }
 
-            map->count++;
+    for(size_t i = 0; i < table->count; i++){
+        unsigned ns = OPCODE_NS(table->opcodes[i].code);
+        srsvm_word id = OPCODE_ID(table->opcodes[i].code);
 
-            success = true;
+        if(id < SRSVM_OPCODE_MAP_DENSE_MAX && (size_t) id >= dense_size[ns]){
+            dense_size[ns] = (size_t) id + 1;
         }
     }
 
-    return success;
+    for(unsigned ns = 0; ns < SRSVM_OPCODE_MAP_NAMESPACES; ns++){
+        if(dense_size[ns] > 0 && ! code_index_reserve(map, ns, dense_size[ns])){
+            return false;
+        }
+    }
+
+    if(! name_index_reserve(map, table->count)){
+        return false;
+    }
+
+    map->borrowed = true;
+
+    for(size_t i = 0; i < table->count; i++){
+        if(! opcode_map_insert(map, (srsvm_opcode*) &table->opcodes[i])){
+            dbg_printf("failed to insert opcode %s", table->opcodes[i].name);
+            return false;
+        }
+    }
+
+    return true;
 }
 
 bool srsvm_opcode_load_instruction(srsvm_vm *vm, const srsvm_ptr addr, srsvm_instruction *instruction)
@@ -3,6 +3,8 @@
 #include <string.h>
 
 #include "srsvm/debug.h"
+#include "srsvm/decode.h"
+#include "srsvm/heap.h"
 #include "srsvm/mmu.h"
 #include "srsvm/opcode-helpers.h"
 #include "srsvm/module.h"
@@ -30,7 +32,7 @@ void builtin_HALT_ERR(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc,
 	srsvm_register *reg = register_lookup(vm, thread, &argv[0]);
 
 	if(reg != NULL){
-		if(reg->error_flag){
+		if(reg->flags->error_flag){
 			thread->is_halted = true;
 
 			if(argc == 1){
@@ -48,7 +50,7 @@ void builtin_ERR_FAULT_ENABLE(srsvm_vm *vm, srsvm_thread *thread, const srsvm_wo
 	srsvm_register *reg = register_lookup(vm, thread, &argv[0]);
 
 	if(reg != NULL){
-		reg->fault_on_error = true;
+		srsvm_register_set_fault_on_error(reg, true);
 	} else {
 		// TODO: fault
 	}
@@ -59,7 +61,7 @@ void builtin_ERR_FAULT_DISABLE(srsvm_vm *vm, srsvm_thread *thread, const srsvm_w
 	srsvm_register *reg = register_lookup(vm, thread, &argv[0]);
 
 	if(reg != NULL){
-		reg->fault_on_error = false;
+		srsvm_register_set_fault_on_error(reg, false);
 	} else {
 		// TODO: fault
 	}
@@ -74,34 +76,767 @@ void builtin_ALLOC(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, co
 		srsvm_word bytes = 0;
 
 		if(dest_reg != NULL && !fault_on_not_writable(thread, dest_reg) && resolve_arg_word(vm, thread, &argv[1], &bytes, true)){
-			srsvm_memory_segment *seg = srsvm_mmu_alloc_literal(vm->mem_root, bytes, 0);
+			srsvm_ptr addr;
 
-			if(seg != NULL){
-				if(! load_ptr(dest_reg, seg->literal_start, 0)){
-					set_register_error_bit(dest_reg, "Failed to copy address to register");
-					srsvm_mmu_free(seg);
+			if(srsvm_heap_get(vm->heap, &thread->heap_cache, bytes, &addr)){
+				if(! load_ptr(dest_reg, addr, 0)){
+					set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_COPY_ADDRESS, NULL);
+
+					srsvm_tlb_read_begin(&thread->tlb);
+
+					srsvm_memory_segment *seg = srsvm_tlb_locate(&thread->tlb, addr);
+
+					if(seg != NULL){
+						srsvm_heap_put(vm->heap, &thread->heap_cache, seg, addr);
+					}
+
+					srsvm_tlb_read_end(&thread->tlb);
 				}
 			} else {
-				set_register_error_bit(dest_reg, "Failed to allocate memory");
+				set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_ALLOC, NULL);
+			}
+
+		}
+	}
+}
+
+void builtin_FREE(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
+{
+	if(require_arg_type(vm, thread, &argv[0], SRSVM_ARG_TYPE_REGISTER)){
+
+		srsvm_register *addr_reg = register_lookup(vm, thread, &argv[0]);
+
+		if(addr_reg != NULL){
+			srsvm_tlb_read_begin(&thread->tlb);
+
+			srsvm_memory_segment *seg = srsvm_tlb_locate(&thread->tlb, addr_reg->value.ptr);
+
+			if(seg == NULL || ! srsvm_heap_put(vm->heap, &thread->heap_cache, seg, addr_reg->value.ptr)){
+				thread_set_fault(thread, "Attempt to free an unallocated address " PRINT_WORD_HEX, PRINTF_WORD_PARAM(addr_reg->value.ptr));
+			}
+
+			srsvm_tlb_read_end(&thread->tlb);
+		}
+	}
+}
+
+static srsvm_memory_segment *locate_region(srsvm_thread *thread, const srsvm_register *region_reg)
+{
+	srsvm_memory_segment *region = srsvm_tlb_locate(&thread->tlb, region_reg->value.ptr);
+
+	if(region == NULL || ! region->region){
+		thread_set_fault(thread, "Address " PRINT_WORD_HEX " does not belong to a region", PRINTF_WORD_PARAM(region_reg->value.ptr));
+
+		region = NULL;
+	}
+
+	return region;
+}
+
+void builtin_REGION_CREATE(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
+{
+	if(require_arg_type(vm, thread, &argv[0], SRSVM_ARG_TYPE_REGISTER)){
+
+		srsvm_register *dest_reg = register_lookup(vm, thread, &argv[0]);
+
+		srsvm_word bytes = 0;
+
+		if(dest_reg != NULL && !fault_on_not_writable(thread, dest_reg) && resolve_arg_word(vm, thread, &argv[1], &bytes, true)){
+			srsvm_ptr addr;
+
+			if(! srsvm_heap_region_create(vm->heap, bytes, &addr)){
+				set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_ALLOC, NULL);
+			} else if(! load_ptr(dest_reg, addr, 0)){
+				set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_COPY_ADDRESS, NULL);
+
+				srsvm_tlb_read_begin(&thread->tlb);
+
+				srsvm_memory_segment *region = srsvm_tlb_locate(&thread->tlb, addr);
+
+				if(region != NULL){
+					srsvm_heap_region_destroy(region);
+				}
+
+				srsvm_tlb_read_end(&thread->tlb);
+			}
+		}
+	}
+}
+
+void builtin_REGION_ALLOC(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
+{
+	if(require_arg_type(vm, thread, &argv[0], SRSVM_ARG_TYPE_REGISTER) && require_arg_type(vm, thread, &argv[1], SRSVM_ARG_TYPE_REGISTER)){
+
+		srsvm_register *dest_reg = register_lookup(vm, thread, &argv[0]);
+		srsvm_register *region_reg = register_lookup(vm, thread, &argv[1]);
+
+		srsvm_word bytes = 0;
+
+		if(dest_reg != NULL && region_reg != NULL && !fault_on_not_writable(thread, dest_reg) && resolve_arg_word(vm, thread, &argv[2], &bytes, true)){
+			srsvm_tlb_read_begin(&thread->tlb);
+
+			srsvm_memory_segment *region = locate_region(thread, region_reg);
+
+			srsvm_ptr addr;
+
+			if(region != NULL){
+				if(! srsvm_heap_region_alloc(region, bytes, &addr)){
+					set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_REGION_EXHAUSTED, NULL);
+				} else if(! load_ptr(dest_reg, addr, 0)){
+					set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_COPY_ADDRESS, NULL);
+				}
+			}
+
+			srsvm_tlb_read_end(&thread->tlb);
+		}
+	}
+}
+
+void builtin_REGION_RESET(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
+{
+	if(require_arg_type(vm, thread, &argv[0], SRSVM_ARG_TYPE_REGISTER)){
+
+		srsvm_register *region_reg = register_lookup(vm, thread, &argv[0]);
+
+		if(region_reg != NULL){
+			srsvm_tlb_read_begin(&thread->tlb);
+
+			srsvm_memory_segment *region = locate_region(thread, region_reg);
+
+			if(region != NULL){
+				srsvm_heap_region_reset(region);
+			}
+
+			srsvm_tlb_read_end(&thread->tlb);
+		}
+	}
+}
+
+void builtin_REGION_DESTROY(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
+{
+	if(require_arg_type(vm, thread, &argv[0], SRSVM_ARG_TYPE_REGISTER)){
+
+		srsvm_register *region_reg = register_lookup(vm, thread, &argv[0]);
+
+		if(region_reg != NULL){
+			srsvm_tlb_read_begin(&thread->tlb);
+
+			srsvm_memory_segment *region = locate_region(thread, region_reg);
+
+			if(region != NULL){
+				srsvm_heap_region_destroy(region);
+			}
+
+			srsvm_tlb_read_end(&thread->tlb);
+		}
+	}
+}
+
+/* The bulk memory opcodes check each range once up front and then work
+ * through it in runs that are contiguous in host memory, so a range may
+ * cover several adjacent allocations. */
+
+static char *mem_run(srsvm_thread *thread, const srsvm_ptr address, const bool write, srsvm_memory_segment **segment, srsvm_word *before, srsvm_word *after)
+{
+	char *host = NULL;
+
+	if((*segment = srsvm_tlb_locate(&thread->tlb, address)) != NULL){
+		host = srsvm_mmu_segment_span(*segment, address, write, before, after);
+	}
+
+	if(host == NULL){
+		thread_set_fault(thread, "Address " PRINT_WORD_HEX " is not %s", PRINTF_WORD_PARAM(address), write ? "writable" : "readable");
+	}
+
+	return host;
+}
+
+static bool mem_check(srsvm_thread *thread, srsvm_ptr address, srsvm_word bytes, const bool write)
+{
+	srsvm_memory_segment *segment;
+	srsvm_word before, after;
+
+	while(bytes > 0){
+		if(mem_run(thread, address, write, &segment, &before, &after) == NULL){
+			return false;
+		} else if(after >= bytes){
+			break;
+		}
+
+		address += after;
+		bytes -= after;
+	}
+
+	return true;
+}
+
+static void mem_written(srsvm_memory_segment *segment)
+{
+	if(segment->executable && segment->decode_cache != NULL){
+		srsvm_decode_cache_invalidate(segment->decode_cache);
+	}
+}
+
+/* A blocking opcode leaves its thread's decode read section while it waits,
+ * so that a waiting thread does not hold back reclamation of retired decode
+ * tables; argv must not be touched between the two. */
+static void decode_wait_begin(srsvm_thread *thread)
+{
+	srsvm_mmu_read_end(&thread->decode_reader);
+}
+
+static void decode_wait_end(srsvm_vm *vm, srsvm_thread *thread)
+{
+	srsvm_mmu_read_begin(vm->mem_root, &thread->decode_reader);
+}
+
+static size_t run_length(const srsvm_word bytes, const srsvm_word a, const srsvm_word b)
+{
+	srsvm_word length = bytes < a ? bytes : a;
+
+	if(b < length){
+		length = b;
+	}
+
+	return length > (srsvm_word) SIZE_MAX ? SIZE_MAX : (size_t) length;
+}
+
+void builtin_MEMCPY(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
+{
+	if(require_arg_type(vm, thread, &argv[0], SRSVM_ARG_TYPE_REGISTER) && require_arg_type(vm, thread, &argv[1], SRSVM_ARG_TYPE_REGISTER)){
+
+		srsvm_register *dest_reg = register_lookup(vm, thread, &argv[0]);
+		srsvm_register *src_reg = register_lookup(vm, thread, &argv[1]);
+
+		srsvm_word bytes = 0;
+
+		if(dest_reg != NULL && src_reg != NULL && resolve_arg_word(vm, thread, &argv[2], &bytes, true)){
+			srsvm_ptr dest = dest_reg->value.ptr;
+			srsvm_ptr src = src_reg->value.ptr;
+
+			/* Overlapping ranges with dest above src are copied from the end,
+			 * as memmove would. */
+			bool backward = dest > src && dest - src < bytes;
+
+			srsvm_tlb_read_begin(&thread->tlb);
+
+			if(mem_check(thread, src, bytes, false) && mem_check(thread, dest, bytes, true)){
+				srsvm_memory_segment *dest_segment, *src_segment;
+				srsvm_word dest_before, dest_after, src_before, src_after;
+
+				while(bytes > 0){
+					srsvm_ptr dest_addr = backward ? dest + bytes - 1 : dest;
+					srsvm_ptr src_addr = backward ? src + bytes - 1 : src;
+
+					char *dest_host = mem_run(thread, dest_addr, true, &dest_segment, &dest_before, &dest_after);
+					char *src_host = dest_host != NULL ? mem_run(thread, src_addr, false, &src_segment, &src_before, &src_after) : NULL;
+
+					if(src_host == NULL){
+						break;
+					}
+
+					size_t len;
+
+					if(backward){
+						len = run_length(bytes, dest_before + 1, src_before + 1);
+
+						memmove(dest_host + 1 - len, src_host + 1 - len, len);
+					} else {
+						len = run_length(bytes, dest_after, src_after);
+
+						memmove(dest_host, src_host, len);
+
+						dest += len;
+						src += len;
+					}
+
+					mem_written(dest_segment);
+
+					bytes -= len;
+				}
+			}
+
+			srsvm_tlb_read_end(&thread->tlb);
+		}
+	}
+}
+
+void builtin_MEMSET(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
+{
+	if(require_arg_type(vm, thread, &argv[0], SRSVM_ARG_TYPE_REGISTER)){
+
+		srsvm_register *dest_reg = register_lookup(vm, thread, &argv[0]);
+
+		srsvm_word value = 0;
+		srsvm_word bytes = 0;
+
+		if(dest_reg != NULL && resolve_arg_word(vm, thread, &argv[1], &value, true) && resolve_arg_word(vm, thread, &argv[2], &bytes, true)){
+			srsvm_ptr dest = dest_reg->value.ptr;
+
+			srsvm_tlb_read_begin(&thread->tlb);
+
+			if(mem_check(thread, dest, bytes, true)){
+				srsvm_memory_segment *segment;
+				srsvm_word before, after;
+
+				while(bytes > 0){
+					char *host = mem_run(thread, dest, true, &segment, &before, &after);
+
+					if(host == NULL){
+						break;
+					}
+
+					size_t len = run_length(bytes, after, after);
+
+					memset(host, (unsigned char) value, len);
+
+					mem_written(segment);
+
+					dest += len;
+					bytes -= len;
+				}
+			}
+
+			srsvm_tlb_read_end(&thread->tlb);
+		}
+	}
+}
+
+void builtin_MEMCMP(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
+{
+	if(require_arg_type(vm, thread, &argv[0], SRSVM_ARG_TYPE_REGISTER) && require_arg_type(vm, thread, &argv[1], SRSVM_ARG_TYPE_REGISTER) && require_arg_type(vm, thread, &argv[2], SRSVM_ARG_TYPE_REGISTER)){
+
+		srsvm_register *dest_reg = register_lookup(vm, thread, &argv[0]);
+		srsvm_register *a_reg = register_lookup(vm, thread, &argv[1]);
+		srsvm_register *b_reg = register_lookup(vm, thread, &argv[2]);
+
+		srsvm_word bytes = 0;
+
+		if(dest_reg != NULL && a_reg != NULL && b_reg != NULL && !fault_on_not_writable(thread, dest_reg) && resolve_arg_word(vm, thread, &argv[3], &bytes, true)){
+			srsvm_ptr a = a_reg->value.ptr;
+			srsvm_ptr b = b_reg->value.ptr;
+
+			int result = 0;
+
+			srsvm_tlb_read_begin(&thread->tlb);
+
+			bool success = mem_check(thread, a, bytes, false) && mem_check(thread, b, bytes, false);
+
+			if(success){
+				srsvm_memory_segment *segment;
+				srsvm_word before, a_after, b_after;
+
+				while(bytes > 0 && result == 0){
+					char *a_host = mem_run(thread, a, false, &segment, &before, &a_after);
+					char *b_host = a_host != NULL ? mem_run(thread, b, false, &segment, &before, &b_after) : NULL;
+
+					if(b_host == NULL){
+						success = false;
+						break;
+					}
+
+					size_t len = run_length(bytes, a_after, b_after);
+
+					result = memcmp(a_host, b_host, len);
+
+					a += len;
+					b += len;
+					bytes -= len;
+				}
+			}
+
+			srsvm_tlb_read_end(&thread->tlb);
+
+			if(success && ! load_i8(dest_reg, result < 0 ? -1 : result > 0, 0)){
+				set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_COPY_RESULT, NULL);
+			}
+		}
+	}
+}
+
+void builtin_MEMCHR(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
+{
+	if(require_arg_type(vm, thread, &argv[0], SRSVM_ARG_TYPE_REGISTER) && require_arg_type(vm, thread, &argv[1], SRSVM_ARG_TYPE_REGISTER)){
+
+		srsvm_register *dest_reg = register_lookup(vm, thread, &argv[0]);
+		srsvm_register *src_reg = register_lookup(vm, thread, &argv[1]);
+
+		srsvm_word value = 0;
+		srsvm_word bytes = 0;
+
+		if(dest_reg != NULL && src_reg != NULL && !fault_on_not_writable(thread, dest_reg) &&
+				resolve_arg_word(vm, thread, &argv[2], &value, true) && resolve_arg_word(vm, thread, &argv[3], &bytes, true)){
+			srsvm_ptr src = src_reg->value.ptr;
+
+			bool found = false;
+
+			srsvm_tlb_read_begin(&thread->tlb);
+
+			bool success = mem_check(thread, src, bytes, false);
+
+			if(success){
+				srsvm_memory_segment *segment;
+				srsvm_word before, after;
+
+				while(bytes > 0){
+					char *host = mem_run(thread, src, false, &segment, &before, &after);
+
+					if(host == NULL){
+						success = false;
+						break;
+					}
+
+					size_t len = run_length(bytes, after, after);
+
+					char *match = memchr(host, (unsigned char) value, len);
+
+					if(match != NULL){
+						src += (srsvm_word) (match - host);
+						found = true;
+						break;
+					}
+
+					src += len;
+					bytes -= len;
+				}
+			}
+
+			srsvm_tlb_read_end(&thread->tlb);
+
+			if(success){
+				if(! found){
+					set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_BYTE_NOT_FOUND, NULL);
+				} else if(! load_ptr(dest_reg, src, 0)){
+					set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_COPY_ADDRESS, NULL);
+				}
+			}
+		}
+	}
+}
+
+/* Copies bytes between guest memory and a host buffer. Must be called
+ * inside a read section. */
+static bool mem_transfer(srsvm_thread *thread, srsvm_ptr address, unsigned char *buf, srsvm_word bytes, const bool write)
+{
+	srsvm_memory_segment *segment;
+	srsvm_word before, after;
+
+	char *host = mem_run(thread, address, write, &segment, &before, &after);
+
+	if(host == NULL){
+		return false;
+	} else if(after >= bytes){
+		if(write){
+			memcpy(host, buf, (size_t) bytes);
+
+			mem_written(segment);
+		} else {
+			memcpy(buf, host, (size_t) bytes);
+		}
+
+		return true;
+	} else if(! mem_check(thread, address, bytes, write)){
+		return false;
+	}
+
+	while(bytes > 0){
+		if((host = mem_run(thread, address, write, &segment, &before, &after)) == NULL){
+			return false;
+		}
+
+		size_t len = run_length(bytes, after, after);
+
+		if(write){
+			memcpy(host, buf, len);
+
+			mem_written(segment);
+		} else {
+			memcpy(buf, host, len);
+		}
+
+		buf += len;
+		address += len;
+		bytes -= len;
+	}
+
+	return true;
+}
+
+enum value_transfer
+{
+	VALUE_SIZE,
+	VALUE_TO_REGISTER,
+	VALUE_FROM_REGISTER,
+};
+
+/* Moves one fixed-size value between a register and a host buffer, or with
+ * VALUE_SIZE only reports its size. Returns 0 for types that cannot be
+ * transferred (strings and invalid types) or on failure. */
+static size_t transfer_value(srsvm_register *reg, const srsvm_value_type type, unsigned char *buf, const enum value_transfer direction)
+{
+	switch(type){
+
+#define TRANSFER(name,flag,ctype) \
+		case SRSVM_TYPE_##flag: \
+		{ \
+			ctype value; \
+			if(direction == VALUE_TO_REGISTER){ \
+				memcpy(&value, buf, sizeof(ctype)); \
+				if(! load_##name(reg, value, 0)){ return 0; } \
+			} else if(direction == VALUE_FROM_REGISTER){ \
+				if(! reg_read_##name(reg, &value, 0)){ return 0; } \
+				memcpy(buf, &value, sizeof(ctype)); \
+			} \
+			return sizeof(ctype); \
+		}
+
+		TRANSFER(word, WORD, srsvm_word);
+		TRANSFER(ptr, PTR, srsvm_ptr);
+		TRANSFER(ptr_offset, PTR_OFFSET, srsvm_ptr_offset);
+		TRANSFER(bit, BIT, bool);
+		TRANSFER(u8, U8, uint8_t);
+		TRANSFER(i8, I8, int8_t);
+		TRANSFER(u16, U16, uint16_t);
+		TRANSFER(i16, I16, int16_t);
+#if WORD_SIZE == 32 || WORD_SIZE == 64 || WORD_SIZE == 128
+		TRANSFER(u32, U32, uint32_t);
+		TRANSFER(i32, I32, int32_t);
+		TRANSFER(f32, F32, float);
+#endif
+#if WORD_SIZE == 64 || WORD_SIZE == 128
+		TRANSFER(u64, U64, uint64_t);
+		TRANSFER(i64, I64, int64_t);
+		TRANSFER(f64, F64, double);
+#endif
+#if WORD_SIZE == 128
+		TRANSFER(u128, U128, unsigned __int128);
+		TRANSFER(i128, I128, __int128);
+#endif
+#undef TRANSFER
+		default:
+		return 0;
+	}
+}
+
+/* Resolves the type and value registers shared by the multi-register
+ * opcodes: argv[first] is the type and every argument after it names a
+ * register. */
+static size_t multi_registers(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[], const unsigned first, const bool load, srsvm_value_type *type, srsvm_register *regs[])
+{
+	srsvm_word type_word = 0;
+
+	if(! resolve_arg_word(vm, thread, &argv[first], &type_word, true)){
+		return 0;
+	}
+
+	*type = (srsvm_value_type) type_word;
+
+	size_t size = transfer_value(NULL, *type, NULL, VALUE_SIZE);
+
+	if(size == 0){
+		thread_set_fault(thread, "Attempt to transfer an invalid type " PRINT_WORD " to or from multiple registers", PRINTF_WORD_PARAM(type_word));
+
+		return 0;
+	}
+
+	for(unsigned i = first + 1; i < argc; i++){
+		if(! require_arg_type(vm, thread, &argv[i], SRSVM_ARG_TYPE_REGISTER) ||
+				(regs[i - first - 1] = register_lookup(vm, thread, &argv[i])) == NULL ||
+				(load && fault_on_not_writable(thread, regs[i - first - 1]))){
+			return 0;
+		}
+	}
+
+	return size;
+}
+
+static void multi_load(srsvm_thread *thread, srsvm_register *regs[], const unsigned count, const srsvm_value_type type, const size_t size, unsigned char *buf)
+{
+	for(unsigned i = 0; i < count; i++){
+		if(transfer_value(regs[i], type, buf + i * size, VALUE_TO_REGISTER) == 0){
+			thread_set_fault(thread, "Failed to load value into register %s", srsvm_register_name(regs[i]));
+
+			break;
+		}
+	}
+}
+
+static bool multi_store(srsvm_thread *thread, srsvm_register *regs[], const unsigned count, const srsvm_value_type type, const size_t size, unsigned char *buf)
+{
+	for(unsigned i = 0; i < count; i++){
+		if(transfer_value(regs[i], type, buf + i * size, VALUE_FROM_REGISTER) == 0){
+			thread_set_fault(thread, "Failed to read value from register %s", srsvm_register_name(regs[i]));
+
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Transfers one field per offset between base + offsets[i] and the buffer.
+ * When the fields all fall within one allocation it is translated once. */
+static bool mem_gather(srsvm_thread *thread, const srsvm_ptr base, const srsvm_word offsets[], const unsigned count, const size_t size, unsigned char *buf, const bool write)
+{
+	srsvm_memory_segment *segment;
+	srsvm_word before, after;
+
+	srsvm_word low = offsets[0];
+	srsvm_word high = offsets[0];
+
+	for(unsigned i = 1; i < count; i++){
+		if(offsets[i] < low){
+			low = offsets[i];
+		} else if(offsets[i] > high){
+			high = offsets[i];
+		}
+	}
+
+	char *host = mem_run(thread, base + low, write, &segment, &before, &after);
+
+	if(host == NULL){
+		return false;
+	} else if(high - low < after && size <= after - (high - low)){
+		for(unsigned i = 0; i < count; i++){
+			if(write){
+				memcpy(host + (size_t) (offsets[i] - low), buf + i * size, size);
+			} else {
+				memcpy(buf + i * size, host + (size_t) (offsets[i] - low), size);
 			}
+		}
+
+		if(write){
+			mem_written(segment);
+		}
+
+		return true;
+	}
+
+	for(unsigned i = 0; i < count; i++){
+		if(! mem_check(thread, base + offsets[i], size, write)){
+			return false;
+		}
+	}
 
+	for(unsigned i = 0; i < count; i++){
+		if(! mem_transfer(thread, base + offsets[i], buf + i * size, size, write)){
+			return false;
 		}
 	}
+
+	return true;
 }
 
-void builtin_FREE(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
+void builtin_LOAD_MULTI(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
 {
+	srsvm_register *regs[MAX_INSTRUCTION_ARGS];
+	unsigned char buf[MAX_INSTRUCTION_ARGS * sizeof(srsvm_word)];
+
 	if(require_arg_type(vm, thread, &argv[0], SRSVM_ARG_TYPE_REGISTER)){
 
 		srsvm_register *addr_reg = register_lookup(vm, thread, &argv[0]);
 
-		if(addr_reg != NULL){
-			srsvm_memory_segment *seg = srsvm_mmu_locate(vm->mem_root, addr_reg->value.ptr);
+		srsvm_value_type type;
+		size_t size;
 
-			if(seg != NULL){
-				srsvm_mmu_free(seg);
-			} else {
-				thread_set_fault(thread, "Attempt to free an unallocated address " PRINT_WORD_HEX, PRINTF_WORD_PARAM(addr_reg->value.ptr));
+		if(addr_reg != NULL && (size = multi_registers(vm, thread, argc, argv, 1, true, &type, regs)) > 0){
+			unsigned count = (unsigned) argc - 2;
+
+			srsvm_tlb_read_begin(&thread->tlb);
+
+			bool success = mem_transfer(thread, addr_reg->value.ptr, buf, count * size, false);
+
+			srsvm_tlb_read_end(&thread->tlb);
+
+			if(success){
+				multi_load(thread, regs, count, type, size, buf);
+			}
+		}
+	}
+}
+
+void builtin_STORE_MULTI(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
+{
+	srsvm_register *regs[MAX_INSTRUCTION_ARGS];
+	unsigned char buf[MAX_INSTRUCTION_ARGS * sizeof(srsvm_word)];
+
+	if(require_arg_type(vm, thread, &argv[0], SRSVM_ARG_TYPE_REGISTER)){
+
+		srsvm_register *addr_reg = register_lookup(vm, thread, &argv[0]);
+
+		srsvm_value_type type;
+		size_t size;
+
+		if(addr_reg != NULL && (size = multi_registers(vm, thread, argc, argv, 1, false, &type, regs)) > 0){
+			unsigned count = (unsigned) argc - 2;
+
+			if(multi_store(thread, regs, count, type, size, buf)){
+				srsvm_tlb_read_begin(&thread->tlb);
+
+				mem_transfer(thread, addr_reg->value.ptr, buf, count * size, true);
+
+				srsvm_tlb_read_end(&thread->tlb);
+			}
+		}
+	}
+}
+
+void builtin_GATHER(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
+{
+	srsvm_register *regs[MAX_INSTRUCTION_ARGS];
+	srsvm_word offsets[MAX_INSTRUCTION_ARGS];
+	unsigned char buf[MAX_INSTRUCTION_ARGS * sizeof(srsvm_word)];
+
+	if(require_arg_type(vm, thread, &argv[0], SRSVM_ARG_TYPE_REGISTER) && require_arg_type(vm, thread, &argv[1], SRSVM_ARG_TYPE_REGISTER)){
+
+		srsvm_register *base_reg = register_lookup(vm, thread, &argv[0]);
+		srsvm_register *offsets_reg = register_lookup(vm, thread, &argv[1]);
+
+		srsvm_value_type type;
+		size_t size;
+
+		if(base_reg != NULL && offsets_reg != NULL && (size = multi_registers(vm, thread, argc, argv, 2, true, &type, regs)) > 0){
+			unsigned count = (unsigned) argc - 3;
+
+			srsvm_tlb_read_begin(&thread->tlb);
+
+			bool success = mem_transfer(thread, offsets_reg->value.ptr, (unsigned char*) offsets, count * sizeof(srsvm_word), false) &&
+				mem_gather(thread, base_reg->value.ptr, offsets, count, size, buf, false);
+
+			srsvm_tlb_read_end(&thread->tlb);
+
+			if(success){
+				multi_load(thread, regs, count, type, size, buf);
+			}
+		}
+	}
+}
+
+void builtin_SCATTER(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
+{
+	srsvm_register *regs[MAX_INSTRUCTION_ARGS];
+	srsvm_word offsets[MAX_INSTRUCTION_ARGS];
+	unsigned char buf[MAX_INSTRUCTION_ARGS * sizeof(srsvm_word)];
+
+	if(require_arg_type(vm, thread, &argv[0], SRSVM_ARG_TYPE_REGISTER) && require_arg_type(vm, thread, &argv[1], SRSVM_ARG_TYPE_REGISTER)){
+
+		srsvm_register *base_reg = register_lookup(vm, thread, &argv[0]);
+		srsvm_register *offsets_reg = register_lookup(vm, thread, &argv[1]);
+
+		srsvm_value_type type;
+		size_t size;
+
+		if(base_reg != NULL && offsets_reg != NULL && (size = multi_registers(vm, thread, argc, argv, 2, false, &type, regs)) > 0){
+			unsigned count = (unsigned) argc - 3;
+
+			if(multi_store(thread, regs, count, type, size, buf)){
+				srsvm_tlb_read_begin(&thread->tlb);
+
+				if(mem_transfer(thread, offsets_reg->value.ptr, (unsigned char*) offsets, count * sizeof(srsvm_word), false)){
+					mem_gather(thread, base_reg->value.ptr, offsets, count, size, buf, true);
+				}
+
+				srsvm_tlb_read_end(&thread->tlb);
 			}
 		}
 	}
@@ -154,7 +889,7 @@ void builtin_LOAD(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, con
 
 #define LOADER(name,flag) \
 					case SRSVM_TYPE_##flag: \
-								if(! mem_load_##name(vm, dest_reg, src_addr, offset)){ \
+								if(! mem_load_##name(vm, thread, dest_reg, src_addr, offset)){ \
 									thread_set_fault(thread, "Failed to load from memory address " PRINT_WORD_HEX " into register", PRINTF_WORD_PARAM(src_addr)); \
 								}  \
 					break;
@@ -184,7 +919,7 @@ void builtin_LOAD(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, con
 					LOADER(str, STR);
 #undef LOADER
 					default:
-					thread_set_fault(thread, "Attempt to load an invalid type %u into register %s", type, dest_reg->name);
+					thread_set_fault(thread, "Attempt to load an invalid type %u into register %s", type, srsvm_register_name(dest_reg));
 					break;
 				}
 			}
@@ -218,8 +953,8 @@ void builtin_STORE(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, co
 
 #define LOADER(tname,flag) \
 					case SRSVM_TYPE_##flag: \
-								if(! mem_store_##tname(vm, src_reg, dest_addr, offset)){ \
-									thread_set_fault(thread, "Failed to store value from register %s into address " PRINT_WORD_HEX, src_reg->name, PRINTF_WORD_PARAM(dest_addr)); \
+								if(! mem_store_##tname(vm, thread, src_reg, dest_addr, offset)){ \
+									thread_set_fault(thread, "Failed to store value from register %s into address " PRINT_WORD_HEX, srsvm_register_name(src_reg), PRINTF_WORD_PARAM(dest_addr)); \
 								} \
 					break;
 
@@ -287,11 +1022,11 @@ void builtin_MOD_LOAD(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc,
 
 			if(mod != NULL){
 				if(! load_word(dest_reg, mod->id, 0)){
-					set_register_error_bit(dest_reg, "Failed to copy module ID to register");
+					set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_COPY_MODULE_ID, NULL);
 					srsvm_vm_unload_module(vm, mod);
 				}
 			} else {
-				set_register_error_bit(dest_reg, "Failed to load module");
+				set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_MODULE_LOAD, NULL);
 			}
 		}
 	}
@@ -310,11 +1045,11 @@ void builtin_CMOD_LOAD(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc
 
 			if(mod != NULL){
 				if(! load_word(dest_reg, mod->id, 0)){
-					set_register_error_bit(dest_reg, "Failed to copy module ID to register");
+					set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_COPY_MODULE_ID, NULL);
 					srsvm_vm_unload_module(vm, mod);
 				}
 			} else {
-				set_register_error_bit(dest_reg, "Failed to load module");
+				set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_MODULE_LOAD, NULL);
 			}
 		}
 	}
@@ -389,96 +1124,125 @@ void builtin_CMOD_UNLOAD(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word ar
 	}
 }
 
-void builtin_MOD_OP(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
+static srsvm_module *mod_op_module(srsvm_vm *vm, srsvm_thread *thread, const srsvm_arg *mod_arg)
 {
-	if(require_arg_type(vm, thread, &argv[0], SRSVM_ARG_TYPE_REGISTER | SRSVM_ARG_TYPE_CONSTANT) && 
-			require_arg_type(vm, thread, &argv[1], SRSVM_ARG_TYPE_WORD)){
+	srsvm_module *mod = NULL;
 
+	if(mod_arg->type == SRSVM_ARG_TYPE_REGISTER){
+		srsvm_register *mod_id_reg = register_lookup(vm, thread, mod_arg);
 
-		srsvm_module *mod = NULL;
+		if(mod_id_reg != NULL){
+			if(mod_id_reg->value.word > SRSVM_MODULE_MAX_COUNT){
+				thread_set_fault(thread, "Attempt to call invalid module ID " PRINT_WORD_HEX, PRINTF_WORD_PARAM(mod_id_reg->value.word));
+			} else {
+				mod = vm->modules[mod_id_reg->value.word];
+			}
 
+		} else {
+			// TODO: fault
+		}
+	} else if(mod_arg->type == SRSVM_ARG_TYPE_CONSTANT){
+		srsvm_word const_slot = mod_arg->value;
 
-		if(argv[0].type == SRSVM_ARG_TYPE_REGISTER){
-			srsvm_register *mod_id_reg = register_lookup(vm, thread, &argv[0]);
+		if(const_slot < SRSVM_CONST_MAX_COUNT && vm->constants[const_slot] != NULL && vm->constants[const_slot]->type == SRSVM_TYPE_STR){
+			const char* mod_name = vm->constants[const_slot]->str;
 
-			if(mod_id_reg != NULL){
-				if(mod_id_reg->value.word > SRSVM_MODULE_MAX_COUNT){
-					thread_set_fault(thread, "Attempt to call invalid module ID " PRINT_WORD_HEX, PRINTF_WORD_PARAM(mod_id_reg->value.word));
-				} else {
-					mod = vm->modules[mod_id_reg->value.word];
-				}
+			mod = srsvm_string_map_lookup(vm->module_map, mod_name);
+		} else {
+			// TODO: fault
+		}
+	}
 
-			} else {
-				// TODO: fault
-			}
-		} else if(argv[0].type == SRSVM_ARG_TYPE_CONSTANT){
-			srsvm_word const_slot = argv[0].value;
+	return mod;
+}
 
-			if(const_slot < SRSVM_CONST_MAX_COUNT && vm->constants[const_slot] != NULL && vm->constants[const_slot]->type == SRSVM_TYPE_STR){
-				const char* mod_name = vm->constants[const_slot]->str;
+static srsvm_opcode *mod_op_opcode(srsvm_vm *vm, srsvm_thread *thread, srsvm_module *mod, const srsvm_word mod_opcode, const srsvm_word shifted_argc)
+{
+	srsvm_opcode *opcode = NULL;
 
-				mod = srsvm_string_map_lookup(vm->module_map, mod_name);
-			} else {
-				// TODO: fault
-			}
+	if(mod != NULL){
+		opcode = srsvm_vm_load_module_opcode(vm, mod, mod_opcode);
+
+		if(opcode == NULL){
+			thread_set_fault(thread, "Failed to locate opcode " PRINT_WORD_HEX " in module %s", PRINTF_WORD_PARAM(mod_opcode), mod->name);
+		} else if(shifted_argc < opcode->argc_min || shifted_argc > opcode->argc_max){
+			thread_set_fault(thread, "Wrong number of arguments for module opcode: expected [" PRINT_WORD "," PRINT_WORD, "] found " PRINT_WORD, PRINTF_WORD_PARAM(opcode->argc_min), PRINTF_WORD_PARAM(opcode->argc_max), PRINTF_WORD_PARAM(shifted_argc));
+
+			opcode = NULL;
 		}
+	} else {
+		thread_set_fault(thread, "Attempt to run an opcode from an unloaded module");
+	}
 
+	return opcode;
+}
 
-		//srsvm_register *mod_opcode_reg = register_lookup(vm, thread, &argv[1]);
+static srsvm_opcode *mod_op_resolve(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
+{
+	if(require_arg_type(vm, thread, &argv[0], SRSVM_ARG_TYPE_REGISTER | SRSVM_ARG_TYPE_CONSTANT) && 
+			require_arg_type(vm, thread, &argv[1], SRSVM_ARG_TYPE_WORD)){
+		return mod_op_opcode(vm, thread, mod_op_module(vm, thread, &argv[0]), argv[1].value, argc - 2);
+	}
 
-		srsvm_word mod_opcode = argv[1].value;
+	return NULL;
+}
 
-		//if(resolve_arg_word(vm, thread, &argv[1], &mod_opcode, true)){
+void builtin_MOD_OP(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
+{
+	srsvm_opcode *opcode = mod_op_resolve(vm, thread, argc, argv);
 
-		srsvm_word shifted_argc = argc - 2;
+	if(opcode != NULL){
+		dbg_puts("calling mod func");
 
-		if(mod != NULL){
-			srsvm_opcode *opcode = srsvm_vm_load_module_opcode(vm, mod, mod_opcode);
+		opcode->func(vm, thread, argc - 2, argv + 2);
+	}
+}
 
-			if(opcode != NULL){
-				if(shifted_argc < opcode->argc_min || shifted_argc > opcode->argc_max){
-					thread_set_fault(thread, "Wrong number of arguments for module opcode: expected [" PRINT_WORD "," PRINT_WORD, "] found " PRINT_WORD, PRINTF_WORD_PARAM(opcode->argc_min), PRINTF_WORD_PARAM(opcode->argc_max), PRINTF_WORD_PARAM(shifted_argc));
-				} else {
-					dbg_puts("calling mod func");
+/* A MOD_OP call site is bound to the module opcode it first resolves to,
+ * keyed by the module ID register's value or the module name's constant
+ * slot, so that later calls skip the module and opcode lookups. */
+static void bound_MOD_OP(srsvm_vm *vm, srsvm_thread *thread, srsvm_decode_cache *cache, const srsvm_decoded_instruction *decoded)
+{
+	const srsvm_arg *argv = decoded->argv;
 
-					opcode->func(vm, thread, shifted_argc, argv + 2);
-				}
-			} else {
-				thread_set_fault(thread, "Failed to locate opcode " PRINT_WORD_HEX " in module %s", PRINTF_WORD_PARAM(mod_opcode), mod->name);
-			}
-		} else {
-			thread_set_fault(thread, "Attempt to run an opcode from an unloaded module");
+	srsvm_word key = argv[0].value;
+
+	if(argv[0].type == SRSVM_ARG_TYPE_REGISTER){
+		srsvm_register *mod_id_reg = register_lookup(vm, thread, &argv[0]);
+
+		if(mod_id_reg == NULL){
+			return;
 		}
+
+		key = mod_id_reg->value.word;
 	}
+
+	srsvm_atomic_counter generation = srsvm_atomic_load_acquire(&vm->module_generation);
+
+	srsvm_opcode *opcode = srsvm_decode_bound_opcode(decoded, key, generation);
+
+	if(opcode == NULL){
+		if((opcode = mod_op_resolve(vm, thread, decoded->argc, argv)) == NULL){
+			return;
+		}
+
+		srsvm_decode_cache_bind(cache, decoded, key, opcode, generation);
 	}
 
+	opcode->func(vm, thread, decoded->argc - 2, argv + 2);
+}
 
 	void builtin_CMOD_OP(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
 	{
 		srsvm_word mod_id = argv[0].value;
-		srsvm_word mod_opcode = argv[1].value;
-
-		srsvm_word shifted_argc = argc - 2;
 
 		if(mod_id > SRSVM_MODULE_MAX_COUNT){
 			thread_set_fault(thread, "Attempt to run an opcode from an invalid module");
 		} else {
-			srsvm_module *mod = vm->modules[mod_id];
+			srsvm_opcode *opcode = mod_op_opcode(vm, thread, vm->modules[mod_id], argv[1].value, argc - 2);
 
-			if(mod != NULL){
-				srsvm_opcode *opcode = srsvm_vm_load_module_opcode(vm, mod, mod_opcode);
-
-				if(opcode != NULL){
-					if(shifted_argc < opcode->argc_min || shifted_argc > opcode->argc_max){
-						thread_set_fault(thread, "Wrong number of arguments for module opcode: expected [" PRINT_WORD "," PRINT_WORD, "] found " PRINT_WORD, PRINTF_WORD_PARAM(opcode->argc_min), PRINTF_WORD_PARAM(opcode->argc_max), PRINTF_WORD_PARAM(shifted_argc));
-					} else {
-						opcode->func(vm, thread, shifted_argc, argv + 2);
-					}
-				} else {
-					thread_set_fault(thread, "Failed to locate opcode " PRINT_WORD_HEX " in module %s", PRINTF_WORD_PARAM(mod_opcode), mod->name);
-				}
-			} else {
-				thread_set_fault(thread, "Attempt to run an opcode from an unloaded module");
+			if(opcode != NULL){
+				opcode->func(vm, thread, argc - 2, argv + 2);
 			}
 		}
 	}
@@ -542,7 +1306,7 @@ void builtin_MOD_OP(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, c
 		srsvm_register *condition_reg = register_lookup(vm, thread, &argv[1]);
 
 		if(target_addr_reg != NULL && condition_reg != NULL){
-			if(condition_reg->error_flag){
+			if(condition_reg->flags->error_flag){
 				thread->next_PC = target_addr_reg->value.ptr;
 			}
 		}
@@ -554,7 +1318,7 @@ void builtin_MOD_OP(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, c
 		srsvm_register *condition_reg = register_lookup(vm, thread, &argv[1]);
 
 		if(target_off_reg != NULL && condition_reg != NULL){
-			if(condition_reg->error_flag){
+			if(condition_reg->flags->error_flag){
 				thread->next_PC = thread->PC + target_off_reg->value.ptr_offset;
 			}
 		}
@@ -601,7 +1365,11 @@ void builtin_MOD_OP(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, c
 
 		if(src_reg != NULL){
 			if(src_reg != NULL){
-				puts(src_reg->error_str);
+				char error_str[SRSVM_REGISTER_ERROR_STR_LEN];
+
+				srsvm_register_format_error(src_reg, error_str, sizeof(error_str));
+
+				puts(error_str);
 			}
 		}
 	}
@@ -658,7 +1426,11 @@ void builtin_MOD_OP(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, c
 		srsvm_word duration = 0;
 
 		if(resolve_arg_word(vm, thread, &argv[0], &duration, true)){
+			decode_wait_begin(thread);
+
 			srsvm_sleep(duration);
+
+			decode_wait_end(vm, thread);
 		}
 	}
 
@@ -688,7 +1460,7 @@ void builtin_MOD_OP(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, c
 		srsvm_ptr_offset offset = -1 * argv[0].value;
 		srsvm_register *cond_reg = register_lookup(vm, thread, &argv[1]);
 
-		if(cond_reg != NULL && cond_reg->error_flag){
+		if(cond_reg != NULL && cond_reg->flags->error_flag){
 			if(offset != 0){
 				thread->next_PC = thread->PC + offset;
 			}
@@ -744,7 +1516,7 @@ void builtin_MOD_OP(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, c
 				if(reg != NULL){
 					dest_reg->value.word = reg->index;
 				} else {
-					set_register_error_bit(dest_reg, "Failed to look up register '%s'", reg_name);
+					set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_REGISTER_LOOKUP, reg_name);
 				}
 			}
 		}
@@ -782,7 +1554,7 @@ void builtin_MOD_OP(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, c
 					dest_reg->value.word = mod->id;	
 				} else {
 					dbg_puts("failed to locate module");
-					set_register_error_bit(dest_reg, "Failed to look up module '%s'", mod_name);
+					set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_MODULE_LOOKUP, mod_name);
 				}
 			}
 		}
@@ -823,13 +1595,73 @@ void builtin_MOD_OP(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, c
 		srsvm_ptr_offset offset = argv[0].value;
 		srsvm_register *cond_reg = register_lookup(vm, thread, &argv[1]);
 
-		if(cond_reg != NULL && cond_reg->error_flag){
+		if(cond_reg != NULL && cond_reg->flags->error_flag){
 			if(offset != 0){
 				thread->next_PC = thread->PC + offset;
 			}
 		}
 	}
 
+	void builtin_CALL(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
+	{
+		srsvm_ptr target_addr;
+
+		if(! require_arg_type(vm, thread, &argv[0], SRSVM_ARG_TYPE_WORD | SRSVM_ARG_TYPE_REGISTER)){
+			return;
+		} else if(argv[0].type == SRSVM_ARG_TYPE_REGISTER){
+			srsvm_register *target_addr_reg = register_lookup(vm, thread, &argv[0]);
+
+			if(target_addr_reg == NULL){
+				return;
+			}
+
+			target_addr = target_addr_reg->value.ptr;
+		} else {
+			target_addr = argv[0].value;
+		}
+
+		if(! srsvm_call(vm, thread, target_addr)){
+			thread_set_fault(thread, "Failed to grow call stack");
+		}
+	}
+
+	void builtin_RET(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
+	{
+		if(! srsvm_ret(vm, thread)){
+			thread_set_fault(thread, "Attempted to return with an empty call stack");
+		}
+	}
+
+	void builtin_PUSH(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
+	{
+		srsvm_register *reg = register_lookup(vm, thread, &argv[0]);
+
+		if(reg != NULL){
+			if(reg->value.hnd != NULL){
+				thread_set_fault(thread, "Attempted to push a register holding a handle");
+			} else if(! srsvm_push(vm, thread, reg)){
+				thread_set_fault(thread, "Failed to push register %s", srsvm_register_name(reg));
+			}
+		}
+	}
+
+	void builtin_POP(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
+	{
+		srsvm_register *dest_reg = NULL;
+
+		if(argc == 1){
+			dest_reg = register_lookup(vm, thread, &argv[0]);
+
+			if(dest_reg == NULL || fault_on_not_writable(thread, dest_reg)){
+				return;
+			}
+		}
+
+		if(! srsvm_pop(vm, thread, dest_reg)){
+			thread_set_fault(thread, "Attempted to pop a register with none pushed in the current frame");
+		}
+	}
+
     void builtin_THREAD_JOIN(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[])
     {
         srsvm_register *thread_reg = NULL;
@@ -851,12 +1683,18 @@ void builtin_MOD_OP(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, c
                 thread_set_fault(thread, "Attempt to join invalid thread");
             } else {
                 srsvm_thread_exit_info *info = NULL;
-                
-                if(! srsvm_thread_join(thread_reg->value.hnd->thread, &info)){
+
+                decode_wait_begin(thread);
+
+                bool joined = srsvm_thread_join(thread_reg->value.hnd->thread, &info);
+
+                decode_wait_end(vm, thread);
+
+                if(! joined){
                     thread_set_fault(thread, "Failed to join thread");
                 } else if(dest_reg != NULL){
                     if(info->has_fault){
-                        set_register_error_bit(dest_reg, "joined thread: %s", info->fault_str);   
+                        set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_JOINED_THREAD, info->fault_str);   
                     } else {
                         load_ptr(dest_reg, info->ret, 0);
                     }
@@ -969,7 +1807,7 @@ void builtin_MOD_OP(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, c
                 hnd->has_error = true;
                 hnd->is_open = false;
 
-                set_register_error_bit(dest_reg, "Failed to initialize mutex");
+                set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_MUTEX_INIT, NULL);
             }
 
             load_handle(vm, dest_reg, hnd);
@@ -985,7 +1823,11 @@ void builtin_MOD_OP(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, c
             if(mut_reg->value.hnd->type != SRSVM_HANDLE_TYPE_MUTEX){
                 thread_set_fault(thread, "Attempted to lock a non-mutex handle");
             } else {
+                decode_wait_begin(thread);
+
                 srsvm_lock_acquire(&mut_reg->value.hnd->mutex);
+
+                decode_wait_end(vm, thread);
             }
         }
     }
@@ -1052,6 +1894,7 @@ void builtin_MOD_OP(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, c
                 op->argc_min = argc_min;
                 op->argc_max = argc_max;
                 op->func = func;
+                op->flags = 0;
 
                 if(! opcode_map_insert(map, op)){
 
@@ -1078,6 +1921,146 @@ void builtin_MOD_OP(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, c
 
 #undef REGISTER_OPCODE
 
+        srsvm_builtin_run_threaded(NULL, NULL, NULL, NULL);
+
         return success;
         }
 
+/* Define SRSVM_NO_COMPUTED_GOTO to build the portable switch dispatch. */
+#if (defined(__GNUC__) || defined(__clang__)) && ! defined(SRSVM_NO_COMPUTED_GOTO)
+#define SRSVM_COMPUTED_GOTO
+#endif
+
+#define SRSVM_BUILTIN_MAX_COUNT 256
+
+static srsvm_opcode_func *threaded_funcs[SRSVM_BUILTIN_MAX_COUNT];
+static const void *threaded_handlers[SRSVM_BUILTIN_MAX_COUNT];
+static size_t threaded_count = 0;
+
+const void *srsvm_builtin_threaded_handler(const srsvm_opcode *opcode)
+{
+	const void *handler = NULL;
+
+	for(size_t i = 0; i < threaded_count; i++){
+		if(threaded_funcs[i] == opcode->func){
+			handler = threaded_handlers[i];
+			break;
+		}
+	}
+
+#ifdef SRSVM_COMPUTED_GOTO
+	if(handler == NULL){
+		handler = threaded_handlers[threaded_count];
+	}
+#endif
+
+	return handler;
+}
+
+/* The slot is read only once fetch has seen its opcode published, after
+ * which it never changes; one without a handler is left for run_thread to
+ * execute through its opcode function. */
+#define THREADED_NEXT() do { \
+	if(thread->is_halted || thread->has_fault || vm->has_fault || srsvm_vm_check_register_faults(vm, thread)){ \
+		return; \
+	} \
+	srsvm_mmu_read_refresh(vm->mem_root, &thread->decode_reader); \
+	if(! srsvm_decode_cache_contains(cache, thread->next_PC) || (decoded = srsvm_decode_cache_fetch(vm, cache, thread->next_PC)) == NULL || decoded->handler == NULL){ \
+		return; \
+	} \
+	thread->PC = thread->next_PC; \
+	thread->next_PC = decoded->next_PC; \
+	THREADED_DISPATCH(); \
+} while(0)
+
+void srsvm_builtin_run_threaded(srsvm_vm *vm, srsvm_thread *thread, srsvm_decode_cache *cache, const srsvm_decoded_instruction *decoded)
+{
+#ifdef SRSVM_COMPUTED_GOTO
+	/* label addresses are only visible in here, so a NULL vm fills the handler table */
+	if(vm == NULL){
+		threaded_count = 0;
+
+		/* found ahead of MOD_OP's own entry */
+		threaded_funcs[threaded_count] = &builtin_MOD_OP;
+		threaded_handlers[threaded_count++] = &&threaded_bound_MOD_OP;
+
+#define REGISTER_OPCODE(c,n,a_min,a_max) do { \
+	threaded_funcs[threaded_count] = &builtin_##n; \
+	threaded_handlers[threaded_count++] = &&threaded_##n; \
+} while(0)
+
+#include "srsvm/opcodes-builtin.h"
+
+#undef REGISTER_OPCODE
+
+		threaded_funcs[threaded_count] = NULL;
+		threaded_handlers[threaded_count] = &&threaded_call;
+
+		return;
+	}
+
+#define THREADED_DISPATCH() goto *decoded->handler
+
+	THREADED_DISPATCH();
+
+#define REGISTER_OPCODE(c,n,a_min,a_max) threaded_##n: \
+	builtin_##n(vm, thread, decoded->argc, decoded->argv); \
+	THREADED_NEXT()
+
+#include "srsvm/opcodes-builtin.h"
+
+#undef REGISTER_OPCODE
+
+threaded_bound_MOD_OP:
+	bound_MOD_OP(vm, thread, cache, decoded);
+	THREADED_NEXT();
+
+threaded_call:
+	decoded->opcode->func(vm, thread, decoded->argc, decoded->argv);
+	THREADED_NEXT();
+
+#undef THREADED_DISPATCH
+#else
+	if(vm == NULL){
+		threaded_count = 0;
+
+#define REGISTER_OPCODE(c,n,a_min,a_max) do { \
+	threaded_funcs[threaded_count] = &builtin_##n; \
+	threaded_handlers[threaded_count] = &threaded_funcs[threaded_count]; \
+	threaded_count++; \
+} while(0)
+
+#include "srsvm/opcodes-builtin.h"
+
+#undef REGISTER_OPCODE
+
+		return;
+	}
+
+#define THREADED_DISPATCH() goto threaded_dispatch
+
+threaded_dispatch:
+	if(decoded->opcode->func == builtin_MOD_OP){
+		bound_MOD_OP(vm, thread, cache, decoded);
+	} else switch(decoded->opcode->code){
+#define REGISTER_OPCODE(c,n,a_min,a_max) case c: \
+		builtin_##n(vm, thread, decoded->argc, decoded->argv); \
+		break
+
+#include "srsvm/opcodes-builtin.h"
+
+#undef REGISTER_OPCODE
+
+		default:
+		decoded->opcode->func(vm, thread, decoded->argc, decoded->argv);
+		break;
+	}
+
+	THREADED_NEXT();
+
+#undef THREADED_DISPATCH
+#endif
+}
+
+#undef THREADED_NEXT
+
@@ -43,6 +43,10 @@ void srsvm_program_free_lmem(srsvm_literal_memory_specification *lmem)
             srsvm_program_free_lmem(lmem->next);
         }
 
+        if(lmem->chunk_offsets != NULL){
+            free(lmem->chunk_offsets);
+        }
+
         free(lmem);
     }
 }
@@ -57,6 +61,17 @@ void srsvm_program_free_const(srsvm_constant_specification *c)
         free(c);
     }
 }
+
+void srsvm_program_free_module(srsvm_module_specification *mod)
+{
+    if(mod != NULL){
+        if(mod->next != NULL){
+            srsvm_program_free_module(mod->next);
+        }
+
+        free(mod);
+    }
+}
 #endif
 
 void srsvm_program_free(srsvm_program *program)
@@ -66,6 +81,12 @@ void srsvm_program_free(srsvm_program *program)
             srsvm_program_free_metadata(program->metadata);
         }
 
+        srsvm_program_file_release(program->file);
+
+        if(program->sections != NULL){
+            free(program->sections);
+        }
+
 #if defined(WORD_SIZE)
         if(program->registers != NULL){
             srsvm_program_free_register(program->registers);
@@ -82,6 +103,10 @@ void srsvm_program_free(srsvm_program *program)
         if(program->constants != NULL){
             srsvm_program_free_const(program->constants);
         }
+
+        if(program->modules != NULL){
+            srsvm_program_free_module(program->modules);
+        }
 #endif
     }
 }
@@ -161,9 +186,209 @@ srsvm_constant_specification* srsvm_program_const_alloc(void)
 
     return c;
 }
+
+srsvm_module_specification* srsvm_program_module_alloc(void)
+{
+    srsvm_module_specification *mod = malloc(sizeof(srsvm_module_specification));
+
+    if(mod != NULL){
+        memset(mod, 0, sizeof(srsvm_module_specification));
+    }
+
+    return mod;
+}
+#endif
+
+typedef struct
+{
+    char *data;
+    size_t size;
+    size_t offset;
+} program_reader;
+
+/* Reads from the program file the way fread would, without a copy through
+ * a stdio buffer. */
+static size_t reader_read(void *dest, const size_t size, const size_t count, program_reader *reader)
+{
+    size_t available = size > 0 ? (reader->size - reader->offset) / size : count;
+    size_t read_count = count < available ? count : available;
+
+    memcpy(dest, reader->data + reader->offset, read_count * size);
+
+    reader->offset += read_count * size;
+
+    return read_count;
+}
+
+#if defined(SRSVM_PROGRAM_SUPPORT_SHEBANG)
+static char *reader_gets(char *dest, const size_t len, program_reader *reader)
+{
+    size_t i = 0;
+
+    if(len == 0 || reader->offset >= reader->size){
+        return NULL;
+    }
+
+    while(i + 1 < len && reader->offset < reader->size){
+        char c = reader->data[reader->offset++];
+
+        dest[i++] = c;
+
+        if(c == '\n'){
+            break;
+        }
+    }
+
+    dest[i] = '\0';
+
+    return dest;
+}
+#endif
+
+#if defined(WORD_SIZE)
+/* Returns the next bytes of the program file in place. */
+static void *reader_view(program_reader *reader, const size_t bytes)
+{
+    void *data = NULL;
+
+    if(reader->size - reader->offset >= bytes){
+        data = reader->data + reader->offset;
+
+        reader->offset += bytes;
+    }
+
+    return data;
+}
 #endif
 
-static bool deserialize_metadata(FILE *stream, srsvm_program *program)
+static srsvm_program_file *program_file_open(const char* program_path)
+{
+    srsvm_program_file *file = malloc(sizeof(srsvm_program_file));
+
+    if(file == NULL){
+        return NULL;
+    }
+
+    memset(file, 0, sizeof(srsvm_program_file));
+
+    file->refs = 1;
+
+    if((file->data = srsvm_file_map(program_path, &file->size)) != NULL){
+        file->mapped = true;
+
+        return file;
+    }
+
+    /* Not a regular file (a pipe, say); read it all instead. */
+    FILE *stream = fopen(program_path, "rb");
+
+    if(stream != NULL){
+        char buf[4096];
+        size_t read_bytes;
+
+        while((read_bytes = fread(buf, sizeof(char), sizeof(buf), stream)) > 0){
+            char *data = realloc(file->data, file->size + read_bytes);
+
+            if(data == NULL){
+                free(file->data);
+                file->data = NULL;
+                break;
+            }
+
+            memcpy(data + file->size, buf, read_bytes);
+
+            file->data = data;
+            file->size += read_bytes;
+        }
+
+        fclose(stream);
+    }
+
+    if(file->data == NULL){
+        free(file);
+        file = NULL;
+    }
+
+    return file;
+}
+
+srsvm_program_file *srsvm_program_file_acquire(srsvm_program_file *file)
+{
+    if(file != NULL){
+        srsvm_atomic_increment(&file->refs);
+    }
+
+    return file;
+}
+
+void srsvm_program_file_release(srsvm_program_file *file)
+{
+    if(file != NULL && srsvm_atomic_decrement(&file->refs) == 0){
+        if(file->mapped){
+            srsvm_file_unmap(file->data, file->size);
+        } else {
+            free(file->data);
+        }
+
+        free(file);
+    }
+}
+
+static unsigned magic_version(const char magic[3])
+{
+    if(memcmp(magic, SRSVM_PROGRAM_MAGIC, 3) == 0){
+        return 1;
+    } else if(memcmp(magic, SRSVM_PROGRAM_MAGIC_V2, 3) == 0){
+        return 2;
+    } else return 0;
+}
+
+static bool deserialize_section_table(program_reader *stream, srsvm_program *program, const uint64_t table_offset)
+{
+    if(table_offset > stream->size || (stream->size - table_offset) / SRSVM_PROGRAM_SECTION_ENTRY_SIZE < program->num_sections){
+        dbg_puts("Failed to load program: section table is truncated");
+        return false;
+    }
+
+    if(program->num_sections == 0){
+        return true;
+    } else if((program->sections = malloc(program->num_sections * sizeof(srsvm_program_section))) == NULL){
+        return false;
+    }
+
+    memset(program->sections, 0, program->num_sections * sizeof(srsvm_program_section));
+
+    stream->offset = (size_t) table_offset;
+
+    for(uint16_t i = 0; i < program->num_sections; i++){
+        srsvm_program_section *section = &program->sections[i];
+
+        if(reader_read(&section->type, sizeof(section->type), 1, stream) != 1){
+            return false;
+        } else if(reader_read(&section->flags, sizeof(section->flags), 1, stream) != 1){
+            return false;
+        } else if(reader_read(&section->count, sizeof(section->count), 1, stream) != 1){
+            return false;
+        } else if(reader_read(&section->offset, sizeof(section->offset), 1, stream) != 1){
+            return false;
+        } else if(reader_read(&section->size, sizeof(section->size), 1, stream) != 1){
+            return false;
+        } else if(reader_read(&section->original_size, sizeof(section->original_size), 1, stream) != 1){
+            return false;
+        } else if(reader_read(&section->checksum, sizeof(section->checksum), 1, stream) != 1){
+            return false;
+        } else if(reader_read(&section->address, sizeof(section->address), 1, stream) != 1){
+            return false;
+        } else if(section->offset > stream->size || section->size > stream->size - section->offset){
+            dbg_printf("Failed to load program: section %u lies outside the file", i);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool deserialize_metadata(program_reader *stream, srsvm_program *program)
 {
     bool success = false;
 
@@ -171,27 +396,28 @@ static bool deserialize_metadata(FILE *stream, srsvm_program *program)
 
     if(program != NULL){
         if(stream != NULL && (metadata = srsvm_program_metadata_alloc()) != NULL){
-            if(fread(&metadata->magic, sizeof(metadata->magic), 1, stream) != 1){
+            if(reader_read(&metadata->magic, sizeof(metadata->magic), 1, stream) != 1){
                 goto error_cleanup;
             }
 #if defined(SRSVM_PROGRAM_SUPPORT_SHEBANG)
             if(metadata->magic[0] == '#' && metadata->magic[1] == '!'){
                 strcpy(metadata->shebang, metadata->magic);
 
-                if(fgets(metadata->shebang + sizeof(metadata->magic), SRSVM_MAX_PATH_LEN - sizeof(metadata->magic), stream) != metadata->shebang + sizeof(metadata->magic)){
+                if(reader_gets(metadata->shebang + sizeof(metadata->magic), SRSVM_MAX_PATH_LEN - sizeof(metadata->magic), stream) != metadata->shebang + sizeof(metadata->magic)){
                     goto error_cleanup;
                 }
             
-                if(fread(&metadata->magic, sizeof(metadata->magic), 1, stream) != 1){
+                if(reader_read(&metadata->magic, sizeof(metadata->magic), 1, stream) != 1){
                     goto error_cleanup;
                 }
             }
 #endif
-            //if(strncmp(metadata->magic, "SRS", sizeof(metadata->magic)) != 0){
-            if(metadata->magic[0] != 'S' || metadata->magic[1] != 'R' || metadata->magic[2] != 'S'){
+            program->format_version = magic_version(metadata->magic);
+
+            if(program->format_version == 0){
 				dbg_puts("Failed to load program: wrong magic number\n");
                 goto error_cleanup;
-            } else if(fread(&metadata->word_size, sizeof(metadata->word_size), 1, stream) != 1){
+            } else if(reader_read(&metadata->word_size, sizeof(metadata->word_size), 1, stream) != 1){
                 goto error_cleanup;
             }
 #if defined(WORD_SIZE)
@@ -199,15 +425,39 @@ static bool deserialize_metadata(FILE *stream, srsvm_program *program)
                 dbg_printf("Failed to load program: wrong word size (expected %u, got %u)", WORD_SIZE, metadata->word_size);
                 goto error_cleanup;
             }
-
-            if(fread(&metadata->entry_point, sizeof(metadata->entry_point), 1, stream) < 1){
-                goto error_cleanup;
+#endif
+            if(program->format_version == 1){
+#if defined(WORD_SIZE)
+                if(reader_read(&metadata->entry_point, sizeof(metadata->entry_point), 1, stream) < 1){
+                    goto error_cleanup;
+                }
+#endif
+                success = true;
             } else {
+                uint64_t table_offset;
+                uint8_t entry_point[16];
+
+                if(reader_read(&program->format_version, sizeof(program->format_version), 1, stream) != 1){
+                    goto error_cleanup;
+                } else if(program->format_version < 2 || program->format_version > SRSVM_PROGRAM_FORMAT_VERSION){
+                    dbg_printf("Failed to load program: unsupported format version %u", program->format_version);
+                    goto error_cleanup;
+                } else if(reader_read(&program->num_sections, sizeof(program->num_sections), 1, stream) != 1){
+                    goto error_cleanup;
+                } else if(reader_read(&table_offset, sizeof(table_offset), 1, stream) != 1){
+                    goto error_cleanup;
+                } else if(reader_read(&entry_point, sizeof(entry_point), 1, stream) != 1){
+                    goto error_cleanup;
+                }
+#if defined(WORD_SIZE)
+                memcpy(&metadata->entry_point, entry_point, sizeof(metadata->entry_point));
+#endif
+                if(! deserialize_section_table(stream, program, table_offset)){
+                    goto error_cleanup;
+                }
+
                 success = true;
             }
-#else
-            success = true;
-#endif
         }
 
         if(success){
@@ -225,9 +475,24 @@ if(metadata != NULL){
 return false;
 }
 
+const srsvm_program_section *srsvm_program_find_section(const srsvm_program *program, const uint16_t type, const uint16_t index)
+{
+    uint16_t seen = 0;
+
+    if(program != NULL){
+        for(uint16_t i = 0; i < program->num_sections; i++){
+            if(program->sections[i].type == type && seen++ == index){
+                return &program->sections[i];
+            }
+        }
+    }
+
+    return NULL;
+}
+
 #if defined(WORD_SIZE)
 
-static bool deserialize_registers(FILE *stream, srsvm_program *program)
+static bool read_registers(program_reader *stream, srsvm_program *program)
 {
     bool success = false;
 
@@ -236,7 +501,7 @@ static bool deserialize_registers(FILE *stream, srsvm_program *program)
     bool claimed_slots[SRSVM_REGISTER_MAX_COUNT] = { false };
 
     if(stream != NULL && program != NULL){
-        if(fread(&program->num_registers, sizeof(program->num_registers), 1, stream) == 1){
+        if(program->registers == NULL){
             if(program->num_registers > SRSVM_REGISTER_MAX_COUNT){
                 goto error_cleanup;
             }
@@ -247,12 +512,12 @@ static bool deserialize_registers(FILE *stream, srsvm_program *program)
                 reg = srsvm_program_register_alloc();
 
                 if(reg != NULL){
-                    if(fread(&reg->name_len, sizeof(reg->name_len), 1, stream) != 1){
+                    if(reader_read(&reg->name_len, sizeof(reg->name_len), 1, stream) != 1){
                         goto error_cleanup;
-                    } else if(fread(&reg->name, sizeof(char), reg->name_len+1, stream) != reg->name_len+1){
+                    } else if(reader_read(&reg->name, sizeof(char), reg->name_len+1, stream) != reg->name_len+1){
                         dbg_puts("reg name short");
                         goto error_cleanup;
-                    //} else if(fread(&reg->index, sizeof(reg->index), 1, stream) != 1){
+                    //} else if(reader_read(&reg->index, sizeof(reg->index), 1, stream) != 1){
                       //  goto error_cleanup;
                     } else {
 			reg->index = i;
@@ -285,25 +550,32 @@ error_cleanup:
     return false;
 }
 
-static bool deserialize_vmem(FILE *stream, srsvm_program *program)
+static bool deserialize_registers(program_reader *stream, srsvm_program *program)
+{
+    if(stream != NULL && program != NULL && reader_read(&program->num_registers, sizeof(program->num_registers), 1, stream) == 1){
+        return read_registers(stream, program);
+    }
+
+    return false;
+}
+
+static bool read_vmem(program_reader *stream, srsvm_program *program)
 {
     bool success = false;
 
     srsvm_virtual_memory_specification *vmem = NULL, *last_vmem = NULL; 
 
     if(stream != NULL && program != NULL){
-        size_t read_result = fread(&program->num_vmem_segments, sizeof(program->num_vmem_segments), 1, stream);
-
-        if(read_result < 1){
+        if(program->virtual_memory != NULL){
             goto error_cleanup;
         } else {
             for(uint16_t i = 0; i < program->num_vmem_segments; i++){
                 vmem = srsvm_program_vmem_alloc();
 
                 if(vmem != NULL){
-                    if(fread(&vmem->start_address, sizeof(vmem->start_address), 1, stream) < 1){
+                    if(reader_read(&vmem->start_address, sizeof(vmem->start_address), 1, stream) < 1){
                         goto error_cleanup;
-                    } else if(fread(&vmem->size, sizeof(vmem->size), 1, stream) < 1){
+                    } else if(reader_read(&vmem->size, sizeof(vmem->size), 1, stream) < 1){
                         goto error_cleanup;
                     } else {
                         if(program->virtual_memory == NULL){
@@ -331,14 +603,99 @@ error_cleanup:
     return false;
 }
 
-static bool deserialize_lmem(FILE *stream, srsvm_program *program)
+static bool deserialize_vmem(program_reader *stream, srsvm_program *program)
+{
+    if(stream != NULL && program != NULL && reader_read(&program->num_vmem_segments, sizeof(program->num_vmem_segments), 1, stream) == 1){
+        return read_vmem(stream, program);
+    }
+
+    return false;
+}
+
+#if defined(SRSVM_SUPPORT_COMPRESSION)
+static bool read_chunk_table(srsvm_literal_memory_specification *lmem)
+{
+    program_reader reader = { lmem->data, lmem->compressed_size, 0 };
+
+    uint32_t chunk_size, num_chunks;
+
+    if(reader_read(&chunk_size, sizeof(chunk_size), 1, &reader) != 1){
+        return false;
+    } else if(reader_read(&num_chunks, sizeof(num_chunks), 1, &reader) != 1){
+        return false;
+    } else if(chunk_size == 0 || num_chunks != ((uint64_t) lmem->size + chunk_size - 1) / chunk_size){
+        dbg_puts("ERROR: chunks do not cover the literal memory segment");
+        return false;
+    } else if((lmem->chunk_offsets = malloc(((size_t) num_chunks + 1) * sizeof(size_t))) == NULL){
+        return false;
+    }
+
+    size_t table_end = reader.offset + ((size_t) num_chunks + 1) * sizeof(uint64_t);
+
+    for(uint32_t i = 0; i <= num_chunks; i++){
+        uint64_t offset;
+
+        if(reader_read(&offset, sizeof(offset), 1, &reader) != 1){
+            return false;
+        } else if(offset < (i > 0 ? lmem->chunk_offsets[i - 1] : table_end) || offset > lmem->compressed_size){
+            dbg_puts("ERROR: bad chunk offset");
+            return false;
+        }
+
+        lmem->chunk_offsets[i] = (size_t) offset;
+    }
+
+    lmem->chunk_size = chunk_size;
+    lmem->num_chunks = num_chunks;
+
+    return true;
+}
+#endif
+
+static bool load_lmem_data(srsvm_literal_memory_specification *lmem, void *stored_data, const bool chunked)
+{
+    lmem->data = stored_data;
+
+    if(! lmem->is_compressed){
+        /* Uncompressed data is used in place. */
+        lmem->file_backed = true;
+
+        return true;
+    }
+
+#if defined(SRSVM_SUPPORT_COMPRESSION)
+    /* Compressed data is inflated by the MMU the first time it is touched;
+     * unchunked data is a single chunk. */
+    lmem->deferred = true;
+
+    if(chunked){
+        return read_chunk_table(lmem);
+    } else if((lmem->chunk_offsets = malloc(2 * sizeof(size_t))) == NULL){
+        return false;
+    }
+
+    lmem->chunk_size = (size_t) lmem->size;
+    lmem->num_chunks = 1;
+
+    lmem->chunk_offsets[0] = 0;
+    lmem->chunk_offsets[1] = lmem->compressed_size;
+
+    return true;
+#else
+    dbg_puts("ERROR: Tried to load a program with compressed memory, which this implementation does not support");
+
+    return false;
+#endif
+}
+
+static bool deserialize_lmem(program_reader *stream, srsvm_program *program)
 {
     bool success = false;
 
     srsvm_literal_memory_specification *lmem = NULL, *last_lmem = NULL; 
 
     if(stream != NULL && program != NULL){
-        size_t read_result = fread(&program->num_lmem_segments, sizeof(program->num_lmem_segments), 1, stream);
+        size_t read_result = reader_read(&program->num_lmem_segments, sizeof(program->num_lmem_segments), 1, stream);
 
         if(read_result < 1){
             goto error_cleanup;
@@ -347,21 +704,21 @@ static bool deserialize_lmem(FILE *stream, srsvm_program *program)
                 lmem = srsvm_program_lmem_alloc();
 
                 if(lmem != NULL){
-                    if(fread(&lmem->start_address, sizeof(lmem->start_address), 1, stream) < 1){
+                    if(reader_read(&lmem->start_address, sizeof(lmem->start_address), 1, stream) < 1){
                         goto error_cleanup;
-                    } else if(fread(&lmem->size, sizeof(lmem->size), 1, stream) < 1){
+                    } else if(reader_read(&lmem->size, sizeof(lmem->size), 1, stream) < 1){
                         goto error_cleanup;
-                    } else if(fread(&lmem->is_compressed, sizeof(lmem->is_compressed), 1, stream) < 1){
+                    } else if(reader_read(&lmem->is_compressed, sizeof(lmem->is_compressed), 1, stream) < 1){
                         goto error_cleanup;
-                    } else if(fread(&lmem->compressed_size, sizeof(lmem->compressed_size), 1, stream) < 1){
+                    } else if(reader_read(&lmem->compressed_size, sizeof(lmem->compressed_size), 1, stream) < 1){
                         goto error_cleanup;
-                    } else if(fread(&lmem->readable, sizeof(lmem->readable), 1, stream) < 1){
+                    } else if(reader_read(&lmem->readable, sizeof(lmem->readable), 1, stream) < 1){
                         goto error_cleanup;
-                    } else if(fread(&lmem->writable, sizeof(lmem->writable), 1, stream) < 1){
+                    } else if(reader_read(&lmem->writable, sizeof(lmem->writable), 1, stream) < 1){
                         goto error_cleanup;
-                    } else if(fread(&lmem->executable, sizeof(lmem->readable), 1, stream) < 1){
+                    } else if(reader_read(&lmem->executable, sizeof(lmem->readable), 1, stream) < 1){
                         goto error_cleanup;
-                    } else if(fread(&lmem->locked, sizeof(lmem->locked), 1, stream) < 1){
+                    } else if(reader_read(&lmem->locked, sizeof(lmem->locked), 1, stream) < 1){
                         goto error_cleanup;
                     } else {
                         size_t read_bytes;
@@ -371,38 +728,12 @@ static bool deserialize_lmem(FILE *stream, srsvm_program *program)
                             read_bytes = (size_t) lmem->size;
                         }
 
-                        lmem->data = malloc(read_bytes);
-
-                        if(lmem->data == NULL){
-                            goto error_cleanup;
-                        }
+                        void *stored_data = reader_view(stream, read_bytes);
 
-                        if(fread(lmem->data, sizeof(char), read_bytes, stream) < read_bytes){
+                        if(stored_data == NULL || ! load_lmem_data(lmem, stored_data, false)){
                             goto error_cleanup;
                         }
 
-                        if(lmem->is_compressed){
-#if defined(SRSVM_SUPPORT_COMPRESSION)
-                            void *compressed_data = lmem->data;
-                            lmem->data = NULL;
-
-                            size_t compressed_size = (size_t) lmem->compressed_size;
-                            size_t original_size = (size_t) lmem->size;
-
-                            void *decompressed_data = srsvm_zlib_inflate(compressed_data, compressed_size, original_size);
-
-                            free(compressed_data);
-
-                            if(decompressed_data == NULL){
-                                goto error_cleanup;
-                            }
-
-                            lmem->data = decompressed_data;
-#else
-                            dbg_puts("ERROR: Tried to load a program with compressed memory, which this implementation does not support");
-                            goto error_cleanup;
-#endif
-                        }
                         if(program->literal_memory == NULL){
                             program->literal_memory = lmem;
                         } else {
@@ -427,7 +758,7 @@ error_cleanup:
     return false;
 }
 
-static bool deserialize_constants(FILE *stream, srsvm_program *program)
+static bool read_constants(program_reader *stream, srsvm_program *program)
 {
     bool success = false;
 
@@ -435,64 +766,29 @@ static bool deserialize_constants(FILE *stream, srsvm_program *program)
 
     bool claimed_slots[SRSVM_CONST_MAX_COUNT] = { false };
 
-    if(stream != NULL && program != NULL){
-        if(fread(&program->num_constants, sizeof(program->num_constants), 1, stream) != 1){
-            goto error_cleanup;
-        } else if(fread(&program->constants_compressed, sizeof(program->constants_compressed), 1, stream) != 1){
-            goto error_cleanup;
-        } else if(fread(&program->constants_original_size, sizeof(program->constants_original_size), 1, stream) != 1){
-            goto error_cleanup;
-        } else if(fread(&program->constants_compressed_size, sizeof(program->constants_compressed_size), 1, stream) != 1){
-            goto error_cleanup;
-        }
-
-        if(program->constants_compressed){
-#if defined(SRSVM_SUPPORT_COMPRESSION)
-            void *compressed_data = malloc(program->constants_compressed_size);
+    if(stream != NULL && program != NULL && program->constants == NULL){
+        for(uint16_t i = 0; i < program->num_constants; i++){
+            c = srsvm_program_const_alloc();
 
-            if(compressed_data == NULL){
-                goto error_cleanup;
-            } else if(fread(compressed_data, sizeof(char), program->constants_compressed_size, stream) != program->constants_compressed_size){
+            if(c == NULL){
                 goto error_cleanup;
             }
 
-            size_t compressed_size = program->constants_compressed_size;
-            size_t uncompressed_size = program->constants_original_size;
-
-            void *decompressed_data = srsvm_zlib_inflate(compressed_data, compressed_size, uncompressed_size);
-            
-            free(compressed_data);
-
-            if(decompressed_data == NULL){
+            if(reader_read(&c->const_slot, sizeof(c->const_slot), 1, stream) < 1){
                 goto error_cleanup;
-            }
-
-            size_t offset = 0;
-
-            for(uint16_t i = 0; i < program->num_constants; i++){
-                c = srsvm_program_const_alloc();
-
-                if(c == NULL){
-                    goto error_cleanup;
-                }
-
-                dbg_printf("i = %d\n", i);
-
-                memcpy(&c->const_slot, decompressed_data + offset, sizeof(c->const_slot));
-                if(c->const_slot > SRSVM_CONST_MAX_COUNT || claimed_slots[c->const_slot]){
-                    goto error_cleanup;
-                }
-                offset += sizeof(c->const_slot);
-
-                memcpy(&c->const_val.type, decompressed_data + offset, sizeof(c->const_val.type));
-                offset += sizeof(c->const_val.type);
-
-                switch(c->const_val.type){
+            } else if(c->const_slot > SRSVM_CONST_MAX_COUNT || claimed_slots[c->const_slot]){
+                goto error_cleanup;
+            } else if(reader_read(&c->const_val.type,  sizeof(c->const_val.type), 1, stream) < 1){
+                goto error_cleanup;
+            } else {
+                switch(c->const_val.type)
+                {
 
 #define LOADER(field,flag) case SRSVM_TYPE_##flag:\
-                    memcpy(&c->const_val.field, decompressed_data + offset, sizeof(c->const_val.field)); \
-                    offset += sizeof(c->const_val.field); \
-                    break;
+                    if(reader_read(&c->const_val.field, sizeof(c->const_val.field), 1, stream) < 1){ \
+                        goto error_cleanup; \
+                    } \
+                    break; 
 
                     LOADER(word, WORD);
                     LOADER(ptr, PTR);
@@ -518,19 +814,27 @@ static bool deserialize_constants(FILE *stream, srsvm_program *program)
 #endif
 #undef LOADER
                     case SRSVM_TYPE_STR:
-                    memcpy(&c->const_val.str_len, decompressed_data + offset, sizeof(c->const_val.str_len));
-                    offset += sizeof(c->const_val.str_len);
+                    if(reader_read(&c->const_val.str_len, sizeof(c->const_val.str_len), 1, stream) != 1){
+                        dbg_puts("ERROR: failed to read string length");
+                        goto error_cleanup;
+                    } else {
+                        char *tmp = malloc((c->const_val.str_len + 1) * sizeof(char));
 
-                    char *tmp = malloc((c->const_val.str_len + 1) * sizeof(char));
+                        if(tmp == NULL){
+                            goto error_cleanup;
+                        }
+                        
+                        memset(tmp, 0, (size_t) c->const_val.str_len + 1);
 
-                    if(tmp == NULL){
-                        goto error_cleanup;
-                    }
+                        if(reader_read(tmp, sizeof(char), (size_t) c->const_val.str_len, stream) != c->const_val.str_len){
+                            dbg_puts("ERROR: failed to read string");
 
-                    memset(tmp, 0, (size_t) c->const_val.str_len + 1);
-                    memcpy(tmp, decompressed_data + offset, (size_t) c->const_val.str_len);
-                    offset += c->const_val.str_len;
-                    c->const_val.str = (const char*) tmp;
+                            free(tmp);
+                            goto error_cleanup;
+                        }
+
+                        c->const_val.str = (const char*) tmp;
+                    }
                     break;
 
                     default:
@@ -546,119 +850,272 @@ static bool deserialize_constants(FILE *stream, srsvm_program *program)
                 last_c = c;
                 claimed_slots[c->const_slot] = true;
             }
+        }
 
-            success = true;
+        success = true;
+    }
+
+    return success;
+
+error_cleanup:
+    if(c != NULL){
+        srsvm_program_free_const(c);
+    }
+   
+    return false;
+}
+
+static bool deserialize_constants(program_reader *stream, srsvm_program *program)
+{
+    bool success = false;
+
+    if(stream != NULL && program != NULL){
+        if(reader_read(&program->num_constants, sizeof(program->num_constants), 1, stream) != 1){
+            return false;
+        } else if(reader_read(&program->constants_compressed, sizeof(program->constants_compressed), 1, stream) != 1){
+            return false;
+        } else if(reader_read(&program->constants_original_size, sizeof(program->constants_original_size), 1, stream) != 1){
+            return false;
+        } else if(reader_read(&program->constants_compressed_size, sizeof(program->constants_compressed_size), 1, stream) != 1){
+            return false;
+        }
+
+        if(program->constants_compressed){
+#if defined(SRSVM_SUPPORT_COMPRESSION)
+            void *compressed_data = reader_view(stream, program->constants_compressed_size);
+
+            if(compressed_data == NULL){
+                return false;
+            }
+
+            void *decompressed_data = srsvm_zlib_inflate(compressed_data, program->constants_compressed_size, program->constants_original_size);
 
-            free(decompressed_data);
+            if(decompressed_data != NULL){
+                program_reader constants_reader = { decompressed_data, program->constants_original_size, 0 };
+
+                success = read_constants(&constants_reader, program);
+
+                free(decompressed_data);
+            }
 #else
             dbg_puts("ERROR: Tried to load a program with compressed memory, which this implementation does not support");
-            goto error_cleanup;
 #endif
         } else {
-            for(uint16_t i = 0; i < program->num_constants; i++){
-                c = srsvm_program_const_alloc();
+            success = read_constants(stream, program);
+        }
+    }
 
-                if(c == NULL){
-                    goto error_cleanup;
-                }
+    return success;
+}
 
-                if(fread(&c->const_slot, sizeof(c->const_slot), 1, stream) < 1){
-                    goto error_cleanup;
-                } else if(c->const_slot > SRSVM_CONST_MAX_COUNT || claimed_slots[c->const_slot]){
-                    goto error_cleanup;
-                } else if(fread(&c->const_val.type,  sizeof(c->const_val.type), 1, stream) < 1){
-                    goto error_cleanup;
-                } else {
-                    switch(c->const_val.type)
-                    {
+static bool read_modules(program_reader *stream, srsvm_program *program)
+{
+    srsvm_module_specification *mod = NULL, *last_mod = NULL;
 
-#define LOADER(field,flag) case SRSVM_TYPE_##flag:\
-                        if(fread(&c->const_val.field, sizeof(c->const_val.field), 1, stream) < 1){ \
-                            goto error_cleanup; \
-                        } \
-                        break; 
-
-                        LOADER(word, WORD);
-                        LOADER(ptr, PTR);
-                        LOADER(ptr_offset, PTR_OFFSET);
-                        LOADER(bit, BIT);
-                        LOADER(u8, U8);
-                        LOADER(i8, I8);
-                        LOADER(u16, U16);
-                        LOADER(i16, I16);
-#if WORD_SIZE == 32 || WORD_SIZE == 64 || WORD_SIZE == 128
-                        LOADER(u32, U32);
-                        LOADER(i32, I32);
-                        LOADER(f32, F32);
-#endif
-#if WORD_SIZE == 64 || WORD_SIZE == 128
-                        LOADER(u64, U64);
-                        LOADER(i64, I64);
-                        LOADER(f64, F64);
+    if(program->modules != NULL){
+        return false;
+    }
+
+    for(uint16_t i = 0; i < program->num_modules; i++){
+        if((mod = srsvm_program_module_alloc()) == NULL){
+            goto error_cleanup;
+        } else if(reader_read(&mod->name_len, sizeof(mod->name_len), 1, stream) != 1){
+            goto error_cleanup;
+        } else if(mod->name_len >= sizeof(mod->name)){
+            goto error_cleanup;
+        } else if(reader_read(&mod->name, sizeof(char), mod->name_len+1, stream) != mod->name_len+1){
+            goto error_cleanup;
+        }
+
+        mod->name[mod->name_len] = 0;
+
+        if(program->modules == NULL){
+            program->modules = mod;
+        } else {
+            last_mod->next = mod;
+        }
+
+        last_mod = mod;
+    }
+
+    return true;
+
+error_cleanup:
+    if(mod != NULL){
+        srsvm_program_free_module(mod);
+    }
+
+    return false;
+}
+
+static uint32_t section_checksum(const void *data, const size_t size)
+{
+#if defined(SRSVM_SUPPORT_COMPRESSION)
+    return srsvm_zlib_crc32(data, size);
+#else
+    const unsigned char *bytes = data;
+    uint32_t crc = 0xFFFFFFFF;
+
+    for(size_t i = 0; i < size; i++){
+        crc ^= bytes[i];
+
+        for(int bit = 0; bit < 8; bit++){
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+
+    return ~crc;
 #endif
-#if WORD_SIZE == 128
-                        LOADER(u128, U128);
-                        LOADER(i128, I128);
+}
+
+static bool deserialize_section(program_reader *stream, srsvm_program *program, const srsvm_program_section *section, srsvm_literal_memory_specification **last_lmem)
+{
+    bool success = false;
+
+    void *payload = stream->data + section->offset;
+    void *decompressed_data = NULL;
+
+    program_reader section_reader = { payload, (size_t) section->size, 0 };
+
+    /* Literal memory can be most of the file, so its checksum is left for
+     * the first time the segment is inflated, or for srsvm_program_lmem_verify. */
+    if(section->type != SRSVM_SECTION_LMEM && section_checksum(payload, (size_t) section->size) != section->checksum){
+        dbg_printf("ERROR: checksum mismatch in section at offset %llu", (unsigned long long) section->offset);
+        return false;
+    } else if(section->type != SRSVM_SECTION_LMEM && section->count > UINT16_MAX){
+        return false;
+    }
+
+    unsigned codec = (section->flags & SRSVM_SECTION_CODEC_MASK) >> SRSVM_SECTION_CODEC_SHIFT;
+
+    if(section->type != SRSVM_SECTION_LMEM && (section->flags & SRSVM_SECTION_COMPRESSED)){
+#if defined(SRSVM_SUPPORT_COMPRESSION)
+        if((decompressed_data = srsvm_codec_decompress(codec, payload, (size_t) section->size, (size_t) section->original_size)) == NULL){
+            return false;
+        }
+
+        section_reader.data = decompressed_data;
+        section_reader.size = (size_t) section->original_size;
+#else
+        dbg_puts("ERROR: Tried to load a program with compressed memory, which this implementation does not support");
+        return false;
 #endif
-#undef LOADER
-                        case SRSVM_TYPE_STR:
-                        if(fread(&c->const_val.str_len, sizeof(c->const_val.str_len), 1, stream) != 1){
-                            dbg_puts("ERROR: failed to read string length");
-                            goto error_cleanup;
-                        } else {
-                            char *tmp = malloc((c->const_val.str_len + 1) * sizeof(char));
+    }
+
+    switch(section->type){
+        case SRSVM_SECTION_REGISTERS:
+            program->num_registers = (uint16_t) section->count;
+            success = read_registers(&section_reader, program);
+            break;
+
+        case SRSVM_SECTION_VMEM:
+            program->num_vmem_segments = (uint16_t) section->count;
+            success = read_vmem(&section_reader, program);
+            break;
+
+        case SRSVM_SECTION_CONSTANTS:
+            program->num_constants = (uint16_t) section->count;
+            program->constants_compressed = (section->flags & SRSVM_SECTION_COMPRESSED) != 0;
+            program->codec = (uint8_t) codec;
+            success = read_constants(&section_reader, program);
+            break;
+
+        case SRSVM_SECTION_MODULES:
+            program->num_modules = (uint16_t) section->count;
+            success = read_modules(&section_reader, program);
+            break;
+
+        case SRSVM_SECTION_LMEM:
+            {
+                /* An uncompressed segment is used in place, so it may not
+                 * claim more bytes than the checked payload holds. */
+                if(! (section->flags & SRSVM_SECTION_COMPRESSED) && section->original_size != section->size){
+                    dbg_printf("ERROR: literal memory section at offset %llu is %llu bytes but claims %llu", (unsigned long long) section->offset, (unsigned long long) section->size, (unsigned long long) section->original_size);
+                    break;
+                } else if((uint64_t) (srsvm_word) section->original_size != section->original_size){
+                    dbg_printf("ERROR: literal memory section at offset %llu is too large for this word size", (unsigned long long) section->offset);
+                    break;
+                }
 
-                            if(tmp == NULL){
-                                goto error_cleanup;
-                            }
-                            
-                            memset(tmp, 0, (size_t) c->const_val.str_len + 1);
+                srsvm_literal_memory_specification *lmem = srsvm_program_lmem_alloc();
 
-                            if(fread(tmp, sizeof(char), (size_t) c->const_val.str_len, stream) != c->const_val.str_len){
-                                dbg_puts("ERROR: failed to read string");
+                if(lmem == NULL){
+                    break;
+                }
 
-                                free(tmp);
-                                goto error_cleanup;
-                            }
+                memcpy(&lmem->start_address, section->address, sizeof(lmem->start_address));
+                lmem->size = (srsvm_word) section->original_size;
 
-                            c->const_val.str = (const char*) tmp;
-                        }
-                        break;
+                lmem->is_compressed = (section->flags & SRSVM_SECTION_COMPRESSED) != 0;
+                lmem->compressed_size = (size_t) section->size;
+                lmem->codec = (uint8_t) codec;
 
-                        default:
-                        goto error_cleanup;
-                    }
+                lmem->has_checksum = true;
+                lmem->checksum = section->checksum;
 
-                    if(program->constants == NULL){
-                        program->constants = c;
-                    } else {
-                        last_c->next = c;
-                    }
+                lmem->readable = (section->flags & SRSVM_SECTION_READABLE) != 0;
+                lmem->writable = (section->flags & SRSVM_SECTION_WRITABLE) != 0;
+                lmem->executable = (section->flags & SRSVM_SECTION_EXECUTABLE) != 0;
+                lmem->locked = (section->flags & SRSVM_SECTION_LOCKED) != 0;
+
+                if(! load_lmem_data(lmem, payload, (section->flags & SRSVM_SECTION_CHUNKED) != 0)){
+                    srsvm_program_free_lmem(lmem);
+                    break;
+                }
 
-                    last_c = c;
-                    claimed_slots[c->const_slot] = true;
+                if(*last_lmem == NULL){
+                    program->literal_memory = lmem;
+                } else {
+                    (*last_lmem)->next = lmem;
                 }
+
+                *last_lmem = lmem;
+
+                program->num_lmem_segments++;
+
+                success = true;
             }
+            break;
 
+        default:
+            dbg_printf("skipping unknown section type %u", section->type);
             success = true;
-        }
+            break;
+    }
+
+    if(decompressed_data != NULL){
+        free(decompressed_data);
     }
 
     return success;
+}
 
-error_cleanup:
-    if(c != NULL){
-        srsvm_program_free_const(c);
+bool srsvm_program_lmem_verify(const srsvm_literal_memory_specification *lmem)
+{
+    if(lmem->has_checksum && section_checksum(lmem->data, lmem->compressed_size) != lmem->checksum){
+        dbg_printf("ERROR: checksum mismatch in literal memory at " PRINT_WORD_HEX, PRINTF_WORD_PARAM(lmem->start_address));
+        return false;
     }
-   
-    return false;
-}
 
+    return true;
+}
 
-bool serialize_metadata(FILE *stream, const srsvm_program *program)
+static bool deserialize_sections(program_reader *stream, srsvm_program *program)
 {
-    bool success = false;
+    srsvm_literal_memory_specification *last_lmem = NULL;
+
+    for(uint16_t i = 0; i < program->num_sections; i++){
+        if(! deserialize_section(stream, program, &program->sections[i], &last_lmem)){
+            dbg_printf("ERROR: failed to deserialize section %u", i);
+            return false;
+        }
+    }
+
+    return true;
+}
 
+bool serialize_shebang(FILE *stream, const srsvm_program *program)
+{
 #if defined(SRSVM_PROGRAM_SUPPORT_SHEBANG)
     size_t shebang_len = strlen(program->metadata->shebang);
     char *writable_shebang = NULL;
@@ -682,26 +1139,32 @@ bool serialize_metadata(FILE *stream, const srsvm_program *program)
         free(writable_shebang);
     }
 #endif
-    if(fwrite(&program->metadata->magic, sizeof(program->metadata->magic), 1, stream) != 1){
-        goto error_cleanup;
-    } else if(fwrite(&program->metadata->word_size, sizeof(program->metadata->word_size), 1, stream) != 1){
-        goto error_cleanup;
-    } else if(fwrite(&program->metadata->entry_point, sizeof(program->metadata->entry_point), 1, stream) != 1){
-        goto error_cleanup;
-    }
-
-    success = true;
 
-    return success;
+    return true;
 
-error_cleanup:
 #if defined(SRSVM_PROGRAM_SUPPORT_SHEBANG)
+error_cleanup:
     if(writable_shebang != NULL){
         free(writable_shebang);
     }
-#endif
 
     return false;
+#endif
+}
+
+bool serialize_metadata(FILE *stream, const srsvm_program *program)
+{
+    if(! serialize_shebang(stream, program)){
+        return false;
+    } else if(fwrite(SRSVM_PROGRAM_MAGIC, sizeof(program->metadata->magic), 1, stream) != 1){
+        return false;
+    } else if(fwrite(&program->metadata->word_size, sizeof(program->metadata->word_size), 1, stream) != 1){
+        return false;
+    } else if(fwrite(&program->metadata->entry_point, sizeof(program->metadata->entry_point), 1, stream) != 1){
+        return false;
+    }
+
+    return true;
 }
 
 bool write_reg(FILE* stream, const srsvm_register_specification *reg)
@@ -719,6 +1182,19 @@ bool write_reg(FILE* stream, const srsvm_register_specification *reg)
     } else return write_reg(stream, reg->next);
 }
 
+bool write_module(FILE *stream, const srsvm_module_specification *mod)
+{
+    if(mod == NULL){
+        return true;
+    } else if(fwrite(&mod->name_len, sizeof(mod->name_len), 1, stream) != 1){
+        return false;
+    } else if(fwrite(&mod->name, sizeof(char), mod->name_len+1, stream) != (mod->name_len+1)){
+        return false;
+    } else if(mod->next == NULL){
+        return true;
+    } else return write_module(stream, mod->next);
+}
+
 bool serialize_registers(FILE *stream, const srsvm_program *program)
 {
     bool success = false;
@@ -758,60 +1234,140 @@ bool serialize_vmem(FILE *stream, const srsvm_program *program)
     return success;
 }
 
+#if defined(SRSVM_SUPPORT_COMPRESSION)
+/* Compresses every SRSVM_PROGRAM_CHUNK_SIZE bytes of a segment on their
+ * own, behind a table of where each chunk starts. */
+static void *lmem_chunked_data(const srsvm_literal_memory_specification *lmem, const unsigned codec, size_t *stored_size)
+{
+    size_t size = (size_t) lmem->size;
+
+    uint32_t chunk_size = SRSVM_PROGRAM_CHUNK_SIZE;
+    uint32_t num_chunks = (uint32_t) ((size + chunk_size - 1) / chunk_size);
+
+    size_t table_size = 2 * sizeof(uint32_t) + ((size_t) num_chunks + 1) * sizeof(uint64_t);
+    size_t stored_len = table_size;
+
+    char *stored = malloc(table_size);
+
+    if(stored == NULL){
+        return NULL;
+    }
+
+    memcpy(stored, &chunk_size, sizeof(chunk_size));
+    memcpy(stored + sizeof(chunk_size), &num_chunks, sizeof(num_chunks));
+
+    for(uint32_t i = 0; i <= num_chunks; i++){
+        uint64_t offset = stored_len;
+
+        memcpy(stored + 2 * sizeof(uint32_t) + i * sizeof(uint64_t), &offset, sizeof(offset));
+
+        if(i == num_chunks){
+            break;
+        }
+
+        size_t length = size - (size_t) i * chunk_size;
+
+        if(length > chunk_size){
+            length = chunk_size;
+        }
+
+        size_t compressed_size;
+        void *compressed_data = srsvm_codec_compress(codec, (char*) lmem->data + (size_t) i * chunk_size, &compressed_size, length);
+
+        char *grown = compressed_data != NULL ? realloc(stored, stored_len + compressed_size) : NULL;
+
+        if(grown == NULL){
+            if(compressed_data != NULL){
+                free(compressed_data);
+            }
+
+            free(stored);
+
+            return NULL;
+        }
+
+        stored = grown;
+
+        memcpy(stored + stored_len, compressed_data, compressed_size);
+        stored_len += compressed_size;
+
+        free(compressed_data);
+    }
+
+    *stored_size = stored_len;
+
+    return stored;
+}
+#endif
+
+/* Returns the bytes to store for a segment: its data, or a compressed copy
+ * that the caller must free. Only chunked data can use a codec other than
+ * zlib. */
+static void *lmem_stored_data(const srsvm_literal_memory_specification *lmem, const bool chunked, const unsigned codec, size_t *stored_size)
+{
+    if(lmem->is_compressed){
+#if defined(SRSVM_SUPPORT_COMPRESSION)
+        if(chunked){
+            return lmem_chunked_data(lmem, codec, stored_size);
+        }
+
+        return srsvm_zlib_deflate(lmem->data, stored_size, (size_t) lmem->size);
+#else
+        dbg_puts("ERROR: attempt to serialize a compressed memory segment");
+        return NULL;
+#endif
+    }
+
+    *stored_size = (size_t) lmem->size;
+
+    return lmem->data;
+}
+
 bool write_lmem(FILE *stream, const srsvm_literal_memory_specification *lmem)
 {
     if(lmem == NULL){
         return true;
     } else {
-            
-        size_t compressed_size = 0;
-        void* compressed_data = NULL;
+        bool success = false;
 
-        if(lmem->is_compressed){
-#if defined(SRSVM_SUPPORT_COMPRESSION)
-            compressed_data = srsvm_zlib_deflate(lmem->data, &compressed_size, (size_t) lmem->size);
+        size_t stored_size = 0;
+        void* stored_data = lmem_stored_data(lmem, false, SRSVM_CODEC_ZLIB, &stored_size);
 
-            if(compressed_data == NULL){
-                return false;
-            }
-#else
-            dbg_puts("ERROR: attempt to serialize a compressed memory segment");
+        size_t compressed_size = lmem->is_compressed ? stored_size : 0;
+
+        if(stored_data == NULL && lmem->size > 0){
             return false;
-#endif
         }
 
         if(fwrite(&lmem->start_address, sizeof(lmem->start_address), 1, stream) != 1){
-            return false;
+            success = false;
         } else if(fwrite(&lmem->size, sizeof(lmem->size), 1, stream) != 1){
-            return false;
+            success = false;
         } else if(fwrite(&lmem->is_compressed, sizeof(lmem->is_compressed), 1, stream) != 1){
-            return false;
+            success = false;
         } else if(fwrite(&compressed_size, sizeof(compressed_size), 1, stream) != 1){
-            return false;
+            success = false;
         } else if(fwrite(&lmem->readable, sizeof(lmem->readable), 1, stream) != 1){
-            return false;
+            success = false;
         } else if(fwrite(&lmem->writable, sizeof(lmem->writable), 1, stream) != 1){
-            return false;
+            success = false;
         } else if(fwrite(&lmem->executable, sizeof(lmem->executable), 1, stream) != 1){
-            return false;
+            success = false;
         } else if(fwrite(&lmem->locked, sizeof(lmem->locked), 1, stream) != 1){
-            return false;
+            success = false;
         } else {
-            if(lmem->is_compressed){
-                if(fwrite(compressed_data, sizeof(char), compressed_size, stream) != compressed_size){
-                    free(compressed_data);
-                    return false;
-                } else free(compressed_data);
-            } else {
-                if(fwrite(lmem->data, sizeof(char), (size_t) lmem->size, stream) != lmem->size){
-                    return false;
-                }
-            }
+            success = fwrite(stored_data, sizeof(char), stored_size, stream) == stored_size;
+        }
 
-            if(lmem->next == NULL){
-                return true;
-            } else return write_lmem(stream, lmem->next);
+        if(lmem->is_compressed && stored_data != NULL){
+            free(stored_data);
         }
+
+        if(! success){
+            return false;
+        } else if(lmem->next == NULL){
+            return true;
+        } else return write_lmem(stream, lmem->next);
     }
 }
 
@@ -891,124 +1447,142 @@ bool write_const(FILE *stream, const srsvm_constant_specification *c)
     }
 }
 
-bool serialize_constants(FILE *stream, const srsvm_program *program)
+#if defined(SRSVM_SUPPORT_COMPRESSION)
+/* Lays the constant records out in memory, as they would be written
+ * uncompressed, so that they can be compressed as a block. */
+static void *constants_data(const srsvm_program *program, size_t *size)
 {
-    bool success = false;
+    srsvm_constant_specification *c = program->constants;
 
-    if(fwrite(&program->num_constants, sizeof(program->num_constants), 1, stream) != 1){
-        success = false;
-    } else if(fwrite(&program->constants_compressed, sizeof(program->constants_compressed), 1, stream) != 1){
-        success = false;
-    } else {
-#if defined(SRSVM_SUPPORT_COMPRESSION)
-        if(program->constants_compressed){
-            srsvm_constant_specification *c = program->constants;
+    size_t uncompressed_size = 0;
 
-            size_t uncompressed_size = 0;
+    for(int i = 0; c != NULL && i < program->num_constants; i++){
+        uncompressed_size += sizeof(c->const_slot);
+        uncompressed_size += sizeof(c->const_val.type);
 
-            for(int i = 0; c != NULL && i < program->num_constants; i++){
-                uncompressed_size += sizeof(c->const_slot);
-                uncompressed_size += sizeof(c->const_val.type);
-
-                switch(c->const_val.type){
+        switch(c->const_val.type){
 #define LOADER(field,flag) \
-                    case SRSVM_TYPE_##flag: \
-                               uncompressed_size += sizeof(c->const_val.field); \
-                    break;
-
-                    LOADER(word, WORD);
-                    LOADER(ptr, PTR);
-                    LOADER(ptr_offset, PTR_OFFSET);
-                    LOADER(bit, BIT);
-                    LOADER(u8, U8);
-                    LOADER(i8, I8);
-                    LOADER(u16, U16);
-                    LOADER(i16, I16);
+            case SRSVM_TYPE_##flag: \
+                       uncompressed_size += sizeof(c->const_val.field); \
+            break;
+
+            LOADER(word, WORD);
+            LOADER(ptr, PTR);
+            LOADER(ptr_offset, PTR_OFFSET);
+            LOADER(bit, BIT);
+            LOADER(u8, U8);
+            LOADER(i8, I8);
+            LOADER(u16, U16);
+            LOADER(i16, I16);
 #if WORD_SIZE == 32 || WORD_SIZE == 64 || WORD_SIZE == 128
-                    LOADER(u32, U32);
-                    LOADER(i32, I32);
-                    LOADER(f32, F32);
+            LOADER(u32, U32);
+            LOADER(i32, I32);
+            LOADER(f32, F32);
 #endif
 #if WORD_SIZE == 64 || WORD_SIZE == 128
-                    LOADER(u64, U64);
-                    LOADER(i64, I64);
-                    LOADER(f64, F64);
+            LOADER(u64, U64);
+            LOADER(i64, I64);
+            LOADER(f64, F64);
 #endif
 #if WORD_SIZE == 128
-                    LOADER(u128, U128);
-                    LOADER(i128, I128);
+            LOADER(u128, U128);
+            LOADER(i128, I128);
 #endif
 #undef LOADER
-                    case SRSVM_TYPE_STR:
-                    uncompressed_size += sizeof(c->const_val.str_len);
-                    uncompressed_size += c->const_val.str_len;
+            case SRSVM_TYPE_STR:
+            uncompressed_size += sizeof(c->const_val.str_len);
+            uncompressed_size += c->const_val.str_len;
 
-                    break;
+            break;
 
-                    default:
-                        continue;
-                    break;
-                }
+            default:
+                continue;
+            break;
+        }
 
-                c = c->next;
-            }
+        c = c->next;
+    }
 
-            void *uncompressed_data = malloc(uncompressed_size);
-            if(uncompressed_data == NULL){
-                return false;
-            }
+    void *uncompressed_data = malloc(uncompressed_size);
+    if(uncompressed_data == NULL){
+        return NULL;
+    }
 
-            size_t offset = 0;
-            c = program->constants;
+    size_t offset = 0;
+    c = program->constants;
 
-            for(int i = 0; c != NULL && i < program->num_constants; i++){
-                memcpy(uncompressed_data + offset, &c->const_slot, sizeof(c->const_slot));
-                offset += sizeof(c->const_slot);
-                memcpy(uncompressed_data + offset, &c->const_val.type, sizeof(c->const_val.type));
-                offset += sizeof(c->const_val.type);
+    for(int i = 0; c != NULL && i < program->num_constants; i++){
+        memcpy(uncompressed_data + offset, &c->const_slot, sizeof(c->const_slot));
+        offset += sizeof(c->const_slot);
+        memcpy(uncompressed_data + offset, &c->const_val.type, sizeof(c->const_val.type));
+        offset += sizeof(c->const_val.type);
 
-                switch(c->const_val.type){
+        switch(c->const_val.type){
 #define LOADER(field,flag) \
-                    case SRSVM_TYPE_##flag: \
-                               memcpy(uncompressed_data + offset, &c->const_val.field, sizeof(c->const_val.field)); \
-                    offset += sizeof(c->const_val.field); \
-                    break;
-
-                    LOADER(word, WORD);
-                    LOADER(ptr, PTR);
-                    LOADER(ptr_offset, PTR_OFFSET);
-                    LOADER(bit, BIT);
-                    LOADER(u8, U8);
-                    LOADER(i8, I8);
-                    LOADER(u16, U16);
-                    LOADER(i16, I16);
+            case SRSVM_TYPE_##flag: \
+                       memcpy(uncompressed_data + offset, &c->const_val.field, sizeof(c->const_val.field)); \
+            offset += sizeof(c->const_val.field); \
+            break;
+
+            LOADER(word, WORD);
+            LOADER(ptr, PTR);
+            LOADER(ptr_offset, PTR_OFFSET);
+            LOADER(bit, BIT);
+            LOADER(u8, U8);
+            LOADER(i8, I8);
+            LOADER(u16, U16);
+            LOADER(i16, I16);
 #if WORD_SIZE == 32 || WORD_SIZE == 64 || WORD_SIZE == 128
-                    LOADER(u32, U32);
-                    LOADER(i32, I32);
-                    LOADER(f32, F32);
+            LOADER(u32, U32);
+            LOADER(i32, I32);
+            LOADER(f32, F32);
 #endif
 #if WORD_SIZE == 64 || WORD_SIZE == 128
-                    LOADER(u64, U64);
-                    LOADER(i64, I64);
-                    LOADER(f64, F64);
+            LOADER(u64, U64);
+            LOADER(i64, I64);
+            LOADER(f64, F64);
 #endif
 #if WORD_SIZE == 128
-                    LOADER(u128, U128);
-                    LOADER(i128, I128);
+            LOADER(u128, U128);
+            LOADER(i128, I128);
 #endif
 #undef LOADER
-                    case SRSVM_TYPE_STR:
-                        memcpy(uncompressed_data + offset, &c->const_val.str_len, sizeof(c->const_val.str_len));
-                        offset += sizeof(c->const_val.str_len);
-                        memcpy(uncompressed_data + offset, c->const_val.str, c->const_val.str_len);
-                        offset += c->const_val.str_len;
-                    break;
-                    default:
-                        success = false;
-                    break;
-                }
+            case SRSVM_TYPE_STR:
+                memcpy(uncompressed_data + offset, &c->const_val.str_len, sizeof(c->const_val.str_len));
+                offset += sizeof(c->const_val.str_len);
+                memcpy(uncompressed_data + offset, c->const_val.str, c->const_val.str_len);
+                offset += c->const_val.str_len;
+            break;
+            default:
+            break;
+        }
+
+        c = c->next;
+    }
+
+    *size = uncompressed_size;
+
+    return uncompressed_data;
+}
+#endif
+
+bool serialize_constants(FILE *stream, const srsvm_program *program)
+{
+    bool success = false;
+
+    if(fwrite(&program->num_constants, sizeof(program->num_constants), 1, stream) != 1){
+        success = false;
+    } else if(fwrite(&program->constants_compressed, sizeof(program->constants_compressed), 1, stream) != 1){
+        success = false;
+    } else {
+#if defined(SRSVM_SUPPORT_COMPRESSION)
+        if(program->constants_compressed){
+            size_t uncompressed_size;
 
-                c = c->next;
+            void *uncompressed_data = constants_data(program, &uncompressed_size);
+
+            if(uncompressed_data == NULL){
+                return false;
             }
 
             size_t compressed_size;
@@ -1051,31 +1625,326 @@ bool serialize_constants(FILE *stream, const srsvm_program *program)
 }
 
 
-bool srsvm_program_serialize(const char* output_path, const srsvm_program* program)
+static bool write_padding(FILE *stream, const long bytes)
+{
+    for(long i = 0; i < bytes; i++){
+        if(fputc(0, stream) == EOF){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool begin_section(FILE *stream, srsvm_program_section *section, const uint16_t type)
+{
+    long position = ftell(stream);
+
+    if(position < 0){
+        return false;
+    }
+
+    long padding = (SRSVM_PROGRAM_SECTION_ALIGN - position % SRSVM_PROGRAM_SECTION_ALIGN) % SRSVM_PROGRAM_SECTION_ALIGN;
+
+    section->type = type;
+    section->offset = (uint64_t) (position + padding);
+
+    return write_padding(stream, padding);
+}
+
+static bool end_section(FILE *stream, srsvm_program_section *section)
+{
+    long position = ftell(stream);
+
+    if(position < 0){
+        return false;
+    }
+
+    section->size = (uint64_t) position - section->offset;
+
+    if(! (section->flags & SRSVM_SECTION_COMPRESSED)){
+        section->original_size = section->size;
+    }
+
+    return true;
+}
+
+static bool write_stored_section(FILE *stream, srsvm_program_section *section, const uint16_t type, const void *data, const size_t size)
+{
+    if(! begin_section(stream, section, type)){
+        return false;
+    } else if(fwrite(data, sizeof(char), size, stream) != size){
+        return false;
+    } else return end_section(stream, section);
+}
+
+/* Reads a payload back out of the file once everything has been written. */
+static bool checksum_section(FILE *stream, srsvm_program_section *section)
 {
     bool success = false;
 
-    FILE *stream = fopen(output_path, "wb");
+    size_t size = (size_t) section->size;
+    char *payload = malloc(size > 0 ? size : 1);
 
-    if(stream != NULL){
-        if(! serialize_metadata(stream, program)){
-            dbg_puts("failed to serialize metadata");
-            goto error_cleanup;
-        } else if(! serialize_registers(stream, program)){
-            dbg_puts("failed to serialize registers");
+    if(payload != NULL){
+        if(fseek(stream, (long) section->offset, SEEK_SET) == 0 && fread(payload, sizeof(char), size, stream) == size){
+            section->checksum = section_checksum(payload, size);
+            success = true;
+        }
+
+        free(payload);
+    }
+
+    return success;
+}
+
+static bool write_section_entry(FILE *stream, const srsvm_program_section *section)
+{
+    if(fwrite(&section->type, sizeof(section->type), 1, stream) != 1){
+        return false;
+    } else if(fwrite(&section->flags, sizeof(section->flags), 1, stream) != 1){
+        return false;
+    } else if(fwrite(&section->count, sizeof(section->count), 1, stream) != 1){
+        return false;
+    } else if(fwrite(&section->offset, sizeof(section->offset), 1, stream) != 1){
+        return false;
+    } else if(fwrite(&section->size, sizeof(section->size), 1, stream) != 1){
+        return false;
+    } else if(fwrite(&section->original_size, sizeof(section->original_size), 1, stream) != 1){
+        return false;
+    } else if(fwrite(&section->checksum, sizeof(section->checksum), 1, stream) != 1){
+        return false;
+    } else if(fwrite(&section->address, sizeof(section->address), 1, stream) != 1){
+        return false;
+    }
+
+    return true;
+}
+
+static bool write_header(FILE *stream, const srsvm_program *program, const uint16_t num_sections, const uint64_t table_offset)
+{
+    uint16_t version = SRSVM_PROGRAM_FORMAT_VERSION;
+    uint8_t entry_point[16] = { 0 };
+
+    memcpy(entry_point, &program->metadata->entry_point, sizeof(program->metadata->entry_point));
+
+    if(fwrite(SRSVM_PROGRAM_MAGIC_V2, sizeof(program->metadata->magic), 1, stream) != 1){
+        return false;
+    } else if(fwrite(&program->metadata->word_size, sizeof(program->metadata->word_size), 1, stream) != 1){
+        return false;
+    } else if(fwrite(&version, sizeof(version), 1, stream) != 1){
+        return false;
+    } else if(fwrite(&num_sections, sizeof(num_sections), 1, stream) != 1){
+        return false;
+    } else if(fwrite(&table_offset, sizeof(table_offset), 1, stream) != 1){
+        return false;
+    } else if(fwrite(&entry_point, sizeof(entry_point), 1, stream) != 1){
+        return false;
+    }
+
+    return true;
+}
+
+static bool serialize_constants_section(FILE *stream, srsvm_program_section *section, const srsvm_program *program)
+{
+    section->count = program->num_constants;
+
+#if defined(SRSVM_SUPPORT_COMPRESSION)
+    if(program->constants_compressed){
+        bool success = false;
+
+        size_t uncompressed_size, compressed_size;
+
+        void *uncompressed_data = constants_data(program, &uncompressed_size);
+
+        if(uncompressed_data == NULL){
+            return false;
+        }
+
+        void *compressed_data = srsvm_codec_compress(program->codec, uncompressed_data, &compressed_size, uncompressed_size);
+
+        free(uncompressed_data);
+
+        if(compressed_data != NULL){
+            section->flags = SRSVM_SECTION_COMPRESSED | (program->codec << SRSVM_SECTION_CODEC_SHIFT);
+            section->original_size = uncompressed_size;
+
+            success = write_stored_section(stream, section, SRSVM_SECTION_CONSTANTS, compressed_data, compressed_size);
+
+            free(compressed_data);
+        }
+
+        return success;
+    }
+#endif
+
+    if(! begin_section(stream, section, SRSVM_SECTION_CONSTANTS)){
+        return false;
+    } else if(! write_const(stream, program->constants)){
+        return false;
+    } else return end_section(stream, section);
+}
+
+static bool serialize_sections(FILE *stream, const srsvm_program *program)
+{
+    bool success = false;
+
+    if(program->num_lmem_segments > UINT16_MAX - 4){
+        return false;
+    }
+
+    uint16_t num_sections = 3 + program->num_lmem_segments + (program->num_modules > 0 ? 1 : 0);
+
+    srsvm_program_section *sections = calloc(num_sections, sizeof(srsvm_program_section));
+    srsvm_program_section *section = sections;
+
+    if(sections == NULL){
+        return false;
+    } else if(! serialize_shebang(stream, program)){
+        goto error_cleanup;
+    }
+
+    long header_offset = ftell(stream);
+
+    if(header_offset < 0 || ! write_padding(stream, SRSVM_PROGRAM_HEADER_SIZE + num_sections * SRSVM_PROGRAM_SECTION_ENTRY_SIZE)){
+        goto error_cleanup;
+    }
+
+    section->count = program->num_registers;
+
+    if(! begin_section(stream, section, SRSVM_SECTION_REGISTERS) || ! write_reg(stream, program->registers) || ! end_section(stream, section)){
+        dbg_puts("failed to serialize registers");
+        goto error_cleanup;
+    }
+
+    section++;
+    section->count = program->num_vmem_segments;
+
+    if(! begin_section(stream, section, SRSVM_SECTION_VMEM) || ! write_vmem(stream, program->virtual_memory) || ! end_section(stream, section)){
+        dbg_puts("failed to serialize vmem");
+        goto error_cleanup;
+    }
+
+    srsvm_literal_memory_specification *lmem = program->literal_memory;
+
+    for(uint16_t i = 0; i < program->num_lmem_segments; i++){
+        if(lmem == NULL){
             goto error_cleanup;
-        } else if(! serialize_vmem(stream, program)){
-            dbg_puts("failed to serialize vmem");
+        }
+
+        section++;
+
+        size_t stored_size = 0;
+        void *stored_data = lmem_stored_data(lmem, true, program->codec, &stored_size);
+
+        if(stored_data == NULL && lmem->size > 0){
+            dbg_puts("failed to serialize lmem");
             goto error_cleanup;
-        } else if(! serialize_lmem(stream, program)){
+        }
+
+        section->count = 1;
+        section->original_size = (uint64_t) lmem->size;
+        memcpy(section->address, &lmem->start_address, sizeof(lmem->start_address));
+
+        section->flags = (lmem->is_compressed ? SRSVM_SECTION_COMPRESSED | SRSVM_SECTION_CHUNKED | (program->codec << SRSVM_SECTION_CODEC_SHIFT) : 0)
+            | (lmem->readable ? SRSVM_SECTION_READABLE : 0)
+            | (lmem->writable ? SRSVM_SECTION_WRITABLE : 0)
+            | (lmem->executable ? SRSVM_SECTION_EXECUTABLE : 0)
+            | (lmem->locked ? SRSVM_SECTION_LOCKED : 0);
+
+        bool written = write_stored_section(stream, section, SRSVM_SECTION_LMEM, stored_data, stored_size);
+
+        if(lmem->is_compressed && stored_data != NULL){
+            free(stored_data);
+        }
+
+        if(! written){
             dbg_puts("failed to serialize lmem");
             goto error_cleanup;
-        } else if(! serialize_constants(stream, program)){
-            dbg_puts("failed to serialize constants");
+        }
+
+        lmem = lmem->next;
+    }
+
+    section++;
+
+    if(! serialize_constants_section(stream, section, program)){
+        dbg_puts("failed to serialize constants");
+        goto error_cleanup;
+    }
+
+    if(program->num_modules > 0){
+        section++;
+        section->count = program->num_modules;
+
+        if(! begin_section(stream, section, SRSVM_SECTION_MODULES) || ! write_module(stream, program->modules) || ! end_section(stream, section)){
+            dbg_puts("failed to serialize modules");
             goto error_cleanup;
         }
+    }
 
-        fclose(stream);
+    for(uint16_t i = 0; i < num_sections; i++){
+        if(! checksum_section(stream, &sections[i])){
+            goto error_cleanup;
+        }
+    }
+
+    if(fseek(stream, header_offset, SEEK_SET) != 0){
+        goto error_cleanup;
+    } else if(! write_header(stream, program, num_sections, (uint64_t) header_offset + SRSVM_PROGRAM_HEADER_SIZE)){
+        goto error_cleanup;
+    }
+
+    for(uint16_t i = 0; i < num_sections; i++){
+        if(! write_section_entry(stream, &sections[i])){
+            goto error_cleanup;
+        }
+    }
+
+    success = true;
+
+error_cleanup:
+    free(sections);
+
+    return success;
+}
+
+bool srsvm_program_serialize(const char* output_path, const srsvm_program* program)
+{
+    bool success = false;
+
+    if(program->format_version == 1 && program->codec != 0){
+        dbg_puts("version 1 programs can only be compressed with zlib");
+        return false;
+    }
+
+    FILE *stream = fopen(output_path, "w+b");
+
+    if(stream != NULL){
+        if(program->format_version == 1){
+            if(! serialize_metadata(stream, program)){
+                dbg_puts("failed to serialize metadata");
+                goto error_cleanup;
+            } else if(! serialize_registers(stream, program)){
+                dbg_puts("failed to serialize registers");
+                goto error_cleanup;
+            } else if(! serialize_vmem(stream, program)){
+                dbg_puts("failed to serialize vmem");
+                goto error_cleanup;
+            } else if(! serialize_lmem(stream, program)){
+                dbg_puts("failed to serialize lmem");
+                goto error_cleanup;
+            } else if(! serialize_constants(stream, program)){
+                dbg_puts("failed to serialize constants");
+                goto error_cleanup;
+            }
+        } else if(! serialize_sections(stream, program)){
+            goto error_cleanup;
+        }
+
+        if(fclose(stream) != 0){
+            return false;
+        }
 
         success = true;
     }
@@ -1092,16 +1961,35 @@ error_cleanup:
 
 #endif
 
+/* Only reads as far as the word size, which both versions put right after
+ * the magic number. */
 uint8_t srsvm_program_word_size(const char* program_path)
 {
     uint8_t word_size = 0;
 
-    srsvm_program *program = srsvm_program_deserialize(program_path);
+    FILE *stream = fopen(program_path, "rb");
 
-    if(program != NULL){
-        word_size = program->metadata->word_size;
+    if(stream != NULL){
+        char magic[3];
+
+        if(fread(magic, sizeof(magic), 1, stream) == 1){
+#if defined(SRSVM_PROGRAM_SUPPORT_SHEBANG)
+            if(magic[0] == '#' && magic[1] == '!'){
+                int c;
 
-        srsvm_program_free(program);
+                while((c = fgetc(stream)) != EOF && c != '\n'){ }
+
+                if(fread(magic, sizeof(magic), 1, stream) != 1){
+                    magic[0] = '\0';
+                }
+            }
+#endif
+            if(magic_version(magic) == 0 || fread(&word_size, sizeof(word_size), 1, stream) != 1){
+                word_size = 0;
+            }
+        }
+
+        fclose(stream);
     }
 
     return word_size;
@@ -1111,18 +1999,26 @@ srsvm_program *srsvm_program_deserialize(const char* program_path)
 {
     srsvm_program *program = NULL;
 
-    FILE *stream = NULL;
+    srsvm_program_file *file = NULL;
 
     if(program_path != NULL){
-        stream = fopen(program_path, "rb");
+        file = program_file_open(program_path);
 
-        if(stream != NULL){
-            program = srsvm_program_alloc();
+        if(file != NULL && (program = srsvm_program_alloc()) != NULL){
+            program_reader reader = { file->data, file->size, 0 };
+            program_reader *stream = &reader;
+
+            program->file = file;
+            file = NULL;
 
             if(! deserialize_metadata(stream, program)){
                 dbg_puts("ERROR: failed to deserialize metadata");
                 goto error_cleanup;
 #if defined(WORD_SIZE)
+            } else if(program->format_version >= 2){
+                if(! deserialize_sections(stream, program)){
+                    goto error_cleanup;
+                }
             } else if(! deserialize_registers(stream, program)){
                 dbg_puts("ERROR: failed to deserialize registers");
                 goto error_cleanup;
@@ -1137,16 +2033,15 @@ srsvm_program *srsvm_program_deserialize(const char* program_path)
                 goto error_cleanup;
 #endif
             }
-
-            fclose(stream);
         }
     }
 
+    srsvm_program_file_release(file);
+
     return program;
 
 error_cleanup:
-    if(stream != NULL)
-        fclose(stream);
+    srsvm_program_free(program);
 
     return NULL;
 }
@@ -1,32 +1,108 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <errno.h>
+#include <stdio.h>
+
 #include "srsvm/debug.h"
 #include "srsvm/handle.h"
 #include "srsvm/register.h"
 
-srsvm_register *srsvm_register_alloc(const char* name, const srsvm_word index)
+srsvm_register_file *srsvm_register_file_alloc(void)
+{
+    srsvm_register_file *file = malloc(sizeof(srsvm_register_file));
+
+    if(file != NULL){
+        file->slots = srsvm_aligned_alloc(SRSVM_REGISTER_FILE_ALIGNMENT, SRSVM_REGISTER_MAX_COUNT * sizeof(srsvm_register));
+        file->flags = calloc(SRSVM_REGISTER_MAX_COUNT, sizeof(srsvm_register_flags));
+        file->cold = calloc(SRSVM_REGISTER_MAX_COUNT, sizeof(srsvm_register_cold));
+
+        if(file->slots == NULL || file->flags == NULL || file->cold == NULL){
+            dbg_printf("register file allocation failed: %s", strerror(errno));
+
+            if(file->slots != NULL) srsvm_aligned_free(file->slots);
+            if(file->flags != NULL) free(file->flags);
+            if(file->cold != NULL) free(file->cold);
+
+            free(file);
+            file = NULL;
+        } else {
+            memset(file->slots, 0, SRSVM_REGISTER_MAX_COUNT * sizeof(srsvm_register));
+
+            for(srsvm_word i = 0; i < SRSVM_REGISTER_MAX_COUNT; i++){
+                file->slots[i].index = i;
+                file->slots[i].flags = &file->flags[i];
+                file->slots[i].cold = &file->cold[i];
+            }
+        }
+    }
+
+    return file;
+}
+
+srsvm_register_file *srsvm_register_file_alloc_context(const srsvm_register_file *program_file, srsvm_atomic_counter *pending_faults)
+{
+    srsvm_register_file *context = srsvm_register_file_alloc();
+
+    if(context != NULL){
+        for(srsvm_word i = 0; i < SRSVM_REGISTER_MAX_COUNT; i++){
+            const srsvm_register *program_reg = &program_file->slots[i];
+
+            if(! program_reg->flags->allocated){
+                continue;
+            } else if(program_reg->flags->shared){
+                context->flags[i].shared = true;
+            } else {
+                srsvm_register *reg = srsvm_register_alloc(context, srsvm_register_name(program_reg), i);
+
+                reg->pending_faults = pending_faults;
+            }
+        }
+    }
+
+    return context;
+}
+
+void srsvm_register_file_free(srsvm_register_file *file)
+{
+    if(file != NULL){
+        for(srsvm_word i = 0; i < SRSVM_REGISTER_MAX_COUNT; i++){
+            srsvm_register_free(&file->slots[i]);
+
+            if(file->cold[i].error_arg != NULL){
+                free(file->cold[i].error_arg);
+            }
+        }
+
+        srsvm_aligned_free(file->slots);
+        free(file->flags);
+        free(file->cold);
+
+        free(file);
+    }
+}
+
+srsvm_register *srsvm_register_alloc(srsvm_register_file *file, const char* name, const srsvm_word index)
 {
     dbg_printf("allocating register %s at index " PRINT_WORD, name, PRINTF_WORD_PARAM(index));
 
     srsvm_register *reg = NULL;
 
-    reg = malloc(sizeof(srsvm_register));
+    if(index < SRSVM_REGISTER_MAX_COUNT && ! file->flags[index].allocated){
+        reg = &file->slots[index];
+
+        srsvm_strncpy(reg->cold->name, name, sizeof(reg->cold->name) - 1);
 
-    if(reg != NULL){
-        reg->index = index;
-		srsvm_strncpy(reg->name, name, sizeof(reg->name) - 1);
-        reg->error_flag = false;
-        reg->read_only = false;
-        reg->locked = false;
-	reg->fault_on_error = false;
+        reg->flags->allocated = true;
+        reg->flags->error_flag = false;
+        reg->flags->read_only = false;
+        reg->flags->locked = false;
+        reg->flags->fault_on_error = false;
+        reg->pending_faults = NULL;
 
         memset(&reg->value, 0, sizeof(srsvm_register_contents));
         reg->value.str = NULL;
         reg->value.str_len = 0;
-
-    } else {
-        dbg_printf("malloc failed: %s", strerror(errno));
     }
 
     return reg;
@@ -34,7 +110,9 @@ srsvm_register *srsvm_register_alloc(const char* name, const srsvm_word index)
 
 void srsvm_register_free(srsvm_register *reg)
 {
-    if(reg != NULL){
+    if(reg != NULL && reg->flags->allocated){
+        srsvm_register_set_fault_state(reg, false, false);
+
         if(reg->value.str != NULL){
             free(reg->value.str);
         }
@@ -43,6 +121,70 @@ void srsvm_register_free(srsvm_register *reg)
             srsvm_handle_free(reg->value.hnd);
         }
 
-        free(reg);
+        memset(&reg->value, 0, sizeof(srsvm_register_contents));
+
+        reg->flags->allocated = false;
     }
 }
+
+static const char *register_error_formats[SRSVM_REGISTER_ERROR_COUNT] = {
+    [SRSVM_REGISTER_ERROR_NONE] = "",
+    [SRSVM_REGISTER_ERROR_ALLOC] = "Failed to allocate memory",
+    [SRSVM_REGISTER_ERROR_COPY_ADDRESS] = "Failed to copy address to register",
+    [SRSVM_REGISTER_ERROR_COPY_RESULT] = "Failed to copy result to register",
+    [SRSVM_REGISTER_ERROR_COPY_MODULE_ID] = "Failed to copy module ID to register",
+    [SRSVM_REGISTER_ERROR_REGION_EXHAUSTED] = "Region is exhausted",
+    [SRSVM_REGISTER_ERROR_BYTE_NOT_FOUND] = "Byte not found",
+    [SRSVM_REGISTER_ERROR_MODULE_LOAD] = "Failed to load module",
+    [SRSVM_REGISTER_ERROR_REGISTER_LOOKUP] = "Failed to look up register '%s'",
+    [SRSVM_REGISTER_ERROR_MODULE_LOOKUP] = "Failed to look up module '%s'",
+    [SRSVM_REGISTER_ERROR_JOINED_THREAD] = "joined thread: %s",
+    [SRSVM_REGISTER_ERROR_MUTEX_INIT] = "Failed to initialize mutex",
+    [SRSVM_REGISTER_ERROR_PARSE_NULL] = "Attempted to parse a null string",
+    [SRSVM_REGISTER_ERROR_PARSE] = "%s parse failed",
+    [SRSVM_REGISTER_ERROR_SERIALIZE] = "Failed to serialize %s",
+};
+
+bool srsvm_register_set_error(srsvm_register *reg, const srsvm_register_error code, const char *arg)
+{
+    reg->cold->error_code = code;
+
+    if(arg != NULL){
+        if(reg->cold->error_arg == NULL){
+            reg->cold->error_arg = malloc(SRSVM_REGISTER_ERROR_STR_LEN * sizeof(char));
+        }
+
+        if(reg->cold->error_arg != NULL){
+            size_t arg_len = strlen(arg);
+
+            if(arg_len >= SRSVM_REGISTER_ERROR_STR_LEN){
+                arg_len = SRSVM_REGISTER_ERROR_STR_LEN - 1;
+            }
+
+            memcpy(reg->cold->error_arg, arg, arg_len);
+            reg->cold->error_arg[arg_len] = '\0';
+        }
+    }
+
+    srsvm_register_set_error_flag(reg, true);
+
+    return true;
+}
+
+size_t srsvm_register_format_error(const srsvm_register *reg, char *buf, const size_t buf_len)
+{
+    srsvm_register_error code = reg->flags->error_flag ? reg->cold->error_code : SRSVM_REGISTER_ERROR_NONE;
+
+    if(buf_len == 0){
+        return 0;
+    } else if(code >= SRSVM_REGISTER_ERROR_COUNT){
+        buf[0] = '\0';
+        return 0;
+    }
+
+    const char *arg = reg->cold->error_arg != NULL ? reg->cold->error_arg : "";
+
+    int len = snprintf(buf, buf_len, register_error_formats[code], arg);
+
+    return len < 0 ? 0 : (size_t) len;
+}
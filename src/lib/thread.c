@@ -1,7 +1,11 @@
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <errno.h>
+
 #include "srsvm/debug.h"
+#include "srsvm/handle.h"
 #include "srsvm/thread.h"
 #include "srsvm/vm.h"
 
@@ -22,17 +26,41 @@ srsvm_thread *srsvm_thread_alloc(srsvm_vm *vm, srsvm_word id, srsvm_ptr start_ad
 
         thread->fault_handler = NULL;
 
-        srsvm_stack_frame *base_frame = malloc(sizeof(srsvm_stack_frame));
-        if(base_frame != NULL){
-            //base_frame->PC = start_addr;
-            base_frame->next_PC = start_addr;
-            base_frame->spilled = NULL;
-            base_frame->last_spilled = NULL;
-            base_frame->next = NULL;
-        
-            thread->call_stack.frames = base_frame;
-            thread->call_stack.top = base_frame;
-        } else {
+        thread->pending_register_faults = 0;
+
+        if(vm->main_thread == NULL){
+            thread->registers = vm->registers;
+        } else if((thread->registers = srsvm_register_file_alloc_context(vm->registers, &thread->pending_register_faults)) == NULL){
+            free(thread);
+            return NULL;
+        }
+
+        srsvm_tlb_init(&thread->tlb, vm->mem_root);
+        srsvm_mmu_reader_register(vm->mem_root, &thread->decode_reader);
+        srsvm_heap_cache_init(&thread->heap_cache);
+
+        thread->call_stack.depth = 0;
+        thread->call_stack.frame_capacity = SRSVM_CALL_STACK_INITIAL_FRAMES;
+        thread->call_stack.num_spills = 0;
+        thread->call_stack.spill_capacity = SRSVM_CALL_STACK_INITIAL_SPILLS;
+        thread->call_stack.spill_bytes = NULL;
+        thread->call_stack.spill_bytes_used = 0;
+        thread->call_stack.spill_bytes_capacity = 0;
+
+        thread->call_stack.frames = malloc(SRSVM_CALL_STACK_INITIAL_FRAMES * sizeof(srsvm_stack_frame));
+        thread->call_stack.spills = malloc(SRSVM_CALL_STACK_INITIAL_SPILLS * sizeof(srsvm_spilled_register));
+
+        if(thread->call_stack.frames == NULL || thread->call_stack.spills == NULL){
+            if(thread->call_stack.frames != NULL) free(thread->call_stack.frames);
+            if(thread->call_stack.spills != NULL) free(thread->call_stack.spills);
+
+            if(thread->registers != vm->registers){
+                srsvm_register_file_free(thread->registers);
+            }
+
+            srsvm_tlb_release(&thread->tlb);
+            srsvm_mmu_reader_unregister(vm->mem_root, &thread->decode_reader);
+
             free(thread);
             thread = NULL;
         }
@@ -41,24 +69,81 @@ srsvm_thread *srsvm_thread_alloc(srsvm_vm *vm, srsvm_word id, srsvm_ptr start_ad
     return thread;
 }
 
-void srsvm_thread_free(srsvm_vm *vm, srsvm_thread *thread)
+static void discard_spills(srsvm_call_stack *stack, const size_t base)
+{
+    if(stack->num_spills > base){
+        stack->spill_bytes_used = stack->spills[base].bytes_base;
+        stack->num_spills = base;
+    }
+}
+
+static inline size_t frame_spill_base(const srsvm_call_stack *stack)
 {
-    srsvm_stack_frame *frame = thread->call_stack.frames, *next_frame;
+    return stack->depth > 0 ? stack->frames[stack->depth - 1].spill_base : 0;
+}
 
-    while(frame != NULL){
-        srsvm_spilled_register *spilled = frame->spilled, *next_spilled;
+static bool grow_stack(void **items, size_t *capacity, const size_t item_size)
+{
+    void *grown = realloc(*items, *capacity * 2 * item_size);
 
-        while(spilled != NULL){
-            next_spilled = spilled->next;
-            free(spilled);
-            spilled = next_spilled;
+    if(grown == NULL){
+        dbg_printf("failed to grow call stack: %s", strerror(errno));
+        return false;
+    }
+
+    *items = grown;
+    *capacity *= 2;
+
+    return true;
+}
+
+static size_t spill_bytes(srsvm_call_stack *stack, const char *bytes, const size_t len)
+{
+    if(stack->spill_bytes_capacity - stack->spill_bytes_used < len){
+        size_t capacity = stack->spill_bytes_capacity > 0 ? stack->spill_bytes_capacity : SRSVM_CALL_STACK_INITIAL_SPILL_BYTES;
+
+        while(capacity - stack->spill_bytes_used < len){
+            capacity *= 2;
+        }
+
+        char *grown = realloc(stack->spill_bytes, capacity);
+
+        if(grown == NULL){
+            dbg_printf("failed to grow call stack: %s", strerror(errno));
+            return SRSVM_SPILL_NO_BYTES;
         }
 
-        next_frame = frame->next;
-        free(frame);
-        frame = next_frame;
+        stack->spill_bytes = grown;
+        stack->spill_bytes_capacity = capacity;
     }
 
+    size_t offset = stack->spill_bytes_used;
+
+    memcpy(stack->spill_bytes + offset, bytes, len);
+    stack->spill_bytes_used += len;
+
+    return offset;
+}
+
+void srsvm_thread_free(srsvm_vm *vm, srsvm_thread *thread)
+{
+    dbg_printf("thread " PRINT_WORD " TLB: %lu hits, %lu misses", PRINTF_WORD_PARAM(thread->id), thread->tlb.hits, thread->tlb.misses);
+
+    discard_spills(&thread->call_stack, 0);
+
+    free(thread->call_stack.spill_bytes);
+    free(thread->call_stack.spills);
+    free(thread->call_stack.frames);
+
+    if(thread->registers != vm->registers){
+        srsvm_register_file_free(thread->registers);
+    }
+
+    srsvm_heap_cache_flush(vm->heap, &thread->heap_cache);
+
+    srsvm_tlb_release(&thread->tlb);
+    srsvm_mmu_reader_unregister(vm->mem_root, &thread->decode_reader);
+
     vm->threads[thread->id] = NULL;
 
     free(thread);
@@ -66,127 +151,125 @@ void srsvm_thread_free(srsvm_vm *vm, srsvm_thread *thread)
 
 bool srsvm_push(srsvm_vm *vm, srsvm_thread *thread, const srsvm_register *reg)
 {
-    bool success = false;
-
-    srsvm_stack_frame *cur_frame = thread->call_stack.top;
+    srsvm_call_stack *stack = &thread->call_stack;
 
-    if(cur_frame != NULL){
-        srsvm_spilled_register *spill = malloc(sizeof(srsvm_spilled_register));
+    if(stack->num_spills == stack->spill_capacity && ! grow_stack((void**) &stack->spills, &stack->spill_capacity, sizeof(srsvm_spilled_register))){
+        return false;
+    }
 
-        if(spill != NULL){
-            spill->index = reg->index;
-            memcpy(&spill->reg, reg, sizeof(srsvm_register));
-            spill->last = cur_frame->last_spilled;
-            spill->next = NULL;
+    srsvm_spilled_register *spill = &stack->spills[stack->num_spills];
 
-            if(cur_frame->spilled == NULL){
-                cur_frame->spilled = spill;
-            }
+    spill->index = reg->index;
+    spill->error_flag = reg->flags->error_flag;
+    spill->fault_on_error = reg->flags->fault_on_error;
+    spill->error_code = reg->cold->error_code;
+    spill->str_offset = SRSVM_SPILL_NO_BYTES;
+    spill->error_arg_offset = SRSVM_SPILL_NO_BYTES;
+    spill->bytes_base = stack->spill_bytes_used;
+    spill->value = reg->value;
+    spill->value.str = NULL;
 
-            cur_frame->last_spilled = spill;
+    if(reg->value.str != NULL && (spill->str_offset = spill_bytes(stack, reg->value.str, reg->value.str_len + 1)) == SRSVM_SPILL_NO_BYTES){
+        return false;
+    }
 
-            if(spill->last != NULL){
-                spill->last->next = spill;
-            }
-        
-            success = true;
-        }
+    if(reg->flags->error_flag && reg->cold->error_arg != NULL &&
+            (spill->error_arg_offset = spill_bytes(stack, reg->cold->error_arg, strlen(reg->cold->error_arg) + 1)) == SRSVM_SPILL_NO_BYTES){
+        stack->spill_bytes_used = spill->bytes_base;
+        return false;
     }
 
-    return success;
+    stack->num_spills++;
+
+    return true;
 }
 
-bool srsvm_pop(srsvm_vm *vm, srsvm_thread *thread)
+bool srsvm_pop(srsvm_vm *vm, srsvm_thread *thread, srsvm_register *dest)
 {
-    bool success = false;
-    
-    srsvm_stack_frame *cur_frame = thread->call_stack.top;
+    srsvm_call_stack *stack = &thread->call_stack;
 
-    if(cur_frame != NULL){
-        srsvm_spilled_register *spilled = cur_frame->last_spilled;
+    if(stack->num_spills == frame_spill_base(stack)){
+        return false;
+    }
 
-        if(spilled != NULL){
-            cur_frame->last_spilled = spilled->last;
+    srsvm_spilled_register *spill = &stack->spills[stack->num_spills - 1];
 
-            if(spilled->last != NULL){
-                spilled->last->next = NULL;
-            }
+    if(dest == NULL){
+        dest = srsvm_register_context_lookup(thread->registers, vm->registers, spill->index);
 
-            if(cur_frame->spilled == spilled){
-                cur_frame->spilled = NULL;
-            }
+        if(dest == NULL){
+            return false;
+        }
+    }
+
+    char *str = NULL;
+
+    /* the register owns its string, so the spilled bytes are copied back
+     * into the buffer it already has where possible */
+    if(spill->str_offset != SRSVM_SPILL_NO_BYTES){
+        if((str = realloc(dest->value.str, spill->value.str_len + 1)) == NULL){
+            return false;
+        }
 
-            srsvm_register *reg = vm->registers[spilled->index];
-            
-            if(reg != NULL){
-                if(reg->value.str != NULL && reg->value.str != spilled->reg.value.str){
-                    free(reg->value.str);
-                }
+        memcpy(str, stack->spill_bytes + spill->str_offset, spill->value.str_len + 1);
+    } else if(dest->value.str != NULL){
+        free(dest->value.str);
+    }
 
-                memcpy(reg, &spilled->reg, sizeof(srsvm_register));
+    if(dest->value.hnd != NULL){
+        srsvm_handle_free(dest->value.hnd);
+    }
 
-                free(spilled);
+    dest->value = spill->value;
+    dest->value.str = str;
 
-                success = true;
-            }
-        }
+    /* the error goes back with the flag, or the register would report
+     * whatever error it last held before the pop */
+    if(spill->error_flag){
+        srsvm_register_set_error(dest, spill->error_code, spill->error_arg_offset != SRSVM_SPILL_NO_BYTES ? stack->spill_bytes + spill->error_arg_offset : NULL);
     }
 
-    return success;
+    srsvm_register_set_fault_state(dest, spill->error_flag, spill->fault_on_error);
+
+    stack->spill_bytes_used = spill->bytes_base;
+    stack->num_spills--;
+
+    return true;
 }
 
 bool srsvm_call(srsvm_vm *vm, srsvm_thread *thread, const srsvm_ptr addr)
 {   
-    bool success = false;
-
-    srsvm_stack_frame *last_frame = thread->call_stack.top;
-
-    srsvm_stack_frame *new_frame = malloc(sizeof(srsvm_stack_frame));
-    
-    if(new_frame != NULL){
-        new_frame->last = last_frame;
-        new_frame->next = NULL;
+    srsvm_call_stack *stack = &thread->call_stack;
 
-        last_frame->next = new_frame;
-
-        new_frame->next_PC = addr;
+    if(stack->depth == stack->frame_capacity && ! grow_stack((void**) &stack->frames, &stack->frame_capacity, sizeof(srsvm_stack_frame))){
+        return false;
+    }
 
-        new_frame->spilled = NULL;
-        new_frame->last_spilled = NULL;
+    srsvm_stack_frame *frame = &stack->frames[stack->depth++];
 
-        thread->next_PC = addr;
+    frame->return_PC = thread->next_PC;
+    frame->spill_base = stack->num_spills;
 
-        success = true;
-    }
+    thread->next_PC = addr;
 
-    return success;
+    return true;
 }
 
 bool srsvm_ret(srsvm_vm *vm, srsvm_thread *thread)
 {
-    bool success = false;
-
-    srsvm_stack_frame *last_frame = thread->call_stack.top;
-   
-    if(last_frame == thread->call_stack.frames){
-
-    } else {
-        thread->call_stack.top = last_frame->last;
-        thread->call_stack.top->next = NULL;
+    srsvm_call_stack *stack = &thread->call_stack;
 
-        thread->next_PC = thread->call_stack.top->next_PC;
+    if(stack->depth == 0){
+        return false;
+    }
 
-        srsvm_spilled_register *next_reg;
-        for(srsvm_spilled_register *reg = last_frame->spilled; reg != NULL; reg = next_reg){
-            next_reg = reg->next;
+    srsvm_stack_frame *frame = &stack->frames[--stack->depth];
 
-            free(reg);
-        }
+    discard_spills(stack, frame->spill_base);
 
-        success = true;
-    }
+    thread->next_PC = frame->return_PC;
 
-    return success;
+    return true;
 }
 
 void srsvm_thread_set_fault_handler_native(srsvm_thread *thread, srsvm_thread_fault_handler handler)
@@ -213,17 +296,13 @@ static void srsvm_hosted_fault_handler(srsvm_vm *vm, srsvm_thread *thread)
     thread->fault_handler_addr = SRSVM_NULL_PTR;
 
     if(srsvm_call(vm, thread, thread->fault_handler_addr)){
-        srsvm_stack_frame *handler_frame = thread->call_stack.top;
-
-        if(handler_frame->last != NULL){
-            srsvm_stack_frame *prev_frame = handler_frame->last;
+        size_t handler_depth = thread->call_stack.depth;
 
-            while(! thread->is_halted && prev_frame->next == handler_frame){
-                if(srsvm_opcode_load_instruction(vm, thread->PC, &instruction)){
-                    thread->next_PC = thread->PC + sizeof(instruction.opcode) + sizeof(srsvm_word) * instruction.argc;
+        while(! thread->is_halted && thread->call_stack.depth >= handler_depth){
+            if(srsvm_opcode_load_instruction(vm, thread->PC, &instruction)){
+                thread->next_PC = thread->PC + sizeof(instruction.opcode) + sizeof(srsvm_word) * instruction.argc;
 
-                    srsvm_vm_execute_instruction(vm, thread, &instruction);
-                }
+                srsvm_vm_execute_instruction(vm, thread, &instruction);
             }
         }
     }
@@ -0,0 +1,131 @@
+#include <string.h>
+
+#include "srsvm/debug.h"
+#include "srsvm/mmu.h"
+#include "srsvm/tlb.h"
+
+void srsvm_tlb_init(srsvm_tlb *tlb, srsvm_memory_segment *root_segment)
+{
+    srsvm_tlb_flush(tlb);
+
+    tlb->generation = 0;
+
+    tlb->hits = 0;
+    tlb->misses = 0;
+
+    tlb->root_segment = root_segment;
+    tlb->flat = root_segment->flat;
+
+    srsvm_mmu_reader_register(root_segment, &tlb->reader);
+}
+
+void srsvm_tlb_release(srsvm_tlb *tlb)
+{
+    srsvm_mmu_reader_unregister(tlb->root_segment, &tlb->reader);
+}
+
+void srsvm_tlb_flush(srsvm_tlb *tlb)
+{
+    memset(tlb->entries, 0, sizeof(tlb->entries));
+
+    tlb->next_victim = 0;
+}
+
+srsvm_memory_segment *srsvm_tlb_locate(srsvm_tlb *tlb, const srsvm_ptr address)
+{
+    unsigned generation = srsvm_atomic_load_acquire(&tlb->root_segment->generation);
+
+    if(generation != tlb->generation){
+        srsvm_tlb_flush(tlb);
+
+        tlb->generation = generation;
+    } else {
+        for(unsigned i = 0; i < SRSVM_TLB_ENTRIES; i++){
+            srsvm_tlb_entry *entry = &tlb->entries[i];
+
+            if(entry->segment != NULL && address >= entry->base && address - entry->base < entry->size){
+                tlb->hits++;
+
+                return entry->segment;
+            }
+        }
+    }
+
+    tlb->misses++;
+
+    srsvm_memory_segment *segment = srsvm_mmu_translate(tlb->root_segment, address);
+
+    if(segment != NULL && segment->literal_sz > 0){
+        srsvm_tlb_entry *entry = &tlb->entries[tlb->next_victim];
+
+        entry->segment = segment;
+        entry->base = segment->literal_start;
+        entry->size = segment->literal_sz;
+
+        tlb->next_victim = (tlb->next_victim + 1) % SRSVM_TLB_ENTRIES;
+    }
+
+    return segment;
+}
+
+bool srsvm_tlb_load(srsvm_tlb *tlb, const srsvm_ptr address, const srsvm_word bytes, void* dest)
+{
+    bool success = false;
+
+    srsvm_tlb_read_begin(tlb);
+
+#if defined(SRSVM_SUPPORT_FLAT_MEMORY)
+    char *host;
+
+    if(tlb->flat != NULL && (host = srsvm_mmu_flat_translate(tlb->flat, address, bytes, SRSVM_FLAT_PAGE_READ)) != NULL){
+        memcpy(dest, host, (size_t) bytes);
+
+        srsvm_tlb_read_end(tlb);
+
+        return true;
+    }
+#endif
+
+    srsvm_memory_segment *segment = srsvm_tlb_locate(tlb, address);
+
+    if(segment == NULL){
+        dbg_puts("failed to locate segment");
+    } else {
+        success = srsvm_mmu_segment_load(segment, address, bytes, dest);
+    }
+
+    srsvm_tlb_read_end(tlb);
+
+    return success;
+}
+
+bool srsvm_tlb_store(srsvm_tlb *tlb, const srsvm_ptr address, const srsvm_word bytes, void* src)
+{
+    bool success = false;
+
+    srsvm_tlb_read_begin(tlb);
+
+#if defined(SRSVM_SUPPORT_FLAT_MEMORY)
+    char *host;
+
+    if(tlb->flat != NULL && (host = srsvm_mmu_flat_translate(tlb->flat, address, bytes, SRSVM_FLAT_PAGE_WRITE)) != NULL){
+        memcpy(host, src, (size_t) bytes);
+
+        srsvm_tlb_read_end(tlb);
+
+        return true;
+    }
+#endif
+
+    srsvm_memory_segment *segment = srsvm_tlb_locate(tlb, address);
+
+    if(segment == NULL){
+        dbg_puts("failed to locate segment");
+    } else {
+        success = srsvm_mmu_segment_store(segment, address, bytes, src);
+    }
+
+    srsvm_tlb_read_end(tlb);
+
+    return success;
+}
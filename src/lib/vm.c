@@ -5,6 +5,7 @@
 
 #include "srsvm/constant.h"
 #include "srsvm/debug.h"
+#include "srsvm/decode.h"
 #include "srsvm/mmu.h"
 #include "srsvm/vm.h"
 
@@ -28,15 +29,12 @@ void srsvm_vm_free(srsvm_vm *vm)
             srsvm_string_map_walk(vm->module_map, mod_tree_free, NULL);
             srsvm_string_map_free(vm->module_map, false);
         }
-        if(vm->mem_root != NULL){
-            srsvm_mmu_set_all_free(vm->mem_root);
-            srsvm_mmu_free(vm->mem_root);
+        if(vm->preloaded_modules != NULL){
+            srsvm_string_map_walk(vm->preloaded_modules, mod_tree_free, NULL);
+            srsvm_string_map_free(vm->preloaded_modules, false);
         }
-
-        for(int i = 0; i < SRSVM_REGISTER_MAX_COUNT; i++){
-            if(vm->registers[i] != NULL){
-                srsvm_register_free(vm->registers[i]);
-            }
+        if(vm->module_path_cache != NULL){
+            srsvm_module_path_cache_free(vm->module_path_cache);
         }
 
         for(int i = 0; i < SRSVM_THREAD_MAX_COUNT; i++){
@@ -45,6 +43,29 @@ void srsvm_vm_free(srsvm_vm *vm)
             }
         }
 
+        if(vm->heap != NULL){
+            srsvm_heap_free(vm->heap);
+        }
+
+        if(vm->mem_root != NULL){
+            srsvm_mmu_set_all_free(vm->mem_root);
+            srsvm_mmu_free(vm->mem_root);
+        }
+
+        srsvm_program_file_release(vm->program_file);
+
+        srsvm_decode_cache *cache = vm->decode_caches, *next_cache;
+
+        while(cache != NULL){
+            next_cache = cache->next;
+            srsvm_decode_cache_free(cache);
+            cache = next_cache;
+        }
+
+        if(vm->registers != NULL){
+            srsvm_register_file_free(vm->registers);
+        }
+
         for(int i = 0; i < SRSVM_MODULE_MAX_COUNT; i++){
             if(vm->modules[i] != NULL){
                 //srsvm_module_free(vm->modules[i]);
@@ -76,33 +97,58 @@ srsvm_vm *srsvm_vm_alloc(void)
     vm = malloc(sizeof(srsvm_vm));
 
     if(vm != NULL){
-        memset(vm->registers, 0, sizeof(vm->registers));
         memset(vm->threads, 0, sizeof(vm->threads));
         memset(vm->modules, 0, sizeof(vm->modules));
         memset(vm->constants, 0, sizeof(vm->constants));
 
         vm->main_thread = NULL;
 
+        vm->registers = NULL;
         vm->mem_root = NULL;
+        vm->heap = NULL;
+        vm->decode_caches = NULL;
+
+        vm->program_file = NULL;
 
         vm->has_program_loaded = false;
 
         vm->has_fault = false;
         memset(vm->fault_str, 0, sizeof(vm->fault_str));
 
+        vm->pending_register_faults = 0;
+
         vm->argv = NULL;
         vm->argv = 0;
 
+        vm->engine = SRSVM_ENGINE_THREADED;
+
+        vm->preload_memory = false;
+        vm->verify_memory = false;
+
+        vm->module_generation = 1;
+
+        vm->module_search_path = NULL;
+        vm->preloaded_modules = NULL;
+        vm->module_path_cache = NULL;
+
         srsvm_vm_set_module_search_path(vm, NULL);
 
         if((vm->opcode_map = srsvm_opcode_map_alloc()) == NULL){
             goto error_cleanup;
         } else if((vm->module_map = srsvm_string_map_alloc(true)) == NULL){
             goto error_cleanup;
+        } else if((vm->preloaded_modules = srsvm_string_map_alloc(true)) == NULL){
+            goto error_cleanup;
+        } else if((vm->module_path_cache = srsvm_module_path_cache_alloc()) == NULL){
+            goto error_cleanup;
         } else if((vm->register_map = srsvm_string_map_alloc(false)) == NULL){
             goto error_cleanup;
+        } else if((vm->registers = srsvm_register_file_alloc()) == NULL){
+            goto error_cleanup;
         } else if((vm->mem_root = srsvm_mmu_alloc_virtual(NULL, SRSVM_MAX_PTR, 0)) == NULL){
             goto error_cleanup;
+        } else if((vm->heap = srsvm_heap_alloc(vm->mem_root)) == NULL){
+            goto error_cleanup;
         } else if(! load_builtin_opcodes(vm->opcode_map)){
             goto error_cleanup;
         }
@@ -151,6 +197,28 @@ bool srsvm_vm_execute_instruction(srsvm_vm *vm, srsvm_thread *thread, const srsv
     return success;
 }
 
+srsvm_decode_cache *srsvm_vm_decode_cache(srsvm_vm *vm, const srsvm_ptr addr)
+{
+    srsvm_decode_cache *cache = NULL;
+
+    srsvm_lock_acquire(&vm->mem_root->lock);
+
+    srsvm_memory_segment *seg = srsvm_mmu_locate(vm->mem_root, addr);
+
+    if(seg != NULL && seg->readable && seg->executable && seg->literal_sz > 0){
+        if((cache = seg->decode_cache) == NULL && (cache = srsvm_decode_cache_alloc(vm->mem_root, seg)) != NULL){
+            srsvm_mmu_set_decode_cache(seg, cache);
+
+            cache->next = vm->decode_caches;
+            vm->decode_caches = cache;
+        }
+    }
+
+    srsvm_lock_release(&vm->mem_root->lock);
+
+    return cache;
+}
+
 srsvm_thread *srsvm_vm_alloc_thread(srsvm_vm *vm, const srsvm_ptr start_addr, srsvm_ptr start_arg)
 {
     srsvm_thread *thread = NULL;
@@ -183,26 +251,68 @@ typedef struct
     srsvm_thread *thread;
 } srsvm_thread_info;
 
+static bool raise_register_file_fault(srsvm_vm *vm, const srsvm_register_file *file)
+{
+    for(srsvm_word i = 0; i < SRSVM_REGISTER_MAX_COUNT; i++){
+        srsvm_register *reg = &file->slots[i];
+
+        if(reg->flags->allocated && reg->flags->fault_on_error && reg->flags->error_flag){
+            srsvm_register_format_error(reg, vm->fault_str, sizeof(vm->fault_str));
+            vm->has_fault = true;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool srsvm_vm_raise_register_fault(srsvm_vm *vm, srsvm_thread *thread)
+{
+    if(! raise_register_file_fault(vm, vm->registers) && thread->registers != vm->registers){
+        raise_register_file_fault(vm, thread->registers);
+    }
+
+    return vm->has_fault;
+}
+
 void run_thread(void* arg)
 {
     srsvm_thread_info *info = arg;
 
+    srsvm_decode_cache *icache = NULL;
+
+    /* Decoded slots are only safe to use inside the decode reader's read
+     * section; it is moved forward between instructions, when no slot is
+     * held, so that retired decode tables can be reclaimed. */
+    srsvm_mmu_read_begin(info->vm->mem_root, &info->thread->decode_reader);
+
     while(! info->thread->is_halted && !info->vm->has_fault && !info->thread->has_fault){
-        for(srsvm_word i = 0; i < SRSVM_REGISTER_MAX_COUNT; i++){
-            if(info->vm->registers[i] != NULL){
-                if(info->vm->registers[i]->fault_on_error && info->vm->registers[i]->error_flag){
-                    strncpy(info->vm->fault_str, info->vm->registers[i]->error_str, sizeof(info->vm->fault_str));
-                    info->vm->has_fault = true;
-                }
-            } else break;
-        }
+        srsvm_mmu_read_refresh(info->vm->mem_root, &info->thread->decode_reader);
 
-        if(! info->vm->has_fault){
+        if(! srsvm_vm_check_register_faults(info->vm, info->thread)){
             info->thread->PC = info->thread->next_PC;
 
+            const srsvm_decoded_instruction *decoded = NULL;
+
+            if(icache == NULL || !srsvm_decode_cache_contains(icache, info->thread->PC)){
+                icache = srsvm_vm_decode_cache(info->vm, info->thread->PC);
+            }
+
+            if(icache != NULL){
+                decoded = srsvm_decode_cache_fetch(info->vm, icache, info->thread->PC);
+            }
+
             srsvm_instruction current_instruction;
 
-            if(! srsvm_opcode_load_instruction(info->vm, info->thread->PC, &current_instruction)){
+            if(decoded != NULL){
+                info->thread->next_PC = decoded->next_PC;
+
+                if(info->vm->engine == SRSVM_ENGINE_THREADED && decoded->handler != NULL){
+                    srsvm_builtin_run_threaded(info->vm, info->thread, icache, decoded);
+                } else {
+                    decoded->opcode->func(info->vm, info->thread, decoded->argc, decoded->argv);
+                }
+            } else if(! srsvm_opcode_load_instruction(info->vm, info->thread->PC, &current_instruction)){
                 info->thread->has_fault = true;
                 snprintf(info->thread->fault_str, sizeof(info->thread->fault_str), "Failed to load instruction at address " PRINT_WORD, PRINTF_WORD_PARAM(info->thread->PC));
             } else {
@@ -228,6 +338,8 @@ void run_thread(void* arg)
         }
     }
 
+    srsvm_mmu_read_end(&info->thread->decode_reader);
+
     srsvm_thread_exit_info *exit_info = malloc(sizeof(srsvm_thread_exit_info));
     
     exit_info->ret = SRSVM_NULL_PTR;
@@ -348,6 +460,190 @@ void srsvm_vm_set_module_search_path(srsvm_vm *vm, const char* search_path)
 
 }
 
+static bool register_module(srsvm_vm *vm, srsvm_module *mod)
+{
+    for(int i = 0; i < SRSVM_MODULE_MAX_COUNT; i++){
+        if(vm->modules[i] == NULL){
+            mod->id = i;
+
+            if(srsvm_string_map_insert(vm->module_map, mod->name, mod)){
+                vm->modules[i] = mod;
+
+                return true;
+            }
+
+            break;
+        }
+    }
+
+    return false;
+}
+
+static srsvm_module *claim_preloaded_module(srsvm_vm *vm, const char* module_name)
+{
+    srsvm_module *mod = srsvm_string_map_lookup(vm->preloaded_modules, module_name);
+
+    if(mod != NULL){
+        srsvm_string_map_remove(vm->preloaded_modules, module_name, false);
+
+        if(! register_module(vm, mod)){
+            srsvm_module_free(mod);
+            mod = NULL;
+        }
+    }
+
+    return mod;
+}
+
+typedef struct
+{
+    const char *name;
+
+    srsvm_module *mod;
+} module_preload;
+
+typedef struct
+{
+    srsvm_vm *vm;
+
+    module_preload *preloads;
+    size_t count;
+
+    const char *prog_cwd;
+
+    srsvm_atomic_counter next;
+} module_preload_job;
+
+static srsvm_module *preload_module(module_preload_job *job, const char* module_name, const bool search_multilib)
+{
+    srsvm_module *mod = NULL;
+
+    char *file_path = srsvm_module_path_cache_find(job->vm->module_path_cache, module_name, job->prog_cwd, job->vm->module_search_path, search_multilib);
+
+    if(file_path != NULL){
+        mod = srsvm_module_alloc(module_name, file_path, 0);
+
+        free(file_path);
+    }
+
+    return mod;
+}
+
+static void preload_worker(void *arg)
+{
+    module_preload_job *job = arg;
+
+    for(;;){
+        size_t i = srsvm_atomic_increment(&job->next) - 1;
+
+        if(i >= job->count){
+            break;
+        }
+
+        module_preload *preload = &job->preloads[i];
+
+        /* as in srsvm_vm_load_module, only look outside the multilib
+         * directories once the multilib copy is missing or fails to load */
+        if((preload->mod = preload_module(job, preload->name, true)) == NULL){
+            preload->mod = preload_module(job, preload->name, false);
+        }
+    }
+}
+
+/* Each module is found through the path cache, then opened and bound, on
+ * as many cores as there are modules to go around. Anything that fails to
+ * load here is left for MOD_LOAD to retry and report. */
+void srsvm_vm_preload_modules(srsvm_vm *vm, const srsvm_program *program)
+{
+    module_preload_job job = { vm, NULL, 0, NULL, 0 };
+    char *prog_cwd = NULL;
+
+    if(program->num_modules == 0 || (job.preloads = calloc(program->num_modules, sizeof(module_preload))) == NULL){
+        return;
+    }
+
+    prog_cwd = srsvm_getcwd();
+    job.prog_cwd = prog_cwd;
+
+    for(srsvm_module_specification *spec = program->modules; spec != NULL; spec = spec->next){
+        if(srsvm_module_is_builtin(spec->name)
+                || srsvm_string_map_contains(vm->module_map, spec->name)
+                || srsvm_string_map_contains(vm->preloaded_modules, spec->name)){
+            continue;
+        }
+
+        job.preloads[job.count++].name = spec->name;
+    }
+
+    if(job.count > 0){
+        size_t num_workers = srsvm_cpu_count();
+
+        if(num_workers > job.count){
+            num_workers = job.count;
+        }
+
+        num_workers = num_workers > SRSVM_VM_MAX_PRELOAD_THREADS ? SRSVM_VM_MAX_PRELOAD_THREADS - 1 : num_workers - 1;
+
+        srsvm_thread_native_handle workers[SRSVM_VM_MAX_PRELOAD_THREADS];
+        size_t started = 0;
+
+        while(started < num_workers && srsvm_native_thread_start(&workers[started], preload_worker, &job)){
+            started++;
+        }
+
+        preload_worker(&job);
+
+        for(size_t i = 0; i < started; i++){
+            srsvm_native_thread_join(&workers[i]);
+        }
+    }
+
+    for(size_t i = 0; i < job.count; i++){
+        module_preload *preload = &job.preloads[i];
+
+        if(preload->mod != NULL){
+            if(srsvm_string_map_insert(vm->preloaded_modules, preload->name, preload->mod)){
+                dbg_printf("preloaded module %s", preload->name);
+            } else {
+                srsvm_module_free(preload->mod);
+            }
+        }
+
+    }
+
+    srsvm_module_path_cache_save(vm->module_path_cache);
+
+    if(prog_cwd != NULL){
+        free(prog_cwd);
+    }
+
+    free(job.preloads);
+}
+
+static srsvm_module *load_builtin_module(srsvm_vm *vm, const char* module_name)
+{
+    srsvm_module *mod = NULL;
+
+    for(int i = 0; i < SRSVM_MODULE_MAX_COUNT; i++){
+        if(vm->modules[i] == NULL){
+            mod = srsvm_module_alloc_builtin(module_name, i);
+
+            if(mod != NULL){
+                if(srsvm_string_map_insert(vm->module_map, mod->name, mod)){
+                    vm->modules[i] = mod;
+                } else {
+                    srsvm_module_free(mod);
+                    mod = NULL;
+                }
+            }
+
+            break;
+        }
+    }
+
+    return mod;
+}
+
 srsvm_module *srsvm_vm_load_module(srsvm_vm *vm, const char* module_name)
 {
     srsvm_module *mod = NULL;
@@ -357,13 +653,15 @@ srsvm_module *srsvm_vm_load_module(srsvm_vm *vm, const char* module_name)
 
     if((mod = srsvm_string_map_lookup(vm->module_map, module_name)) != NULL){
         mod->ref_count++;
-    } else {
+    } else if(srsvm_module_is_builtin(module_name)){
+        mod = load_builtin_module(vm, module_name);
+    } else if((mod = claim_preloaded_module(vm, module_name)) == NULL){
         prog_cwd = srsvm_getcwd();
 
         bool search_multilib = true;
 
 search_again:
-        file_path = srsvm_module_find(module_name, prog_cwd, vm->module_search_path, search_multilib);
+        file_path = srsvm_module_path_cache_find(vm->module_path_cache, module_name, prog_cwd, vm->module_search_path, search_multilib);
 
         if(file_path != NULL){
             bool found_slot = false;
@@ -438,13 +736,15 @@ srsvm_module *srsvm_vm_load_module_slot(srsvm_vm *vm, const char* module_name, c
             }
         } else if((mod = srsvm_string_map_lookup(vm->module_map, module_name)) != NULL){
             mod->ref_count++;
-        } else {
+        } else if(srsvm_module_is_builtin(module_name)){
+            mod = load_builtin_module(vm, module_name);
+        } else if((mod = claim_preloaded_module(vm, module_name)) == NULL){
             prog_cwd = srsvm_getcwd();
 
             bool search_multilib = true;
 
 search_again:
-            file_path = srsvm_module_find(module_name, prog_cwd, vm->module_search_path, search_multilib);
+            file_path = srsvm_module_path_cache_find(vm->module_path_cache, module_name, prog_cwd, vm->module_search_path, search_multilib);
 
             if(file_path != NULL){
                 bool found_slot = false;
@@ -502,6 +802,8 @@ void srsvm_vm_unload_module(srsvm_vm *vm, srsvm_module *mod)
     mod->ref_count--;
 
     if(mod->ref_count == 0){
+        srsvm_atomic_increment(&vm->module_generation);
+
         vm->modules[mod->id] = NULL;
 
         srsvm_string_map_remove(vm->module_map, mod->name, false);
@@ -527,8 +829,11 @@ srsvm_register *srsvm_vm_register_alloc(srsvm_vm *vm, const char* name, const sr
 {
     srsvm_register *reg = NULL;
 
-    if(vm->registers[index] == NULL){
-        reg = (vm->registers[index] = srsvm_register_alloc(name, index));
+    reg = srsvm_register_alloc(vm->registers, name, index);
+
+    if(reg != NULL){
+        reg->flags->shared = srsvm_register_name_is_shared(name);
+        reg->pending_faults = &vm->pending_register_faults;
         srsvm_string_map_insert(vm->register_map, name, reg);
     }
 
@@ -632,21 +937,42 @@ bool srsvm_vm_load_program(srsvm_vm *vm, const srsvm_program *program)
             srsvm_literal_memory_specification *lmem = program->literal_memory;
 
             for(int i = 0; lmem != NULL && i < program->num_lmem_segments; i++){
-                srsvm_memory_segment *lmem_seg = srsvm_mmu_alloc_literal(vm->mem_root, lmem->size, lmem->start_address);
+                srsvm_memory_segment *lmem_seg;
+
+                if(lmem->file_backed || lmem->deferred){
+                    /* Map the segment straight onto the program file, or leave
+                     * it compressed until it is touched; either way the VM
+                     * keeps the file alive for as long as its segments. */
+                    if(lmem->deferred){
+                        lmem_seg = srsvm_mmu_alloc_literal_compressed(vm->mem_root, lmem->size, lmem->start_address, lmem->data, lmem->codec, lmem->chunk_size, lmem->num_chunks, lmem->chunk_offsets);
 
-                if(lmem_seg == NULL){
+                        if(lmem_seg != NULL && lmem->has_checksum){
+                            srsvm_mmu_segment_expect_checksum(lmem_seg, lmem->compressed_size, lmem->checksum);
+                        }
+                    } else if(vm->verify_memory && ! srsvm_program_lmem_verify(lmem)){
+                        return false;
+                    } else {
+                        lmem_seg = srsvm_mmu_alloc_literal_backed(vm->mem_root, lmem->size, lmem->start_address, lmem->data);
+                    }
+
+                    if(lmem_seg == NULL){
+                        return false;
+                    } else if(vm->program_file == NULL){
+                        vm->program_file = srsvm_program_file_acquire(program->file);
+                    }
+                } else if((lmem_seg = srsvm_mmu_alloc_literal(vm->mem_root, lmem->size, lmem->start_address)) == NULL){
                     return false;
                 } else if(! srsvm_mmu_store(vm->mem_root, lmem->start_address, lmem->size, lmem->data)){
                     return false;
-                } else {
-                    lmem_seg->readable = lmem->readable;
-                    lmem_seg->writable = lmem->writable;
-                    lmem_seg->executable = lmem->executable;
+                }
 
-                    lmem_seg->locked = lmem->locked;
+                srsvm_mmu_set_permissions(lmem_seg, lmem->readable, lmem->writable, lmem->executable, lmem->locked);
 
-                    lmem = lmem->next;
+                if(vm->preload_memory && ! srsvm_mmu_segment_materialize(lmem_seg, lmem_seg->literal_start, lmem_seg->literal_sz)){
+                    return false;
                 }
+
+                lmem = lmem->next;
             }
 
             srsvm_constant_specification *c = program->constants;
@@ -718,3 +1044,43 @@ void srsvm_vm_set_fault_handler(srsvm_vm *vm, srsvm_vm_fault_handler fault_handl
 {
     vm->fault_handler = fault_handler;
 }
+
+bool srsvm_vm_set_engine_name(srsvm_vm *vm, const char* engine_name)
+{
+    bool success = true;
+
+    if(srsvm_strcasecmp(engine_name, "call") == 0){
+        vm->engine = SRSVM_ENGINE_CALL;
+    } else if(srsvm_strcasecmp(engine_name, "threaded") == 0){
+        vm->engine = SRSVM_ENGINE_THREADED;
+    } else {
+        success = false;
+    }
+
+    return success;
+}
+
+void srsvm_vm_set_preload_memory(srsvm_vm *vm, const bool preload_memory)
+{
+    vm->preload_memory = preload_memory;
+}
+
+void srsvm_vm_set_verify_memory(srsvm_vm *vm, const bool verify_memory)
+{
+    vm->verify_memory = verify_memory;
+}
+
+bool srsvm_vm_set_memory_name(srsvm_vm *vm, const char* memory_name)
+{
+    bool success = true;
+
+    if(srsvm_strcasecmp(memory_name, "segmented") == 0){
+        success = vm->mem_root->flat == NULL;
+    } else if(srsvm_strcasecmp(memory_name, "flat") == 0){
+        success = srsvm_mmu_map_flat(vm->mem_root);
+    } else {
+        success = false;
+    }
+
+    return success;
+}
@@ -41,10 +41,10 @@
             ctype_to val_out; \
             size_t parsed_chars = 0; \
             if(src_reg->value.str == NULL){ \
-                set_register_error_bit(dest_reg, "Attempted to parse a null string"); \
+                set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_PARSE_NULL, NULL); \
             } else { \
                 if(sscanf(fmt "%n", src_reg->value.str, &val_out, &parsed_chars) < 1 || parsed_chars < strlen(src_reg->value.str)){ \
-                    set_register_error_bit(dest_reg, #type_to " parse failed"); \
+                    set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_PARSE, #type_to); \
                 } else if(! EVAL2(load,field_to)(dest_reg, val_out, dest_offset)){ \
 		    thread_set_fault(thread, "Failed to load value into register"); \
                 } \
@@ -70,7 +70,7 @@
             } else { \
                 int out_len = snprintf(buf, sizeof(buf), fmt, val_in); \
                 if(out_len <= 0){ \
-                    set_register_error_bit(dest_reg, "Failed to serialize " #type_from); \
+                    set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_SERIALIZE, #type_from); \
                 } else if(! load_str(dest_reg, buf, (size_t) out_len)){ \
 		    thread_set_fault(thread, "Failed to load value into register"); \
                 } \
@@ -94,7 +94,7 @@ void conversion_PARSE_U128_128(srsvm_vm *vm, srsvm_thread *thread, const srsvm_w
     srsvm_word dest_offset = argc < 3 ? 0 : argv[2].value;
     if(dest_reg != NULL && src_reg != NULL && !fault_on_not_writable(thread, dest_reg)){
         if(src_reg->value.str == NULL){ \
-            set_register_error_bit(dest_reg, "Attempted to parse a null string");
+            set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_PARSE_NULL, NULL);
         } else {
             char *src = src_reg->value.str;
             size_t src_len = strlen(src);
@@ -108,7 +108,7 @@ void conversion_PARSE_U128_128(srsvm_vm *vm, srsvm_thread *thread, const srsvm_w
             if(src_len <= 32){
                 int parsed_chars = 0;
                 if(sscanf(src, "0x%" SCNx64 "%n", &lower, &parsed_chars) < 1 || parsed_chars < src_len){
-                    set_register_error_bit(dest_reg, "U128 parse failed");
+                    set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_PARSE, "U128");
                 } else {
                     val_out = lower;
                     parse_success = true;
@@ -126,7 +126,7 @@ void conversion_PARSE_U128_128(srsvm_vm *vm, srsvm_thread *thread, const srsvm_w
 
                 if(sscanf(lower_buf, "%" SCNx64 "%n", &lower, &lower_parsed_chars) < 1 || lower_parsed_chars < lower_len || 
                         sscanf(upper_buf, "0x%" SCNx64 "%n", &upper, &upper_parsed_chars) < 1 || upper_parsed_chars < upper_len){
-                    set_register_error_bit(dest_reg, "U128 parse failed");
+                    set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_PARSE, "U128");
                 } else parse_success = true;
             }
 
@@ -163,7 +163,7 @@ void conversion_U128_TO_STR_128(srsvm_vm *vm, srsvm_thread *thread, const srsvm_
             }
 
             if(out_len <= 0){
-                set_register_error_bit(dest_reg, "Failed to serialize U128");
+                set_register_error_bit(dest_reg, SRSVM_REGISTER_ERROR_SERIALIZE, "U128");
             } else if(! load_str(dest_reg, buf, (size_t) out_len)){
                 thread_set_fault(thread, "Failed to load value into register");
             }
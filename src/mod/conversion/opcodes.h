@@ -1,5 +1,3 @@
-#pragma once
-
 #include "config.h"
 
 #include "macro_helpers.h"
@@ -10,16 +8,15 @@
 
 #endif
 
-srsvm_word code = 0;
-
+/* Parse failures set the destination's error bit rather than faulting. */
 #define CAST_CONVERTER(name,type_from,ctype_from,field_from,type_to,ctype_to,field_to) \
-    REGISTER_OPCODE(code++,name,2,4);
+    REGISTER_OPCODE(name,2,4,SRSVM_OPCODE_FLAG_PURE | SRSVM_OPCODE_FLAG_NO_FAULT)
 
 #define PARSE_CONVERTER(name,type_to,ctype_to,field_to,fmt) \
-    REGISTER_OPCODE(code++,name,2,3);
+    REGISTER_OPCODE(name,2,3,SRSVM_OPCODE_FLAG_PURE | SRSVM_OPCODE_FLAG_NO_FAULT)
 
 #define TOSTR_CONVERTER(name,type_from,ctype_from,field_from,fmt) \
-    REGISTER_OPCODE(code++,name,2,3);
+    REGISTER_OPCODE(name,2,3,SRSVM_OPCODE_FLAG_PURE | SRSVM_OPCODE_FLAG_NO_FAULT)
 
 #define IMPL_U128_PARSERS
 
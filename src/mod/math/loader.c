@@ -14,40 +14,49 @@
 #include "macro_helpers.h"
 #include "mod_math.h"
 
-static bool register_opcode(srsvm_module_opcode_loader loader, srsvm_word code, const char* name, const unsigned short a_min, const unsigned short a_max, srsvm_opcode_func *func, void* arg)
+enum
 {
-    bool success = false;
-
-    srsvm_opcode *opcode = malloc(sizeof(srsvm_opcode));
-
-    if(opcode != NULL){
-        opcode->code = code;
-        memset(opcode->name, 0, sizeof(opcode->name));
-        if(strlen(name) > 0){
-            strncpy(opcode->name, name, sizeof(opcode->name) - 1);
-        }
-        opcode->argc_min = a_min;
-        opcode->argc_max = a_max;
-        opcode->func = func;
+#define REGISTER_OPCODE(n,a_min,a_max,op_flags) EVAL2(MATH_OPCODE,n),
+#include "opcodes.h"
+#undef REGISTER_OPCODE
+};
 
-        if(loader(arg, opcode)){
-            success = true;
-        }
-    }
+static const srsvm_opcode opcodes[] = {
+#define REGISTER_OPCODE(n,a_min,a_max,op_flags) \
+    { .code = EVAL2(MATH_OPCODE,n), .name = STR(n), .argc_min = a_min, .argc_max = a_max, .func = EVAL3(math,n,WORD_SIZE), .flags = op_flags },
+#include "opcodes.h"
+#undef REGISTER_OPCODE
+};
 
-    return success;
-}
+#if defined(SRSVM_BUILTIN_MODULE)
+const srsvm_opcode_table EVAL2(srsvm_builtin_math_opcode_table,WORD_SIZE) =
+#else
+const srsvm_opcode_table EVAL2(srsvm_opcode_table,WORD_SIZE) =
+#endif
+{
+    SRSVM_OPCODE_TABLE_ABI_VERSION, sizeof(opcodes) / sizeof(opcodes[0]), opcodes
+};
 
+#if !defined(SRSVM_BUILTIN_MODULE)
+/* Runtimes without opcode table support take ownership of a heap copy of
+ * each opcode instead. */
 bool EVAL2(srsvm_enumerate_opcodes,WORD_SIZE)(srsvm_module_opcode_loader loader, void* arg)
 {
-    bool success = true;
+    for(size_t i = 0; i < sizeof(opcodes) / sizeof(opcodes[0]); i++){
+        srsvm_opcode *opcode = malloc(sizeof(srsvm_opcode));
 
-#define REGISTER_OPCODE(c,n,a_min,a_max) do { \
-    if(! register_opcode(loader, c, STR(n), a_min, a_max, EVAL3(math,n,WORD_SIZE), arg)){ \
-        success = false; \
-    } } while(0) ;
+        if(opcode == NULL){
+            return false;
+        }
 
-#include "opcodes.h"
+        memcpy(opcode, &opcodes[i], sizeof(srsvm_opcode));
 
-    return success;
+        if(! loader(arg, opcode)){
+            free(opcode);
+            return false;
+        }
+    }
+
+    return true;
 }
+#endif
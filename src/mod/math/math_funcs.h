@@ -32,7 +32,7 @@
 #define OP_DIV(type,ctype,field) \
     BINARY_OPERATOR(DIV,type,ctype,field,(a_val / b_val), b_val == 0, "Division by zero")
 #define OP_INTEGRAL_REM(type,ctype,field) \
-    BINARY_OPERATOR(REM,type,ctype,field,(a_val % b_val), false, "")
+    BINARY_OPERATOR(REM,type,ctype,field,(a_val % b_val), b_val == 0, "Division by zero")
 
 #define OP_FLOATING_ABS(type,ctype,field) \
     UNARY_OPERATOR(ABS,type,ctype,field,(fabs(a_val)), false, "")
@@ -120,27 +120,27 @@
     OP_CEIL(type,ctype,field)
 
 
-UNSIGNED_INTEGRAL_FUNCS(U8,uint8_t,u8);
-SIGNED_INTEGRAL_FUNCS(I8,int8_t,i8);
+UNSIGNED_INTEGRAL_FUNCS(U8,uint8_t,u8)
+SIGNED_INTEGRAL_FUNCS(I8,int8_t,i8)
 
-UNSIGNED_INTEGRAL_FUNCS(U16,uint16_t,u16);
-SIGNED_INTEGRAL_FUNCS(I16,int16_t,i16);
+UNSIGNED_INTEGRAL_FUNCS(U16,uint16_t,u16)
+SIGNED_INTEGRAL_FUNCS(I16,int16_t,i16)
 
 #if WORD_SIZE == 32 || WORD_SIZE == 64 || WORD_SIZE == 128
-UNSIGNED_INTEGRAL_FUNCS(U32,uint32_t,u32);
-SIGNED_INTEGRAL_FUNCS(I32,int32_t,i32);
+UNSIGNED_INTEGRAL_FUNCS(U32,uint32_t,u32)
+SIGNED_INTEGRAL_FUNCS(I32,int32_t,i32)
 
-FLOAT_FUNCS(F32,float,f32);
+FLOAT_FUNCS(F32,float,f32)
 #endif
 
 #if WORD_SIZE == 64 || WORD_SIZE == 128
-UNSIGNED_INTEGRAL_FUNCS(U64,uint64_t,u64);
-SIGNED_INTEGRAL_FUNCS(I64,int64_t,i64);
+UNSIGNED_INTEGRAL_FUNCS(U64,uint64_t,u64)
+SIGNED_INTEGRAL_FUNCS(I64,int64_t,i64)
 
-FLOAT_FUNCS(F64,double,f64);
+FLOAT_FUNCS(F64,double,f64)
 #endif
 
 #if WORD_SIZE == 128
-UNSIGNED_INTEGRAL_FUNCS(U128,unsigned __int128,u128);
-SIGNED_INTEGRAL_FUNCS(I128,__int128,i128);
+UNSIGNED_INTEGRAL_FUNCS(U128,unsigned __int128,u128)
+SIGNED_INTEGRAL_FUNCS(I128,__int128,i128)
 #endif
@@ -88,6 +88,8 @@
 
 #if defined(SRSVM_MOD_MATH_VECTORIZED)
 
+#include "vec_kernels.h"
+
 #define IMPL_VECTORIZED_UNARY_OPERATOR(name,type,ctype,field,expression,fault_cond,fault_message) \
     void EVAL4(math_VEC,name,type,WORD_SIZE)(srsvm_vm *vm, srsvm_thread *thread, const srsvm_word argc, const srsvm_arg argv[]) \
     { \
@@ -95,6 +97,9 @@
         srsvm_register *a_reg = register_lookup(vm, thread, &argv[1]); \
         if(dest_reg != NULL && a_reg != NULL && !fault_on_not_writable(thread, dest_reg)){ \
             ctype a_val; \
+            if(vec_kernels.EVAL2(name,type) != NULL && vec_kernels.EVAL2(name,type)(&dest_reg->value, &a_reg->value, NULL)){ \
+                return; \
+            } \
             for(size_t i = 0; i < sizeof(a_reg->value.field)/sizeof(ctype); i++){ \
                 a_val = a_reg->value.field[i]; \
                 if(fault_cond){ \
@@ -114,6 +119,9 @@
         srsvm_register *b_reg = register_lookup(vm, thread, &argv[2]); \
         if(dest_reg != NULL && a_reg != NULL && b_reg != NULL && !fault_on_not_writable(thread, dest_reg)){ \
             ctype a_val, b_val; \
+            if(vec_kernels.EVAL2(name,type) != NULL && vec_kernels.EVAL2(name,type)(&dest_reg->value, &a_reg->value, &b_reg->value)){ \
+                return; \
+            } \
             for(size_t i = 0; i < sizeof(a_reg->value.field)/sizeof(ctype); i++){ \
                 a_val = a_reg->value.field[i]; \
                 b_val = b_reg->value.field[i]; \
@@ -1,5 +1,3 @@
-#pragma once
-
 #include "config.h"
 
 #include "macro_helpers.h"
@@ -10,37 +8,37 @@
 
 #endif
 
-srsvm_word code = 0;
-
+/* Every operator only touches registers; it can fault on operand values
+ * exactly when it declares a fault message. */
+#define OPERATOR_FLAGS(fault_message) \
+    (SRSVM_OPCODE_FLAG_PURE | (sizeof(fault_message) == 1 ? SRSVM_OPCODE_FLAG_NO_FAULT : 0))
 
 #if defined(SRSVM_MOD_MATH_VECTORIZED)
 
 #define UNARY_OPERATOR(name,type,ctype,field,expression,fault_cond,fault_message) \
-    REGISTER_OPCODE(code++,EVAL2(name,type),2,4); \
-    REGISTER_OPCODE(code++,EVAL3(VEC,name,type),2,2);
+    REGISTER_OPCODE(EVAL2(name,type),2,4,OPERATOR_FLAGS(fault_message)) \
+    REGISTER_OPCODE(EVAL3(VEC,name,type),2,2,OPERATOR_FLAGS(fault_message))
 
-#define BINARY_OPERATOR(name,type,ctype,field,expression,fault_cond,fault_essage) \
-    REGISTER_OPCODE(code++,EVAL2(name,type),3,6); \
-    REGISTER_OPCODE(code++,EVAL3(VEC,name,type),3,3);
+#define BINARY_OPERATOR(name,type,ctype,field,expression,fault_cond,fault_message) \
+    REGISTER_OPCODE(EVAL2(name,type),3,6,OPERATOR_FLAGS(fault_message)) \
+    REGISTER_OPCODE(EVAL3(VEC,name,type),3,3,OPERATOR_FLAGS(fault_message))
 
 #else
 
-#define UNARY_OPERATOR(name,type,ctype8yy,field,expression,fault_cond,fault_message) \
-    REGISTER_OPCODE(code++,EVAL2(name,type),2,4);
-
-#define BINARY_OPERATOR(name,type,ctype,field,expression,fault_cond,fault_essage) \
-    REGISTER_OPCODE(code++,EVAL2(name,type),3,6);
+#define UNARY_OPERATOR(name,type,ctype,field,expression,fault_cond,fault_message) \
+    REGISTER_OPCODE(EVAL2(name,type),2,4,OPERATOR_FLAGS(fault_message))
 
-#define TERNARY_OPERATOR(name,type,ctype,field,expression,fault_cond,fault_essage) \
-    REGISTER_OPCODE(code++,EVAL2(name,type),4,8);
+#define BINARY_OPERATOR(name,type,ctype,field,expression,fault_cond,fault_message) \
+    REGISTER_OPCODE(EVAL2(name,type),3,6,OPERATOR_FLAGS(fault_message))
 
 #endif
 
-#define TERNARY_OPERATOR(name,type,ctype,field,expression,fault_cond,fault_essage) \
-    REGISTER_OPCODE(code++,EVAL2(name,type),4,8);
+#define TERNARY_OPERATOR(name,type,ctype,field,expression,fault_cond,fault_message) \
+    REGISTER_OPCODE(EVAL2(name,type),4,8,OPERATOR_FLAGS(fault_message))
 
 #include "math_funcs.h"
 
+#undef OPERATOR_FLAGS
 #undef UNARY_OPERATOR
 #undef BINARY_OPERATOR
 #undef TERNARY_OPERATOR
@@ -0,0 +1,194 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "vec_kernels.h"
+
+/* Built without -ffast-math: under it GCC turns vectorized float division
+ * into a reciprocal estimate, which is not exact even for divisors like
+ * 0.5. */
+
+math_vec_kernel_table vec_kernels;
+
+/* A register is at most 16 bytes wide, so a single SSE register holds all
+ * of its lanes and wider vectors have nothing more to offer. */
+#if (WORD_SIZE == 64 || WORD_SIZE == 128) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+
+#include <immintrin.h>
+
+#if WORD_SIZE == 128
+#define VEC_LOAD(p) _mm_loadu_si128((const __m128i*) (p))
+#define VEC_STORE(p,v) _mm_storeu_si128((__m128i*) (p), (v))
+#define VEC_BYTE_MASK 0xFFFF
+#else
+#define VEC_LOAD(p) _mm_loadl_epi64((const __m128i*) (p))
+#define VEC_STORE(p,v) _mm_storel_epi64((__m128i*) (p), (v))
+#define VEC_BYTE_MASK 0x00FF
+#endif
+
+#define AS_INT(v) (v)
+#define AS_PS(v) _mm_castsi128_ps(v)
+#define AS_PD(v) _mm_castsi128_pd(v)
+#define FROM_PS(v) _mm_castps_si128(v)
+#define FROM_PD(v) _mm_castpd_si128(v)
+
+#define SIMD_UNARY_KERNEL(name,type,isa,op,cast_in,cast_out) \
+    __attribute__((target(isa))) static bool EVAL3(simd,name,type)(void *dest, const void *a, const void *b) \
+    { \
+        VEC_STORE(dest, cast_out(op(cast_in(VEC_LOAD(a))))); \
+        return true; \
+    }
+
+#define SIMD_BINARY_KERNEL(name,type,isa,op,cast_in,cast_out) \
+    __attribute__((target(isa))) static bool EVAL3(simd,name,type)(void *dest, const void *a, const void *b) \
+    { \
+        VEC_STORE(dest, cast_out(op(cast_in(VEC_LOAD(a)), cast_in(VEC_LOAD(b))))); \
+        return true; \
+    }
+
+/* Any zero divisor hands the whole register back to the scalar loop so
+ * that the fault is raised exactly as before. */
+#define SIMD_DIV_KERNEL(type,op,cmpeq,setzero,cast_in,cast_out) \
+    __attribute__((target("sse2"))) static bool EVAL3(simd,DIV,type)(void *dest, const void *a, const void *b) \
+    { \
+        __m128i b_v = VEC_LOAD(b); \
+        if(_mm_movemask_epi8(cast_out(cmpeq(cast_in(b_v), setzero()))) & VEC_BYTE_MASK){ \
+            return false; \
+        } \
+        VEC_STORE(dest, cast_out(op(cast_in(VEC_LOAD(a)), cast_in(b_v)))); \
+        return true; \
+    }
+
+/* SSE has no byte multiply: multiply the even and odd bytes as 16-bit
+ * lanes and keep the low byte of each product. */
+__attribute__((target("sse2"))) static inline __m128i mullo_epi8(const __m128i a, const __m128i b)
+{
+    __m128i even = _mm_mullo_epi16(a, b);
+    __m128i odd = _mm_mullo_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+
+    return _mm_or_si128(_mm_and_si128(even, _mm_set1_epi16(0xFF)), _mm_slli_epi16(odd, 8));
+}
+
+__attribute__((target("sse2"))) static inline __m128 abs_ps(const __m128 a)
+{
+    return _mm_and_ps(a, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF)));
+}
+
+__attribute__((target("sse2"))) static inline __m128d abs_pd(const __m128d a)
+{
+    return _mm_and_pd(a, _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFFLL)));
+}
+
+SIMD_BINARY_KERNEL(ADD,U8,"sse2",_mm_add_epi8,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(ADD,I8,"sse2",_mm_add_epi8,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(ADD,U16,"sse2",_mm_add_epi16,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(ADD,I16,"sse2",_mm_add_epi16,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(ADD,U32,"sse2",_mm_add_epi32,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(ADD,I32,"sse2",_mm_add_epi32,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(ADD,U64,"sse2",_mm_add_epi64,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(ADD,I64,"sse2",_mm_add_epi64,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(ADD,F32,"sse2",_mm_add_ps,AS_PS,FROM_PS)
+SIMD_BINARY_KERNEL(ADD,F64,"sse2",_mm_add_pd,AS_PD,FROM_PD)
+
+SIMD_BINARY_KERNEL(SUB,U8,"sse2",_mm_sub_epi8,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(SUB,I8,"sse2",_mm_sub_epi8,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(SUB,U16,"sse2",_mm_sub_epi16,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(SUB,I16,"sse2",_mm_sub_epi16,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(SUB,U32,"sse2",_mm_sub_epi32,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(SUB,I32,"sse2",_mm_sub_epi32,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(SUB,U64,"sse2",_mm_sub_epi64,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(SUB,I64,"sse2",_mm_sub_epi64,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(SUB,F32,"sse2",_mm_sub_ps,AS_PS,FROM_PS)
+SIMD_BINARY_KERNEL(SUB,F64,"sse2",_mm_sub_pd,AS_PD,FROM_PD)
+
+SIMD_BINARY_KERNEL(MUL,U8,"sse2",mullo_epi8,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(MUL,I8,"sse2",mullo_epi8,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(MUL,U16,"sse2",_mm_mullo_epi16,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(MUL,I16,"sse2",_mm_mullo_epi16,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(MUL,U32,"sse4.1",_mm_mullo_epi32,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(MUL,I32,"sse4.1",_mm_mullo_epi32,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(MUL,F32,"sse2",_mm_mul_ps,AS_PS,FROM_PS)
+SIMD_BINARY_KERNEL(MUL,F64,"sse2",_mm_mul_pd,AS_PD,FROM_PD)
+
+SIMD_DIV_KERNEL(F32,_mm_div_ps,_mm_cmpeq_ps,_mm_setzero_ps,AS_PS,FROM_PS)
+SIMD_DIV_KERNEL(F64,_mm_div_pd,_mm_cmpeq_pd,_mm_setzero_pd,AS_PD,FROM_PD)
+
+/* minps/maxps return the second operand when either is NaN or both are
+ * zero, which is what the scalar comparisons do too. */
+SIMD_BINARY_KERNEL(MIN,U8,"sse2",_mm_min_epu8,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(MIN,I8,"sse4.1",_mm_min_epi8,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(MIN,U16,"sse4.1",_mm_min_epu16,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(MIN,I16,"sse2",_mm_min_epi16,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(MIN,U32,"sse4.1",_mm_min_epu32,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(MIN,I32,"sse4.1",_mm_min_epi32,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(MIN,F32,"sse2",_mm_min_ps,AS_PS,FROM_PS)
+SIMD_BINARY_KERNEL(MIN,F64,"sse2",_mm_min_pd,AS_PD,FROM_PD)
+
+SIMD_BINARY_KERNEL(MAX,U8,"sse2",_mm_max_epu8,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(MAX,I8,"sse4.1",_mm_max_epi8,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(MAX,U16,"sse4.1",_mm_max_epu16,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(MAX,I16,"sse2",_mm_max_epi16,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(MAX,U32,"sse4.1",_mm_max_epu32,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(MAX,I32,"sse4.1",_mm_max_epi32,AS_INT,AS_INT)
+SIMD_BINARY_KERNEL(MAX,F32,"sse2",_mm_max_ps,AS_PS,FROM_PS)
+SIMD_BINARY_KERNEL(MAX,F64,"sse2",_mm_max_pd,AS_PD,FROM_PD)
+
+SIMD_UNARY_KERNEL(ABS,I8,"ssse3",_mm_abs_epi8,AS_INT,AS_INT)
+SIMD_UNARY_KERNEL(ABS,I16,"ssse3",_mm_abs_epi16,AS_INT,AS_INT)
+SIMD_UNARY_KERNEL(ABS,I32,"ssse3",_mm_abs_epi32,AS_INT,AS_INT)
+SIMD_UNARY_KERNEL(ABS,F32,"sse2",abs_ps,AS_PS,FROM_PS)
+SIMD_UNARY_KERNEL(ABS,F64,"sse2",abs_pd,AS_PD,FROM_PD)
+
+SIMD_UNARY_KERNEL(SQRT,F32,"sse2",_mm_sqrt_ps,AS_PS,FROM_PS)
+SIMD_UNARY_KERNEL(SQRT,F64,"sse2",_mm_sqrt_pd,AS_PD,FROM_PD)
+
+#define USE_KERNEL(name,type) vec_kernels.EVAL2(name,type) = EVAL3(simd,name,type)
+
+/* Setting SRSVM_MATH_SIMD=0 keeps every VEC_ opcode on the scalar loop,
+ * for comparing the two. */
+__attribute__((constructor)) static void select_vec_kernels(void)
+{
+    const char *setting = getenv("SRSVM_MATH_SIMD");
+
+    if(setting != NULL && strcmp(setting, "0") == 0){
+        return;
+    }
+
+    __builtin_cpu_init();
+
+    if(__builtin_cpu_supports("sse2")){
+        USE_KERNEL(ADD,U8); USE_KERNEL(ADD,I8); USE_KERNEL(ADD,U16); USE_KERNEL(ADD,I16);
+        USE_KERNEL(ADD,U32); USE_KERNEL(ADD,I32); USE_KERNEL(ADD,U64); USE_KERNEL(ADD,I64);
+        USE_KERNEL(ADD,F32); USE_KERNEL(ADD,F64);
+
+        USE_KERNEL(SUB,U8); USE_KERNEL(SUB,I8); USE_KERNEL(SUB,U16); USE_KERNEL(SUB,I16);
+        USE_KERNEL(SUB,U32); USE_KERNEL(SUB,I32); USE_KERNEL(SUB,U64); USE_KERNEL(SUB,I64);
+        USE_KERNEL(SUB,F32); USE_KERNEL(SUB,F64);
+
+        USE_KERNEL(MUL,U8); USE_KERNEL(MUL,I8); USE_KERNEL(MUL,U16); USE_KERNEL(MUL,I16);
+        USE_KERNEL(MUL,F32); USE_KERNEL(MUL,F64);
+
+        USE_KERNEL(DIV,F32); USE_KERNEL(DIV,F64);
+
+        USE_KERNEL(MIN,U8); USE_KERNEL(MIN,I16); USE_KERNEL(MIN,F32); USE_KERNEL(MIN,F64);
+        USE_KERNEL(MAX,U8); USE_KERNEL(MAX,I16); USE_KERNEL(MAX,F32); USE_KERNEL(MAX,F64);
+
+        USE_KERNEL(ABS,F32); USE_KERNEL(ABS,F64);
+
+        USE_KERNEL(SQRT,F32); USE_KERNEL(SQRT,F64);
+    }
+
+    if(__builtin_cpu_supports("ssse3")){
+        USE_KERNEL(ABS,I8); USE_KERNEL(ABS,I16); USE_KERNEL(ABS,I32);
+    }
+
+    if(__builtin_cpu_supports("sse4.1")){
+        USE_KERNEL(MUL,U32); USE_KERNEL(MUL,I32);
+
+        USE_KERNEL(MIN,I8); USE_KERNEL(MIN,U16); USE_KERNEL(MIN,U32); USE_KERNEL(MIN,I32);
+        USE_KERNEL(MAX,I8); USE_KERNEL(MAX,U16); USE_KERNEL(MAX,U32); USE_KERNEL(MAX,I32);
+    }
+}
+
+#undef USE_KERNEL
+
+#endif
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "config.h"
+
+#include "srsvm/value_types.h"
+
+#include "macro_helpers.h"
+
+#if !defined(WORD_SIZE)
+
+#error "WORD_SIZE not defined"
+
+#endif
+
+/* Runs a VEC_ opcode over whole registers; returns false to leave the
+ * opcode to the lane-by-lane loop, which is how a kernel reports lanes
+ * that would fault. */
+typedef bool (*math_vec_kernel)(void *dest, const void *a, const void *b);
+
+/* One slot per VEC_ opcode, set when the module is loaded to the best
+ * kernel the host supports. */
+typedef struct
+{
+#define UNARY_OPERATOR(name,type,ctype,field,expression,fault_cond,fault_message) math_vec_kernel EVAL2(name,type);
+#define BINARY_OPERATOR(name,type,ctype,field,expression,fault_cond,fault_message) math_vec_kernel EVAL2(name,type);
+#define TERNARY_OPERATOR(name,type,ctype,field,expression,fault_cond,fault_message)
+
+#include "math_funcs.h"
+
+#undef UNARY_OPERATOR
+#undef BINARY_OPERATOR
+#undef TERNARY_OPERATOR
+} math_vec_kernel_table;
+
+#define vec_kernels EVAL2(math_vec_kernels,WORD_SIZE)
+
+extern math_vec_kernel_table vec_kernels;
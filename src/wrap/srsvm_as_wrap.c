@@ -36,6 +36,9 @@ void show_usage(const char* error)
     fprintf(stderr, "      -o output_file.svm    : specify output filename\n");
     fprintf(stderr, "      -A <alignment>        : specify target output alignment (default: 0)\n");
     fprintf(stderr, "      -L <mod_search_path>  : specify module search path (semicolon separated)\n");
+    fprintf(stderr, "      -U  |  --uncompressed : store program memory uncompressed, so it can be mapped at load time\n");
+    fprintf(stderr, "      -F <version>          : specify output file format version (1/2, default: 2)\n");
+    fprintf(stderr, "      -C <codec>            : compress program memory with zlib, lz4 or zstd (default: zlib)\n");
     fprintf(stderr, "      -D  |  --debug        : enable srsvm debug messages\n");
     fprintf(stderr, "      -h  |  --help         : show this help information\n");
 
@@ -37,6 +37,8 @@ void show_usage(const char* error)
 	fprintf(stderr, "      -A <alignment>        : specify target output alignment (default: 0)\n");
 	fprintf(stderr, "      -L <mod_search_path>  : specify module search path (semicolon separated)\n");
 	fprintf(stderr, "      -D  |  --debug        : enable srsvm debug messages\n");
+	fprintf(stderr, "      -e <engine>           : select the execution engine: threaded (default) or call\n");
+	fprintf(stderr, "      -m <memory>           : select the guest memory layout: segmented (default) or flat\n");
 	fprintf(stderr, "      -h  |  --help         : show this help information\n");
 
 	if(error != NULL){
@@ -33,6 +33,10 @@ void show_usage(const char* error)
     fprintf(stderr, "    optional arguments:\n");
     fprintf(stderr, "\n");
     fprintf(stderr, "      -d  |  --debug        : enable srsvm debug messages\n");
+    fprintf(stderr, "      -e <engine>           : select the execution engine: threaded (default) or call\n");
+    fprintf(stderr, "      -m <memory>           : select the guest memory layout: segmented (default) or flat\n");
+    fprintf(stderr, "      -p  |  --preload      : inflate compressed program memory at load time, on all cores\n");
+    fprintf(stderr, "      -V  |  --verify       : check uncompressed program memory against its checksums at load time\n");
     fprintf(stderr, "      -h  |  --help         : show this help information\n");
 
     if(error != NULL){
@@ -171,6 +175,17 @@ int main(int argc, char* argv[]){
                     } else {
                         srsvm_debug_mode = true;
                     }
+                } else if(strcmp(argv[i], "-e") == 0 || strcmp(argv[i], "--engine") == 0){
+                    if(i >= argc - 1){
+                        show_usage("engine flag specified with no argument");
+                    } else i++;
+                } else if(strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--memory") == 0){
+                    if(i >= argc - 1){
+                        show_usage("memory flag specified with no argument");
+                    } else i++;
+                } else if(strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--preload") == 0 ||
+                        strcmp(argv[i], "-V") == 0 || strcmp(argv[i], "--verify") == 0){
+                    /* passed through to the runtime */
                 } else if(strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0){
                     show_usage(NULL);
                 } else {
@@ -0,0 +1,14 @@
+LOAD_CONST $SHIFT 0x100000000%u64 ; one zero lane among the divisors must still fault
+math.MUL_U128 $SHIFT $SHIFT $SHIFT
+
+LOAD_CONST $A 0x3f80000040000000%u64
+math.MUL_U128 $A $A $SHIFT
+LOAD_CONST $LO 0x4040000040800000%u64
+math.ADD_U128 $A $A $LO
+LOAD_CONST $B 0x3f8000003f800000%u64
+math.MUL_U128 $B $B $SHIFT
+LOAD_CONST $LO 0x000000003f800000%u64
+math.ADD_U128 $B $B $LO
+math.VEC_DIV_F32 $C $A $B
+
+HALT 0
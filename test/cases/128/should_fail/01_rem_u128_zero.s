@@ -0,0 +1,4 @@
+LOAD_CONST $A 7%u64
+LOAD_CONST $Z 0%u64
+math.REM_U128 $A $A $Z
+HALT 0
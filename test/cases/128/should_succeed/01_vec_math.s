@@ -0,0 +1,274 @@
+LOAD_CONST $SHIFT 0x100000000%u64 ; registers are built from two u64 halves as hi * 2^64 + lo
+math.MUL_U128 $SHIFT $SHIFT $SHIFT
+
+LOAD_CONST $A 0xfe20000049017100%u64
+math.MUL_U128 $A $A $SHIFT
+LOAD_CONST $LO 0x72d9000100301801%u64
+math.ADD_U128 $A $A $LO
+LOAD_CONST $B 0x1ff200b3ae1401%u64
+math.MUL_U128 $B $B $SHIFT
+LOAD_CONST $LO 0x25e5007c5c0001%u64
+math.ADD_U128 $B $B $LO
+LOAD_CONST $E 0xfe3ff200fcaf8501%u64
+math.MUL_U128 $E $E $SHIFT
+LOAD_CONST $LO 0x72fee5017c8c1802%u64
+math.ADD_U128 $E $E $LO
+math.VEC_ADD_U8 $C $A $B
+WORD_EQ $DONE $C $E
+JMP_IF #OK_0 $DONE
+HALT 1
+OK_0: NOP
+
+LOAD_CONST $A 0x165fb7fff0001%u64
+math.MUL_U128 $A $A $SHIFT
+LOAD_CONST $LO 0x7fff80007fff8000%u64
+math.ADD_U128 $A $A $LO
+LOAD_CONST $B 0xc04056807fff0000%u64
+math.MUL_U128 $B $B $SHIFT
+LOAD_CONST $LO 0x80007fff7fff0000%u64
+math.ADD_U128 $B $B $LO
+LOAD_CONST $E 0x3fc10f7b00000001%u64
+math.MUL_U128 $E $E $SHIFT
+LOAD_CONST $LO 0xffff000100008000%u64
+math.ADD_U128 $E $E $LO
+math.VEC_SUB_I16 $C $A $B
+WORD_EQ $DONE $C $E
+JMP_IF #OK_1 $DONE
+HALT 1
+OK_1: NOP
+
+LOAD_CONST $A 0x18000018001cc7f%u64
+math.MUL_U128 $A $A $SHIFT
+LOAD_CONST $LO 0x8000017f010169%u64
+math.ADD_U128 $A $A $LO
+LOAD_CONST $B 0xe8007f80647f0036%u64
+math.MUL_U128 $B $B $SHIFT
+LOAD_CONST $LO 0x7f7f2800ae18cb7f%u64
+math.ADD_U128 $B $B $LO
+LOAD_CONST $E 0xe8000080007f00ca%u64
+math.MUL_U128 $E $E $SHIFT
+LOAD_CONST $LO 0x8000005218cb17%u64
+math.ADD_U128 $E $E $LO
+math.VEC_MUL_I8 $C $A $B
+WORD_EQ $DONE $C $E
+JMP_IF #OK_2 $DONE
+HALT 1
+OK_2: NOP
+
+LOAD_CONST $A 0x1%u64
+math.MUL_U128 $A $A $SHIFT
+LOAD_CONST $LO 0x1a4a45eff%u64
+math.ADD_U128 $A $A $LO
+LOAD_CONST $B 0xffffffff00000001%u64
+math.MUL_U128 $B $B $SHIFT
+LOAD_CONST $LO 0xfaf55496%u64
+math.ADD_U128 $B $B $LO
+LOAD_CONST $E 0x1%u64
+math.MUL_U128 $E $E $SHIFT
+LOAD_CONST $LO 0x5786556a%u64
+math.ADD_U128 $E $E $LO
+math.VEC_MUL_U32 $C $A $B
+WORD_EQ $DONE $C $E
+JMP_IF #OK_3 $DONE
+HALT 1
+OK_3: NOP
+
+LOAD_CONST $A 0xfe016280807f7700%u64
+math.MUL_U128 $A $A $SHIFT
+LOAD_CONST $LO 0x17f01576a802615%u64
+math.ADD_U128 $A $A $LO
+LOAD_CONST $B 0x6100af00007f01%u64
+math.MUL_U128 $B $B $SHIFT
+LOAD_CONST $LO 0x7f007fec01008001%u64
+math.ADD_U128 $B $B $LO
+LOAD_CONST $E 0xfe01008080007700%u64
+math.MUL_U128 $E $E $SHIFT
+LOAD_CONST $LO 0x10001ec01808001%u64
+math.ADD_U128 $E $E $LO
+math.VEC_MIN_I8 $C $A $B
+WORD_EQ $DONE $C $E
+JMP_IF #OK_4 $DONE
+HALT 1
+OK_4: NOP
+
+LOAD_CONST $A 0x10000fd3d0001%u64
+math.MUL_U128 $A $A $SHIFT
+LOAD_CONST $LO 0xffff000000000000%u64
+math.ADD_U128 $A $A $LO
+LOAD_CONST $B 0xffffffff42290000%u64
+math.MUL_U128 $B $B $SHIFT
+LOAD_CONST $LO 0x0%u64
+math.ADD_U128 $B $B $LO
+LOAD_CONST $E 0xfffffffffd3d0001%u64
+math.MUL_U128 $E $E $SHIFT
+LOAD_CONST $LO 0xffff000000000000%u64
+math.ADD_U128 $E $E $LO
+math.VEC_MAX_U16 $C $A $B
+WORD_EQ $DONE $C $E
+JMP_IF #OK_5 $DONE
+HALT 1
+OK_5: NOP
+
+LOAD_CONST $A 0x8000000080000000%u64
+math.MUL_U128 $A $A $SHIFT
+LOAD_CONST $LO 0x80000000426e7a42%u64
+math.ADD_U128 $A $A $LO
+LOAD_CONST $B 0x7fffffff00000001%u64
+math.MUL_U128 $B $B $SHIFT
+LOAD_CONST $LO 0x7fffffff266d58b5%u64
+math.ADD_U128 $B $B $LO
+LOAD_CONST $E 0x8000000080000000%u64
+math.MUL_U128 $E $E $SHIFT
+LOAD_CONST $LO 0x80000000266d58b5%u64
+math.ADD_U128 $E $E $LO
+math.VEC_MIN_I32 $C $A $B
+WORD_EQ $DONE $C $E
+JMP_IF #OK_6 $DONE
+HALT 1
+OK_6: NOP
+
+LOAD_CONST $A 0x8001007f01000080%u64
+math.MUL_U128 $A $A $SHIFT
+LOAD_CONST $LO 0x807f8043ab7fa4%u64
+math.ADD_U128 $A $A $LO
+LOAD_CONST $B 0xf67f00af01019901%u64
+math.MUL_U128 $B $B $SHIFT
+LOAD_CONST $LO 0x7f805b960000f71b%u64
+math.ADD_U128 $B $B $LO
+LOAD_CONST $E 0x8001007f01000080%u64
+math.MUL_U128 $E $E $SHIFT
+LOAD_CONST $LO 0x807f8043557f5c%u64
+math.ADD_U128 $E $E $LO
+math.VEC_ABS_I8 $C $A
+WORD_EQ $DONE $C $E
+JMP_IF #OK_7 $DONE
+HALT 1
+OK_7: NOP
+
+LOAD_CONST $A 0xb2f4000180000000%u64
+math.MUL_U128 $A $A $SHIFT
+LOAD_CONST $LO 0xe586131b75400001%u64
+math.ADD_U128 $A $A $LO
+LOAD_CONST $B 0x800000016afe0000%u64
+math.MUL_U128 $B $B $SHIFT
+LOAD_CONST $LO 0x80006ec400010000%u64
+math.ADD_U128 $B $B $LO
+LOAD_CONST $E 0x4d0c000180000000%u64
+math.MUL_U128 $E $E $SHIFT
+LOAD_CONST $LO 0x1a7a131b75400001%u64
+math.ADD_U128 $E $E $LO
+math.VEC_ABS_I16 $C $A
+WORD_EQ $DONE $C $E
+JMP_IF #OK_8 $DONE
+HALT 1
+OK_8: NOP
+
+LOAD_CONST $A 0x1%u64
+math.MUL_U128 $A $A $SHIFT
+LOAD_CONST $LO 0x0%u64
+math.ADD_U128 $A $A $LO
+LOAD_CONST $B 0x0%u64
+math.MUL_U128 $B $B $SHIFT
+LOAD_CONST $LO 0x73308ce500eb4e11%u64
+math.ADD_U128 $B $B $LO
+LOAD_CONST $E 0x1%u64
+math.MUL_U128 $E $E $SHIFT
+LOAD_CONST $LO 0x73308ce500eb4e11%u64
+math.ADD_U128 $E $E $LO
+math.VEC_ADD_I64 $C $A $B
+WORD_EQ $DONE $C $E
+JMP_IF #OK_9 $DONE
+HALT 1
+OK_9: NOP
+
+LOAD_CONST $A 0x41200000c0100000%u64
+math.MUL_U128 $A $A $SHIFT
+LOAD_CONST $LO 0x4120000040800000%u64
+math.ADD_U128 $A $A $LO
+LOAD_CONST $B 0x4080000041200000%u64
+math.MUL_U128 $B $B $SHIFT
+LOAD_CONST $LO 0x412000003fc00000%u64
+math.ADD_U128 $B $B $LO
+LOAD_CONST $E 0x4160000040f80000%u64
+math.MUL_U128 $E $E $SHIFT
+LOAD_CONST $LO 0x41a0000040b00000%u64
+math.ADD_U128 $E $E $LO
+math.VEC_ADD_F32 $C $A $B
+WORD_EQ $DONE $C $E
+JMP_IF #OK_10 $DONE
+HALT 1
+OK_10: NOP
+
+LOAD_CONST $A 0x3fe0000000000000%u64
+math.MUL_U128 $A $A $SHIFT
+LOAD_CONST $LO 0xc002000000000000%u64
+math.ADD_U128 $A $A $LO
+LOAD_CONST $B 0xc01f000000000000%u64
+math.MUL_U128 $B $B $SHIFT
+LOAD_CONST $LO 0x3ff8000000000000%u64
+math.ADD_U128 $B $B $LO
+LOAD_CONST $E 0xbfb0842108421084%u64
+math.MUL_U128 $E $E $SHIFT
+LOAD_CONST $LO 0xbff8000000000000%u64
+math.ADD_U128 $E $E $LO
+math.VEC_DIV_F64 $C $A $B
+WORD_EQ $DONE $C $E
+JMP_IF #OK_11 $DONE
+HALT 1
+OK_11: NOP
+
+LOAD_CONST $A 0x4024000000000000%u64
+math.MUL_U128 $A $A $SHIFT
+LOAD_CONST $LO 0xc01f000000000000%u64
+math.ADD_U128 $A $A $LO
+LOAD_CONST $B 0x4010000000000000%u64
+math.MUL_U128 $B $B $SHIFT
+LOAD_CONST $LO 0xc002000000000000%u64
+math.ADD_U128 $B $B $LO
+LOAD_CONST $E 0x4024000000000000%u64
+math.MUL_U128 $E $E $SHIFT
+LOAD_CONST $LO 0xc002000000000000%u64
+math.ADD_U128 $E $E $LO
+math.VEC_MAX_F64 $C $A $B
+WORD_EQ $DONE $C $E
+JMP_IF #OK_12 $DONE
+HALT 1
+OK_12: NOP
+
+LOAD_CONST $A 0x4014400000000000%u64
+math.MUL_U128 $A $A $SHIFT
+LOAD_CONST $LO 0x4030000000000000%u64
+math.ADD_U128 $A $A $LO
+LOAD_CONST $B 0x4010000000000000%u64
+math.MUL_U128 $B $B $SHIFT
+LOAD_CONST $LO 0x4024000000000000%u64
+math.ADD_U128 $B $B $LO
+LOAD_CONST $E 0x4002000000000000%u64
+math.MUL_U128 $E $E $SHIFT
+LOAD_CONST $LO 0x4010000000000000%u64
+math.ADD_U128 $E $E $LO
+math.VEC_SQRT_F64 $C $A
+WORD_EQ $DONE $C $E
+JMP_IF #OK_13 $DONE
+HALT 1
+OK_13: NOP
+
+LOAD_CONST $A 0x3f80000040400000%u64 ; inexact under a reciprocal estimate in every lane
+math.MUL_U128 $A $A $SHIFT
+LOAD_CONST $LO 0x400000003f800000%u64
+math.ADD_U128 $A $A $LO
+LOAD_CONST $B 0x4120000040400000%u64
+math.MUL_U128 $B $B $SHIFT
+LOAD_CONST $LO 0x40e0000040400000%u64
+math.ADD_U128 $B $B $LO
+LOAD_CONST $E 0x3dcccccd3f800000%u64
+math.MUL_U128 $E $E $SHIFT
+LOAD_CONST $LO 0x3e9249253eaaaaab%u64
+math.ADD_U128 $E $E $LO
+math.VEC_DIV_F32 $C $A $B
+WORD_EQ $DONE $C $E
+JMP_IF #OK_14 $DONE
+HALT 1
+OK_14: NOP
+
+HALT 0
@@ -0,0 +1,4 @@
+LOAD_CONST $A 7%u16
+LOAD_CONST $Z 0%u16
+math.REM_U16 $A $A $Z
+HALT 0
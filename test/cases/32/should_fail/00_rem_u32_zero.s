@@ -0,0 +1,4 @@
+LOAD_CONST $A 7%u32
+LOAD_CONST $Z 0%u32
+math.REM_U32 $A $A $Z
+HALT 0
@@ -0,0 +1,2 @@
+RET
+HALT 0
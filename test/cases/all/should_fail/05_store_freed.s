@@ -0,0 +1,5 @@
+ALLOC $A 16
+FREE $A
+LOAD_CONST $V 1
+STORE $A $V 0
+HALT
@@ -0,0 +1,4 @@
+ALLOC $A 16
+FREE $A
+FREE $A
+HALT
@@ -0,0 +1,4 @@
+REGION_CREATE $R 64
+REGION_DESTROY $R
+REGION_ALLOC $A $R 16
+HALT
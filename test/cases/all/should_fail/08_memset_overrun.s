@@ -0,0 +1,3 @@
+ALLOC $A 16
+MEMSET $A 0 4096
+HALT
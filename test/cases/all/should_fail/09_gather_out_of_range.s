@@ -0,0 +1,6 @@
+ALLOC $OFF 16
+ALLOC $REC 16
+LOAD_CONST $O 15              ; the word at this offset runs past the end of the record
+STORE $OFF $O 0
+GATHER $REC $OFF 0 $X
+HALT
@@ -0,0 +1,17 @@
+LOAD_CONST $A 1%u8
+math.ADD_U8 $A $A $A
+
+LOAD_CONST $PASSES 0
+
+AGAIN: math.ADD_U8 $A $A $A
+INCR $PASSES
+WORD_EQ $DONE $PASSES 2
+JMP_IF #UNLOAD $DONE
+WORD_EQ $DONE $PASSES 3
+JMP_IF #RAN $DONE
+JMP #AGAIN
+
+UNLOAD: MOD_UNLOAD "math"
+JMP #AGAIN
+
+RAN: HALT 0
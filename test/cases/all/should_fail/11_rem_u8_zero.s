@@ -0,0 +1,4 @@
+LOAD_CONST $A 7%u8
+LOAD_CONST $Z 0%u8
+math.REM_U8 $A $A $Z
+HALT 0
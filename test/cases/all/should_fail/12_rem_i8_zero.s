@@ -0,0 +1,4 @@
+LOAD_CONST $A 7%i8
+LOAD_CONST $Z 0%i8
+math.REM_I8 $A $A $Z
+HALT 0
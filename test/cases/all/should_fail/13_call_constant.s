@@ -0,0 +1,3 @@
+CALL "PASS"                   ; a string constant is not a call target
+HALT 0
+PASS: HALT 0
@@ -0,0 +1,19 @@
+LOAD_CONST $X 1
+LOAD_CONST $$SHARED 1
+
+THREAD_START $T #THREAD_TARGET
+THREAD_JOIN $T
+
+WORD_EQ $OK $X 1             ; the thread's $X is its own
+JMP_IF #CHECK_SHARED $OK
+HALT 1
+
+CHECK_SHARED: WORD_EQ $OK $$SHARED 2             ; $$SHARED is visible to every thread
+JMP_IF #PASS $OK
+HALT 1
+
+PASS: HALT 0
+
+THREAD_TARGET: LOAD_CONST $X 2
+LOAD_CONST $$SHARED 2
+HALT
@@ -0,0 +1,36 @@
+LOAD_CONST $A 1
+LOAD_CONST $S "saved"
+
+CALL #SUB
+WORD_EQ $OK $A 1             ; SUB restores $A before returning
+JMP_IF #CHECK_DEPTH $OK
+HALT 1
+
+CHECK_DEPTH: LOAD_CONST $N 0
+CALL #COUNT
+WORD_EQ $OK $N 5             ; five nested calls and returns
+JMP_IF #CHECK_SPILLS $OK
+HALT 1
+
+CHECK_SPILLS: CALL #SUB
+WORD_EQ $OK $A 1             ; spills discarded by RET do not disturb later ones
+JMP_IF #PASS $OK
+HALT 1
+
+PASS: PUTS $S
+HALT 0
+
+SUB: PUSH $A
+PUSH $S
+LOAD_CONST $A 2
+LOAD_CONST $S "clobbered"
+POP
+POP
+RET
+
+COUNT: PUSH $S                ; left on the frame for RET to discard
+INCR $N
+WORD_EQ $DONE $N 5
+JMP_IF #COUNT_END $DONE
+CALL #COUNT
+COUNT_END: RET
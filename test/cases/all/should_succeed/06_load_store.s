@@ -0,0 +1,23 @@
+ERR_FAULT_ENABLE $A
+ERR_FAULT_ENABLE $B
+ALLOC $A 16
+ALLOC $B 16
+LOAD_CONST $V 1234
+STORE $A $V 0
+LOAD_CONST $V 4321
+STORE $B $V 0
+LOAD $X $A 0
+WORD_EQ $OK $X 1234
+JMP_IF #FREE_A $OK
+HALT 1
+FREE_A: FREE $A
+ALLOC $A 16
+LOAD_CONST $V 99
+STORE $A $V 0
+LOAD $X $B 0
+WORD_EQ $OK $X 4321
+JMP_IF #END $OK
+HALT 2
+END: FREE $A
+FREE $B
+HALT
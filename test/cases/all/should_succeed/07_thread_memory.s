@@ -0,0 +1,36 @@
+LOAD_CONST $$FAILED 0
+
+THREAD_START $T1 #WORKER
+THREAD_START $T2 #WORKER
+THREAD_START $T3 #WORKER
+
+THREAD_JOIN $T1
+THREAD_JOIN $T2
+THREAD_JOIN $T3
+
+WORD_EQ $OK $$FAILED 0      ; set by any worker that read back the wrong value
+JMP_IF #PASS $OK
+HALT 1
+
+PASS: HALT 0
+
+WORKER: LOAD_CONST $I 0
+ALLOC $KEEP 16              ; stays live while other threads allocate and free around it
+LOOP: ALLOC $BUF 16
+STORE $BUF $I 0
+STORE $KEEP $I 0
+LOAD $X $BUF 0
+FREE $BUF
+WORD_EQ $OK $X $I
+JMP_IF #CHECK_KEEP $OK
+LOAD_CONST $$FAILED 1
+CHECK_KEEP: LOAD $X $KEEP 0
+WORD_EQ $OK $X $I
+JMP_IF #NEXT $OK
+LOAD_CONST $$FAILED 1
+NEXT: INCR $I
+WORD_EQ $DONE $I 2000
+JMP_IF #END $DONE
+JMP #LOOP
+END: FREE $KEEP
+HALT
@@ -0,0 +1,29 @@
+LOAD_CONST $I 0
+
+LOOP: ALLOC $SMALL 24           ; carved out of a slab
+ALLOC $LARGE 4096               ; too big for any size class, gets its own segment
+ALLOC $OTHER 24
+STORE $SMALL $I 0
+STORE $LARGE $I 0
+STORE $OTHER $LARGE 0
+LOAD $X $SMALL 0
+WORD_EQ $OK $X $I
+JMP_IF #CHECK_LARGE $OK
+HALT 1
+CHECK_LARGE: LOAD $X $LARGE 0
+WORD_EQ $OK $X $I
+JMP_IF #CHECK_OTHER $OK
+HALT 2
+CHECK_OTHER: LOAD $X $OTHER 0
+WORD_EQ $OK $X $LARGE
+JMP_IF #NEXT $OK
+HALT 3
+NEXT: FREE $SMALL
+FREE $LARGE
+FREE $OTHER
+INCR $I
+WORD_EQ $DONE $I 100
+JMP_IF #END $DONE
+JMP #LOOP
+
+END: HALT
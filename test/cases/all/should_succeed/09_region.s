@@ -0,0 +1,29 @@
+ERR_FAULT_ENABLE $A
+REGION_CREATE $R 256
+LOAD_CONST $I 0
+
+LOOP: REGION_ALLOC $A $R 32
+REGION_ALLOC $B $R 32
+STORE $A $I 0
+STORE $B $A 0
+LOAD $X $A 0
+WORD_EQ $OK $X $I
+JMP_IF #CHECK_B $OK
+HALT 1
+CHECK_B: LOAD $X $B 0
+WORD_EQ $OK $X $A
+JMP_IF #NEXT $OK
+HALT 2
+NEXT: REGION_RESET $R         ; releases both allocations at once
+INCR $I
+WORD_EQ $DONE $I 100
+JMP_IF #FULL $DONE
+JMP #LOOP
+
+FULL: REGION_ALLOC $A $R 256
+REGION_ALLOC $B $R 16         ; the region is exhausted, so this sets the error bit
+JMP_ERR #DESTROY $B
+HALT 3
+
+DESTROY: REGION_DESTROY $R
+HALT
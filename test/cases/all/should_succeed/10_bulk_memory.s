@@ -0,0 +1,38 @@
+ALLOC $A 64
+ALLOC $B 64
+MEMSET $A 1 64
+MEMSET $A 2 16
+MEMCHR $P $A 1 64             ; first 1 is 16 bytes in
+JMP_ERR #FAIL $P
+MEMCPY $P $A 32               ; overlapping copy, as memmove
+MEMCHR $X $P 1 16             ; bytes 16..32 are now 2
+JMP_ERR #COPIED $X
+HALT 1
+
+COPIED: MEMCPY $B $A 64
+MEMCMP $R $A $B 64
+WORD_EQ $OK $R 0
+JMP_IF #ORDER $OK
+HALT 2
+
+ORDER: MEMSET $B 0 1
+MEMCMP $R $A $B 64
+WORD_EQ $OK $R 1
+JMP_IF #ADJACENT $OK
+HALT 3
+
+ADJACENT: ALLOC $C 16         ; consecutive blocks of a fresh slab
+ALLOC $D 16
+MEMSET $C 5 32                ; one range across both allocations
+MEMCHR $E $D 5 16
+WORD_EQ $OK $E $D
+JMP_IF #END $OK
+HALT 4
+
+FAIL: HALT 5
+
+END: FREE $A
+FREE $B
+FREE $C
+FREE $D
+HALT
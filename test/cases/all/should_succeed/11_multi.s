@@ -0,0 +1,41 @@
+ALLOC $REC 64
+ALLOC $OFF 64
+LOAD_CONST $A 11
+LOAD_CONST $B 22
+LOAD_CONST $C 33
+STORE_MULTI $REC 0 $A $B $C   ; three consecutive words
+LOAD_MULTI $REC 0 $X $Y $Z
+WORD_EQ $OK $X 11
+JMP_IF #Y $OK
+HALT 1
+Y: WORD_EQ $OK $Y 22
+JMP_IF #Z $OK
+HALT 2
+Z: WORD_EQ $OK $Z 33
+JMP_IF #BYTES $OK
+HALT 3
+
+BYTES: STORE_MULTI $REC 5 $A $B $C   ; type 5 is U8
+LOAD_CONST $O 2
+LOAD_CONST $P 0
+STORE_MULTI $OFF 0 $O $P      ; byte offsets of the fields to gather
+GATHER $REC $OFF 5 $X $Y
+WORD_EQ $OK $X 33
+JMP_IF #GATHERED $OK
+HALT 4
+GATHERED: WORD_EQ $OK $Y 11
+JMP_IF #SCATTER $OK
+HALT 5
+
+SCATTER: SCATTER $REC $OFF 5 $Y $X   ; swaps the first and last byte
+LOAD_MULTI $REC 5 $X $Y $Z
+WORD_EQ $OK $X 33
+JMP_IF #SCATTERED $OK
+HALT 6
+SCATTERED: WORD_EQ $OK $Z 11
+JMP_IF #END $OK
+HALT 7
+
+END: FREE $REC
+FREE $OFF
+HALT
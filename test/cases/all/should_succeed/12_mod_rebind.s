@@ -0,0 +1,23 @@
+LOAD_CONST $A 1%u8
+math.ADD_U8 $A $A $A
+
+LOAD_CONST $PASSES 0
+
+AGAIN: math.ADD_U8 $A $A $A
+INCR $PASSES
+WORD_EQ $DONE $PASSES 2
+JMP_IF #RELOAD $DONE
+WORD_EQ $DONE $PASSES 3
+JMP_IF #CHECK $DONE
+JMP #AGAIN
+
+RELOAD: MOD_UNLOAD "math"
+MOD_LOAD $MOD_ID "math"
+JMP #AGAIN
+
+CHECK: LOAD_CONST $B 16%u8
+WORD_EQ $DONE $A $B
+JMP_IF #PASS $DONE
+
+FAIL: HALT 1
+PASS: HALT 0
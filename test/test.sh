@@ -10,6 +10,40 @@ if [ -z ${WORD_SIZE+x} ]; then
 	exit 1
 fi
 
+MEMORY=${MEMORY:-segmented}
+INSTALL=${INSTALL:-install}
+
+# FORMAT=run assembles and runs each case in one process; v1, v2 and
+# v2-uncompressed write a program file with srsvm_as and load that instead.
+FORMAT=${FORMAT:-run}
+CODEC=${CODEC:-zlib}
+PRELOAD=${PRELOAD:-}
+
+case "$FORMAT" in
+	run) AS_FLAGS=() ;;
+	v1) AS_FLAGS=(-F 1) ;;
+	v2) AS_FLAGS=(-F 2 -C "$CODEC") ;;
+	v2-uncompressed) AS_FLAGS=(-F 2 -U) ;;
+	*)
+		echo "Error: unknown FORMAT '$FORMAT'"
+		exit 1
+		;;
+esac
+
+RUN_FLAGS=(-m "$MEMORY")
+
+if [ -n "$PRELOAD" ]; then
+	RUN_FLAGS+=(-p)
+fi
+
+PROGRAM=$(mktemp)
+
+# keep the module path cache away from the user's own
+export XDG_CACHE_HOME
+XDG_CACHE_HOME=$(mktemp -d)
+
+trap 'rm -rf "$PROGRAM" "$PROGRAM".good "$PROGRAM".bad "$XDG_CACHE_HOME"' EXIT
+
 NUM_PASS=0
 NUM_FAIL=0
 
@@ -54,15 +88,37 @@ test_fail(){
 	((NUM_FAIL=NUM_FAIL+1))
 }
 
+assemble(){
+	"$INSTALL"/bin/srsvm_as -ws "$WORD_SIZE" "${AS_FLAGS[@]}" -o "$2" "$1"
+}
+
+run_program(){
+	local program="$1"
+	shift
+
+	"$INSTALL"/libexec/srsvm/srsvm_"$WORD_SIZE" "${RUN_FLAGS[@]}" "$program" -- "$@"
+}
+
+run_case(){
+	local filename="$1"
+	local args="$2"
+
+	if [ "$FORMAT" = run ]; then
+		"$INSTALL"/bin/srsvm_run -ws "$WORD_SIZE" "${RUN_FLAGS[@]}" "$filename" -- $args
+	else
+		assemble "$filename" "$PROGRAM" && run_program "$PROGRAM" $args
+	fi
+}
+
 should_fail(){
 	local filename="$1"
 	local args="$2"
 
     if ! [ -z ${TEST_DEBUG+x} ]; then
-        echo "install/bin/srsvm_run -ws "$WORD_SIZE" "$filename" -- $args >/dev/null 2>&1"
+        echo "FORMAT=$FORMAT CODEC=$CODEC: $filename -- $args"
     fi
 
-	if install/bin/srsvm_run -ws "$WORD_SIZE" "$filename" -- $args >/dev/null 2>&1; then
+	if run_case "$filename" "$args" >/dev/null 2>&1; then
 		test_fail "$filename"
 	else
 		test_pass "$filename"
@@ -74,20 +130,133 @@ should_succeed(){
 	local args="$2"
     
     if ! [ -z ${TEST_DEBUG+x} ]; then
-        echo "install/bin/srsvm_run -ws "$WORD_SIZE" "$filename" -- $args >/dev/null 2>&1"
+        echo "FORMAT=$FORMAT CODEC=$CODEC: $filename -- $args"
     fi
 
-	if install/bin/srsvm_run -ws "$WORD_SIZE" "$filename" -- $args >/dev/null 2>&1; then
+	if run_case "$filename" "$args" >/dev/null 2>&1; then
 		test_pass "$filename"
 	else
 		test_fail "$filename"
 	fi
 }
 
+program_should_fail(){
+	local description="$1"
+	local program="$2"
+
+	if run_program "$program" >/dev/null 2>&1; then
+		test_fail "$description"
+	else
+		test_pass "$description"
+	fi
+}
+
+read_uint(){
+	od -An -t u"$3" -j "$2" -N "$3" "$1" | tr -d ' '
+}
+
+write_uint(){
+	local file="$1"
+	local offset="$2"
+	local size="$3"
+	local value="$4"
+
+	for ((i = 0; i < size; i++)); do
+		printf "\\$(printf '%03o' $(( (value >> (8 * i)) & 0xFF )))"
+	done | dd of="$file" bs=1 seek="$offset" conv=notrunc status=none
+}
+
+header_offset(){
+	if [ "$(head -c 2 "$1")" = '#!' ]; then
+		head -n 1 "$1" | wc -c
+	else
+		echo 0
+	fi
+}
+
+# flips the last payload byte of every section of the given type
+corrupt_sections(){
+	local good="$1"
+	local bad="$2"
+	local type="$3"
+
+	local header table num_sections
+	header=$(header_offset "$good")
+	num_sections=$(read_uint "$good" $((header + 6)) 2)
+	table=$(read_uint "$good" $((header + 8)) 8)
+
+	cp "$good" "$bad"
+
+	for ((section = 0; section < num_sections; section++)); do
+		local entry=$((table + section * 52))
+
+		if [ "$(read_uint "$good" "$entry" 2)" = "$type" ]; then
+			local last=$(( $(read_uint "$good" $((entry + 8)) 8) + $(read_uint "$good" $((entry + 16)) 8) - 1 ))
+
+			write_uint "$bad" "$last" 1 $(( $(read_uint "$good" "$last" 1) ^ 0xFF ))
+		fi
+	done
+}
+
+# Damaged program files have to be turned away at load time.
+corrupt_program_cases(){
+	local good="$PROGRAM.good"
+	local bad="$PROGRAM.bad"
+
+	assemble cases/all/should_succeed/02_const.s "$good" >/dev/null 2>&1
+
+	local size
+	size=$(stat -c %s "$good")
+
+	head -c $((size / 2)) "$good" > "$bad"
+	program_should_fail "truncated program file" "$bad"
+
+	if [ "$FORMAT" = v1 ]; then
+		return
+	fi
+
+	corrupt_sections "$good" "$bad" 4
+	program_should_fail "program file with a bad section checksum" "$bad"
+
+	# literal memory is checked when it is first inflated, or at load with -V
+	# when it is used in place
+	corrupt_sections "$good" "$bad" 3
+
+	if [ "$FORMAT" = v2-uncompressed ]; then
+		local RUN_FLAGS=("${RUN_FLAGS[@]}" -V)
+	fi
+
+	program_should_fail "literal memory with a bad checksum" "$bad"
+
+	if [ "$FORMAT" = v2-uncompressed ]; then
+		local header table num_sections
+		header=$(header_offset "$good")
+		num_sections=$(read_uint "$good" $((header + 6)) 2)
+		table=$(read_uint "$good" $((header + 8)) 8)
+
+		cp "$good" "$bad"
+
+		for ((section = 0; section < num_sections; section++)); do
+			local entry=$((table + section * 52))
+
+			if [ "$(read_uint "$good" "$entry" 2)" = 3 ]; then
+				write_uint "$bad" $((entry + 24)) 8 $(( $(read_uint "$good" $((entry + 16)) 8) + 4096 ))
+			fi
+		done
+
+		program_should_fail "literal memory section larger than its payload" "$bad"
+	fi
+}
+
 show_summary(){
 	echo "Tests complete: $NUM_PASS tests passed, $NUM_FAIL tests failed"
 }
 
+if [ "$FORMAT" != run ] && ! assemble cases/all/should_succeed/00_halt_0.s "$PROGRAM" >/dev/null 2>&1; then
+	write_warning "cannot write FORMAT=$FORMAT CODEC=$CODEC programs here, skipping"
+	exit 0
+fi
+
 for dir in all "$WORD_SIZE"; do
 	for input_file in cases/$dir/should_fail/*.s; do
 		should_fail "$input_file" ""
@@ -98,8 +267,13 @@ for dir in all "$WORD_SIZE"; do
 	done
 done
 
-should_succeed cases/args/should_succeed/00_no_args.s ""
-should_succeed cases/args/should_succeed/01_one_arg.s "a"
-should_succeed cases/args/should_succeed/02_two_args.s "a b"
+# srsvm passes the program name as the first argument; srsvm_run does not
+if [ "$FORMAT" = run ]; then
+	should_succeed cases/args/should_succeed/00_no_args.s ""
+	should_succeed cases/args/should_succeed/01_one_arg.s "a"
+	should_succeed cases/args/should_succeed/02_two_args.s "a b"
+else
+	corrupt_program_cases
+fi
 
 show_summary